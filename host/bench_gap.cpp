@@ -0,0 +1,157 @@
+/*
+ * Audio engine: Gap between a sound and the appended one
+ *
+ * Runs the audio engine as a coroutine (HOST_TASKS_COOP) and plays
+ * an MP3 with a second one appended, from a main loop that calls
+ * audio_loop() every "period" ms. The gap is the silence (zero
+ * samples and underruns) in the I2S output from the first to the
+ * last sample of the two, plus queued output that was dropped in
+ * between, less the same for each sound played alone. Silences
+ * shorter than 1ms are part of the sounds and don't count, nor do
+ * the first 20ms of output, which jitter from run to run.
+ *
+ * "gapless": The engine queues the appended file with the MP3
+ * generator, which carries on into it (AE_QUEUE).
+ * "restart": The first sound is a listed effect being captured
+ * for the PCM cache, which the engine won't queue behind. As it
+ * was for all sounds before, the control side starts the next one
+ * once the first has ended, so the gap depends on how soon the
+ * main loop gets to it. The output stops when the first sound
+ * ends and drops what the DMA buffers (46ms) still hold.
+ */
+
+#include <Arduino.h>
+#include <vector>
+#include "driver/i2s.h"
+
+#include "remote_global.h"
+#include "remote_audio.h"
+#include "remote_settings.h"
+#include "mp3gen.h"
+
+#define NFR     20
+
+static double firstUs, lastUs, silence, cut0, cut;
+static long frames, played;         // Frames up to the last sample
+
+static void onOutput(const int16_t *lr, size_t n, double startUs)
+{
+    double perFrame = 1e6 / hostI2S.rate;
+
+    for(size_t i = 0; i < n; i++) {
+        if(firstUs >= 0) frames++;
+        if(!lr[2*i] && !lr[2*i+1]) continue;
+        played = frames + 1;
+        double t = startUs + i * perFrame;
+        if(firstUs < 0) firstUs = t;
+        else if(t - firstUs > 20000 && fabs(t - lastUs) >= 1000) silence += t - lastUs;
+        lastUs = t + perFrame;
+        cut = hostI2S.cutUs - cut0;
+    }
+}
+
+static void writeMp3(const char *dir, const char *fn, unsigned long long seed)
+{
+    std::vector<unsigned char> s(NFR * MP3GEN_FRAME + 8);
+    char path[256], tag[128] = "TAG";
+
+    mp3gen_rs = 88172645463325252ULL * seed;
+    snprintf(path, sizeof(path), "%s%s", dir, fn);
+    FILE *f = fopen(path, "wb");
+    fwrite(s.data(), 1, mp3gen_random(s.data(), NFR, 1, 130), f);
+    // ID3v1 tag, as most files have; libmad needs something after
+    // the last frame to decode it
+    fwrite(tag, 1, sizeof(tag), f);
+    fclose(f);
+}
+
+// Silence in us while playing fn, followed by b.mp3 if "append"
+static double play(const char *fn, bool append, int period)
+{
+    firstUs = -1;
+    silence = cut = 0;
+    frames = played = 0;
+    cut0 = hostI2S.cutUs;
+
+    play_file(fn, PA_ALLOWSD);
+    if(append) append_file("/b.mp3", PA_ALLOWSD);
+    do {
+        audio_loop();
+        delay(period);
+    } while(append_pending() || !checkAudioReallyDone());
+
+    return silence + cut;
+}
+
+// *lost: Frames of the two missing from the output
+static double gap(const char *fn, int period, long *lost)
+{
+    double both = play(fn, true, period), g;
+    long n = played;
+
+    g = both - play(fn, false, period);
+    *lost = played;
+    g -= play("/b.mp3", false, period);
+    *lost += played - n;
+
+    return g;
+}
+
+int main()
+{
+    static const int periods[] = { 1, 10, 30, 70 };
+    char dir[] = "/tmp/bench_gap.XXXXXX";
+    char buf[128], fn[16];
+    int fail = 0;
+
+    if(!mkdtemp(dir)) {
+        perror("mkdtemp");
+        return 1;
+    }
+    // Key sounds hold the same data as a.mp3; each is captured
+    // (not played from the cache) once
+    writeMp3(dir, "/a.mp3", 1);
+    writeMp3(dir, "/b.mp3", 2);
+    for(int i = 0; i < 4; i++) {
+        snprintf(fn, sizeof(fn), "/key%d.mp3", i);
+        writeMp3(dir, fn, 1);
+    }
+
+    hostTasks = HOST_TASKS_COOP;
+    hostSDRoot = dir;
+    hostI2SOut = onOutput;
+
+    settings_setup();
+    audio_setup();
+
+    // The very first sound starts late
+    play("/b.mp3", false, 1);
+
+    for(int i = 0; i < 4; i++) {
+        int p = periods[i];
+        double g[2];
+        long lost[2];
+
+        snprintf(fn, sizeof(fn), "/key%d.mp3", i);
+        g[0] = gap("/a.mp3", p, &lost[0]);
+        g[1] = gap(fn, p, &lost[1]);
+        printf("main loop every %3dms: gapless %5.1fms, %+ld frames missing; restart %5.1fms\n",
+                p, g[0] / 1000, lost[0], g[1] / 1000);
+
+        // Start of a sound jitters by up to 500 frames; a frame has 1152
+        if(g[0] >= 1000 || labs(lost[0]) > 576) fail = 1;
+        if(p >= 70 && g[1] < g[0] + 10000) fail = 1;
+    }
+    audio_gapStats(buf, sizeof(buf));
+    printf("%s", buf);
+    audio_bufStats(buf, sizeof(buf));
+    printf("%s", buf);
+
+    for(const char *f : { "/a.mp3", "/b.mp3", "/key0.mp3", "/key1.mp3", "/key2.mp3", "/key3.mp3" }) {
+        snprintf(buf, sizeof(buf), "%s%s", dir, f);
+        remove(buf);
+    }
+    rmdir(dir);
+
+    return fail;
+}
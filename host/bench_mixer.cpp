@@ -0,0 +1,101 @@
+/*
+ * AudioOutputMixer: CPU cost of the resampler per output frame
+ *
+ * Feeds 20s of a stereo tone at each input rate through one input
+ * of the mixer into a sink that discards it. 44.1k is the bypass;
+ * 22.05k-32k go through the 8-tap filter; 48k through the 32-tap
+ * one (AUDIO_MIXER_DTAPS), and for comparison through the 8-tap
+ * one it replaced.
+ */
+
+#include <Arduino.h>
+#include <chrono>
+#include <vector>
+
+#include "src/ESP8266Audio/AudioOutputMixer.h"
+
+#define SECS    20
+
+class Null : public AudioOutput {
+    public:
+        bool begin() override { return true; }
+        bool SetRate(int) override { return true; }
+        bool SetBitsPerSample(int) override { return true; }
+        bool SetChannels(int) override { return true; }
+        bool SetGain(float, int = 0) override { return true; }
+        size_t ConsumeSample(int16_t, int16_t) override { return 1; }
+        size_t ConsumeSamples(const int16_t *s, size_t n) override
+        {
+            sum += s[0] + s[2*n-1];
+            frames += n;
+            return n;
+        }
+        bool stop() override { return true; }
+        uint64_t frames = 0;
+        int64_t sum = 0;
+};
+
+// Access to the voice's filter, to force the short one
+class Mixer : public AudioOutputMixer {
+    public:
+        Mixer(AudioOutput *s) : AudioOutputMixer(1024, s, 44100) {}
+        void shortFilter()
+        {
+            voice[0].tab = coef[0];
+            voice[0].taps = AUDIO_MIXER_TAPS;
+        }
+};
+
+// ns per output frame
+static double run(int rate, bool shortFilter)
+{
+    Null s;
+    Mixer m(&s);
+    AudioOutputMixerStub *in = m.NewInput();
+    std::vector<int16_t> buf(rate * 2);
+
+    for(int i = 0; i < rate; i++) {
+        buf[2*i] = (int16_t)(12000 * sin(2 * M_PI * 997 * i / rate));
+        buf[2*i+1] = (int16_t)(9000 * sin(2 * M_PI * 1511 * i / rate));
+    }
+    in->SetRate(rate);
+    in->SetChannels(2);
+    in->SetBitsPerSample(16);
+    in->SetGain(1.0f);
+    in->begin();
+    if(shortFilter) m.shortFilter();
+
+    auto t0 = std::chrono::steady_clock::now();
+    for(int sec = 0; sec < SECS; sec++) {
+        for(int done = 0; done < rate; m.Pump()) {
+            int n = rate - done < 256 ? rate - done : 256;
+            done += in->ConsumeSamples(buf.data() + 2*done, n);
+        }
+    }
+    double t = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+
+    return t / s.frames;
+}
+
+int main()
+{
+    static const struct { int rate; bool shortFilter; const char *what; } t[] = {
+        { 44100, false, "bypass" },
+        { 22050, false, "8 taps" },
+        { 32000, false, "8 taps" },
+        { 48000, false, "32 taps" },
+        { 48000, true,  "8 taps (before)" },
+    };
+
+    for(auto &c : t) {
+        double best = 1e9;
+        for(int rep = 0; rep < 3; rep++) {
+            double ns = run(c.rate, c.shortFilter);
+            if(ns < best) best = ns;
+        }
+        printf("%5d Hz in, %-16s %6.1f ns per output frame, %5.2f%% of real time\n",
+                c.rate, c.what, best, best * 44100 / 1e7);
+    }
+
+    return 0;
+}
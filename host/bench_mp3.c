@@ -0,0 +1,81 @@
+/*
+ * libmad: Decode time for synthetic Layer III frames
+ *
+ * 128kbps/44.1kHz frames with random side info (big_values, table
+ * selection, region split) and random main data; ~40s of audio.
+ * About 1% of the frames end in Huffman data errors and are not
+ * counted.
+ * This exercises Huffman decoding, requantization and synthesis,
+ * but not real material, so it is likely an underestimate.
+ * "bench_mp3 m" for mono.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "src/ESP8266Audio/libmad/config.h"
+#include "src/ESP8266Audio/libmad/mad.h"
+#include "mp3gen.h"
+
+static long sink;
+
+static enum mad_flow output(void *data, struct mad_header const *header, struct mad_pcm *pcm)
+{
+  for (int i = 0; i < pcm->length; i++)
+    sink += pcm->samples[0][i];
+  return MAD_FLOW_CONTINUE;
+}
+
+static double now(void)
+{
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+int main(int argc, char **argv)
+{
+  int mono = argc > 1 && argv[1][0] == 'm';
+  int nfr = 383 * 4, fs = MP3GEN_FRAME;
+  unsigned char *s = calloc(nfr, fs + 8);
+  struct mad_stream st;
+  struct mad_frame fr;
+  struct mad_synth sy;
+  double best = 1e9;
+  int ok = 0, err = 0;
+
+  mp3gen_random(s, nfr, mono, 130);
+
+  for (int rep = 0; rep < 5; rep++) {
+    mad_stream_init(&st);
+    mad_frame_init(&fr);
+    mad_synth_init(&sy);
+    mad_stream_buffer(&st, s, (unsigned long)nfr * fs + 8);
+    ok = err = 0;
+    double t0 = now();
+    for (;;) {
+      if (mad_frame_decode(&fr, &st)) {
+        if (MAD_RECOVERABLE(st.error)) {
+          err++;
+          continue;
+        }
+        break;
+      }
+      mad_synth_frame(&sy, &fr, output, NULL);
+      ok++;
+    }
+    double t = now() - t0;
+    if (t < best)
+      best = t;
+  }
+
+  printf("%s: %d frames, %d errors; %.2fms per second of audio\n", mono ? "mono" : "stereo",
+         ok, err, best * 1000 / (ok * 1152 / 44100.0));
+
+  free(s);
+
+  return 0;
+}
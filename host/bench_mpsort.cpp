@@ -0,0 +1,121 @@
+/*
+ * Renamer's sort against the insertion sort it replaced
+ */
+
+#include <Arduino.h>
+#include <FS.h>
+#include <string>
+#include <vector>
+
+#include "mpsort.h"
+
+static double now()
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+// Previous sort, for reference
+
+static unsigned char old_toUpper(char a)
+{
+    if(a >= 'a' && a <= 'z')
+        a &= ~0x20;
+
+    return (unsigned char)a;
+}
+
+static bool old_strGT(const char *a, const char *b)
+{
+    int aa = strlen(a);
+    int bb = strlen(b);
+    int cc = aa < bb ? aa : bb;
+
+    for(int i = 0; i < cc; i++) {
+        unsigned char aaa = old_toUpper(*a);
+        unsigned char bbb = old_toUpper(*b);
+        if(aaa < bbb) return false;
+        if(aaa > bbb) return true;
+        a++; b++;
+    }
+
+    return false;
+}
+
+static void old_insertionSort(char **a, int n)
+{
+    for(int i = 1; i < n; i++) {
+        char *k = a[i];
+        int j = i - 1;
+        while(j >= 0 && old_strGT(a[j], k)) {
+            a[j+1] = a[j];
+            j--;
+        }
+        a[j + 1] = k;
+    }
+}
+
+static double runOld(std::vector<std::string> &in)
+{
+    std::vector<char *> a;
+
+    for(auto &s : in) a.push_back(&s[0]);
+    double t0 = now();
+    old_insertionSort(a.data(), a.size());
+    return now() - t0;
+}
+
+static double runNew(std::vector<std::string> &in, fs::FS *fs, int *runs)
+{
+    MpRen_Ctx x;
+    int n = 0;
+
+    double t0 = now();
+    mpren_init(&x, fs, NULL);
+    for(auto &s : in) mpren_add(&x, s.c_str());
+    mpren_sort(&x);
+    while(mpren_next(&x)) n++;
+    *runs = x.runs;
+    mpren_free(&x);
+    return now() - t0;
+}
+
+int main()
+{
+    static const char *words[] = { "Back", "to", "the", "Future", "Time", "Circuits", 
+                                   "Flux", "Doc", "Marty", "Hill", "Valley", "1955" };
+    char root[] = "/tmp/mpsortXXXXXX";
+    
+    if(!mkdtemp(root)) return 1;
+    fs::FS fs(root);
+    srand(1);
+
+    for(int len : { 24, 60, 200 }) {
+        std::vector<std::string> in;
+        double told = 1e9, tnew = 1e9;
+        int runs = 0;
+
+        // 999 names of about len characters, common prefixes
+        for(int i = 0; i < 999; i++) {
+            std::string s = std::string(words[rand() % 4]) + " - ";
+            while((int)s.size() < len - 8) {
+                s += words[rand() % 12];
+                s += ' ';
+            }
+            s += std::to_string(rand() % 100) + ".mp3";
+            in.push_back(s);
+        }
+        for(int k = 0; k < 5; k++) {
+            std::vector<std::string> c = in;
+            told = std::min(told, runOld(c));
+            tnew = std::min(tnew, runNew(in, &fs, &runs));
+        }
+        printf("999 names, %3d chars: insertion sort %7.2fms, new %6.2fms (%d runs), %.0fx\n",
+                len, told * 1000, tnew * 1000, runs, told / tnew);
+    }
+
+    rmdir(root);
+
+    return 0;
+}
@@ -0,0 +1,124 @@
+/*
+ * Audio output: Frames/sec from generator to I2S, block vs
+ * per-sample
+ *
+ * Decodes a synthetic MP3 (mp3gen.h) and a 16-bit stereo WAV
+ * through AudioOutputI2S into the I2S model (stubs/i2s.cpp),
+ * whose output goes to a file. "per-sample" is the old path, one
+ * ConsumeSample() and one i2s_write() per frame; "block" is
+ * ConsumeSamples(). Both must write the same file. The DMA queue
+ * is drained after each loop() of the generator, so output never
+ * waits; the times are CPU only. The host's i2s_write() is much
+ * cheaper than the ESP32's, so the gain there is larger.
+ *
+ *   bench_output [file]
+ */
+
+#include <Arduino.h>
+#include <vector>
+#include <chrono>
+#include "driver/i2s.h"
+
+#include "src/ESP8266Audio/AudioOutputI2S.h"
+#include "src/ESP8266Audio/AudioGeneratorMP3.h"
+#include "src/ESP8266Audio/AudioFileSourcePROGMEM.h"
+#include "AudioGeneratorWAVLoop.h"
+#include "mp3gen.h"
+
+// AudioOutputI2S as it was: the base class' ConsumeSamples()
+// calls ConsumeSample() per frame
+class PerSampleI2S : public AudioOutputI2S {
+    public:
+        PerSampleI2S() : AudioOutputI2S(0, 0, 32, 0) {}
+        size_t ConsumeSamples(const int16_t *s, size_t frames) override
+        {
+            return AudioOutput::ConsumeSamples(s, frames);
+        }
+};
+
+static FILE *sink;
+static uint64_t sum;
+
+static void toFile(const int16_t *lr, size_t frames, double)
+{
+    fwrite(lr, 4, frames, sink);
+    for(size_t i = 0; i < frames * 2; i++) sum = sum * 31 + (uint16_t)lr[i];
+}
+
+static std::vector<uint8_t> makeWav(int secs)
+{
+    std::vector<uint8_t> w(44);
+    uint32_t n = secs * 44100, len = n * 4;
+    uint32_t h[] = { 0x46464952, 36 + len, 0x45564157, 0x20746d66, 16,
+                     0x00020001, 44100, 44100 * 4, 0x00100004, 0x61746164, len };
+
+    memcpy(w.data(), h, 44);
+    for(uint32_t i = 0; i < n; i++) {
+        int16_t s[2] = { (int16_t)(12000 * sin(i * 0.0627)), (int16_t)(9000 * sin(i * 0.0411)) };
+        w.insert(w.end(), (uint8_t *)s, (uint8_t *)s + 4);
+    }
+    return w;
+}
+
+// Frames/sec; sets *chk to the checksum of the output
+static double run(AudioGenerator *g, const std::vector<uint8_t> &data, bool block, uint64_t *chk)
+{
+    AudioFileSourcePROGMEM src(data.data(), data.size());
+    AudioOutputI2S *out = block ? new AudioOutputI2S(0, 0, 32, 0) : new PerSampleI2S();
+    uint64_t w0;
+
+    sum = 0;
+    rewind(sink);
+    w0 = hostI2S.written;
+    auto t0 = std::chrono::steady_clock::now();
+
+    g->begin(&src, out);
+    while(g->isRunning()) {
+        if(!g->loop()) g->stop();
+        hostMicros = (uint64_t)hostI2S.endUs;
+    }
+
+    double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    uint64_t frames = hostI2S.written - w0;
+
+    *chk = sum;
+    delete out;
+    return frames / t;
+}
+
+int main(int argc, char **argv)
+{
+    const char *fn = argc > 1 ? argv[1] : "build/bench_output.raw";
+    const int nfr = 383 * 4;
+    std::vector<uint8_t> mp3(nfr * MP3GEN_FRAME + 8), wav = makeWav(40);
+    int fail = 0;
+
+    if(!(sink = fopen(fn, "w+b"))) {
+        perror(fn);
+        return 1;
+    }
+    hostI2SOut = toFile;
+    mp3.resize(mp3gen_random(mp3.data(), nfr, 0, 130));
+
+    for(int w = 0; w < 2; w++) {
+        double r[2];
+        uint64_t c[2];
+        for(int block = 0; block < 2; block++) {
+            double best = 0;
+            for(int rep = 0; rep < 3; rep++) {
+                AudioGenerator *g = w ? (AudioGenerator *)new AudioGeneratorWAVLoop() : new AudioGeneratorMP3();
+                double f = run(g, w ? wav : mp3, block, &c[block]);
+                if(f > best) best = f;
+                delete g;
+            }
+            r[block] = best;
+        }
+        printf("%s: per-sample %6.2f Mframes/s, block %6.2f Mframes/s, %.2fx%s\n",
+                w ? "WAV" : "MP3", r[0] / 1e6, r[1] / 1e6, r[1] / r[0],
+                c[0] == c[1] ? "" : "; OUTPUT DIFFERS");
+        if(c[0] != c[1]) fail = 1;
+    }
+
+    fclose(sink);
+    return fail;
+}
@@ -0,0 +1,385 @@
+/*
+ * SD card driver (sd_diskio.cpp) on an emulated SPI-mode card
+ *
+ * The card model checks command CRC7 and data CRC16, and has an
+ * access latency before the first block of a read, a gap between
+ * blocks of a multi-block read and a busy time after writes. All
+ * data read back is verified. Times are wire time only; CPU and
+ * HAL overhead per call is not counted.
+ *
+ *   bench_sd [clock Hz]
+ */
+
+#include <Arduino.h>
+#include <SPI.h>
+#include <deque>
+#include <map>
+#include <vector>
+
+#include "src/SD/sd_diskio.h"
+extern "C" {
+    #include <ff.h>
+    #include <diskio.h>
+    #include <diskio_impl.h>
+}
+
+// Card model
+
+static double nacFirst  = 250e3;    // ns before first block of CMD17/18
+static double nacNext   = 10e3;     // ns between blocks of CMD18
+static double wBusy     = 400e3;    // ns busy after CMD24 block
+static double wBusyMult = 150e3;    // ns busy after each CMD25 block
+static double stopBusy  = 20e3;     // ns busy after CMD12
+static const uint32_t cSize = 15159; // 8GB
+
+static double nowNs = 0;
+static double byteNs = 8e9 / 400000;
+static uint32_t cardHz = 400000;
+
+static struct {
+    bool     sel, idle = true, app, hs;
+    int      acmd41;
+    std::deque<uint8_t> out;
+    uint8_t  cmd[6];
+    int      clen;
+    enum { R_NONE, R_SINGLE, R_MULTI } rd;
+    uint32_t rdSector;
+    double   readyAt;
+    enum { W_NONE, W_SINGLE, W_MULTI } wr;
+    bool     wData;
+    std::vector<uint8_t> wbuf;
+    uint32_t wrSector;
+    double   busyUntil;
+    std::map<uint32_t, std::vector<uint8_t>> store;
+    uint64_t bytes, cmds, crcErr;
+} card;
+
+// Bitwise, so it does not share the driver's tables
+static uint8_t crc7(const uint8_t *d, int n)
+{
+    uint8_t c = 0;
+
+    for(int i = 0; i < n; i++) {
+        for(int b = 7; b >= 0; b--) {
+            uint8_t bit = ((d[i] >> b) & 1) ^ ((c >> 6) & 1);
+            c = (c << 1) & 0x7f;
+            if(bit) c ^= 0x09;
+        }
+    }
+    return c;
+}
+
+static uint16_t crc16(const uint8_t *d, int n)
+{
+    uint16_t c = 0;
+
+    for(int i = 0; i < n; i++) {
+        c ^= d[i] << 8;
+        for(int b = 0; b < 8; b++) c = (c & 0x8000) ? (c << 1) ^ 0x1021 : c << 1;
+    }
+    return c;
+}
+
+static void sectorData(uint32_t s, uint8_t *p)
+{
+    auto it = card.store.find(s);
+
+    if(it != card.store.end()) {
+        memcpy(p, it->second.data(), 512);
+        return;
+    }
+    for(int i = 0; i < 512; i++) p[i] = (uint8_t)(s * 31 + i * 7 + (s >> 8));
+}
+
+static void pushBlock(const uint8_t *p, int n)
+{
+    uint16_t c = crc16(p, n);
+
+    card.out.push_back(0xfe);
+    for(int i = 0; i < n; i++) card.out.push_back(p[i]);
+    card.out.push_back(c >> 8);
+    card.out.push_back(c & 0xff);
+}
+
+static void r1(uint8_t v)
+{
+    card.out.push_back(0xff);
+    card.out.push_back(v);
+}
+
+static void doCmd()
+{
+    uint8_t c = card.cmd[0] & 0x3f;
+    uint32_t arg = (card.cmd[1] << 24) | (card.cmd[2] << 16) | (card.cmd[3] << 8) | card.cmd[4];
+    bool app = card.app;
+    uint8_t st = card.idle ? 1 : 0;
+
+    if(((crc7(card.cmd, 5) << 1) | 1) != card.cmd[5]) card.crcErr++;
+    card.cmds++;
+    card.app = false;
+
+    switch(c) {
+    case 0:
+        card.idle = true; card.acmd41 = 0; card.hs = false;
+        card.rd = card.R_NONE; card.wr = card.W_NONE;
+        r1(1);
+        break;
+    case 6: {
+        uint8_t s[64] = { 0 };
+        bool sw = (arg >> 31) && (arg & 0xf) == 1;
+        r1(0);
+        card.out.push_back(0xff);
+        s[13] = 0x03;               // High Speed supported
+        s[16] = sw ? 0x01 : 0x00;
+        if(arg >> 31) card.hs = sw;
+        pushBlock(s, 64);
+        break;
+        }
+    case 8:
+        r1(st);
+        card.out.push_back(0); card.out.push_back(0);
+        card.out.push_back(1); card.out.push_back(0xaa);
+        break;
+    case 9: {
+        uint8_t csd[16] = { 0x40 };
+        r1(0);
+        card.out.push_back(0xff);
+        csd[7] = (cSize >> 16) & 0x3f; csd[8] = cSize >> 8; csd[9] = cSize & 0xff;
+        pushBlock(csd, 16);
+        break;
+        }
+    case 12:
+        card.out.clear();
+        card.rd = card.R_NONE;
+        card.out.push_back(0xff);
+        card.out.push_back(0x00);
+        card.busyUntil = nowNs + stopBusy;
+        break;
+    case 13:
+        r1(0);
+        card.out.push_back(0);
+        break;
+    case 17:
+    case 18:
+        r1(0);
+        card.rd = (c == 17) ? card.R_SINGLE : card.R_MULTI;
+        card.rdSector = arg;
+        card.readyAt = nowNs + nacFirst;
+        break;
+    case 24:
+    case 25:
+        r1(0);
+        card.wr = (c == 24) ? card.W_SINGLE : card.W_MULTI;
+        card.wrSector = arg;
+        card.wData = false;
+        break;
+    case 41:
+        if(!app) { r1(5); break; }
+        if(++card.acmd41 >= 2) card.idle = false;
+        r1(card.idle ? 1 : 0);
+        break;
+    case 55:
+        r1(st);
+        card.app = true;
+        break;
+    case 58: {
+        uint32_t ocr = card.idle ? 0x00ff8000 : 0xc0ff8000;
+        r1(st);
+        for(int i = 3; i >= 0; i--) card.out.push_back(ocr >> (8 * i));
+        break;
+        }
+    case 16:
+    case 23:
+    case 42:
+    case 59:
+        r1(st);
+        break;
+    default:
+        r1(4);
+        break;
+    }
+}
+
+static uint8_t cardXfer(uint8_t in)
+{
+    uint8_t o = 0xff;
+
+    // Catch up with delay()s in the driver
+    if(nowNs < hostMicros * 1000.0) nowNs = hostMicros * 1000.0;
+    nowNs += byteNs;
+    hostMicros = (uint64_t)(nowNs / 1000);
+    card.bytes++;
+
+    if(!card.sel) return 0xff;
+
+    if(!card.out.empty()) {
+        o = card.out.front();
+        card.out.pop_front();
+    } else if(nowNs < card.busyUntil) {
+        o = 0x00;
+    } else if(card.rd != card.R_NONE && !card.clen && nowNs >= card.readyAt) {
+        uint8_t p[512];
+        sectorData(card.rdSector++, p);
+        pushBlock(p, 512);
+        card.readyAt = nowNs + 515 * byteNs + nacNext;
+        if(card.rd == card.R_SINGLE) card.rd = card.R_NONE;
+    }
+
+    if(card.wr != card.W_NONE && !card.clen) {
+        if(!card.wData) {
+            if(in == 0xfe || in == 0xfc) {
+                card.wData = true;
+                card.wbuf.clear();
+                return o;
+            }
+            if(in == 0xfd && card.wr == card.W_MULTI) {
+                card.wr = card.W_NONE;
+                card.busyUntil = nowNs + stopBusy;
+                return o;
+            }
+            if(in == 0xff) return o;
+        } else {
+            card.wbuf.push_back(in);
+            if(card.wbuf.size() == 514) {
+                bool ok = ((card.wbuf[512] << 8) | card.wbuf[513]) == crc16(card.wbuf.data(), 512);
+                if(!ok) card.crcErr++;
+                card.store[card.wrSector++] = std::vector<uint8_t>(card.wbuf.begin(), card.wbuf.begin() + 512);
+                card.out.push_back(ok ? 0xe5 : 0xeb);
+                card.busyUntil = nowNs + byteNs + (card.wr == card.W_SINGLE ? wBusy : wBusyMult);
+                card.wData = false;
+                if(card.wr == card.W_SINGLE) card.wr = card.W_NONE;
+            }
+            return o;
+        }
+    }
+
+    if(!card.clen && (in & 0xc0) == 0x40) {
+        card.cmd[card.clen++] = in;
+    } else if(card.clen) {
+        card.cmd[card.clen++] = in;
+        if(card.clen == 6) {
+            card.clen = 0;
+            doCmd();
+        }
+    }
+
+    return o;
+}
+
+static void cardClock(uint32_t hz)
+{
+    cardHz = hz;
+    byteNs = 8e9 / hz;
+}
+
+static void cardSelect(int pin, int val)
+{
+    bool s = (val == LOW);
+
+    if(!s && card.sel) card.out.clear();
+    card.sel = s;
+}
+
+// Workloads
+
+static const ff_diskio_impl_t *sd;
+static uint8_t pdrv;
+static uint8_t buf[16 * 512], ref[512];
+static uint64_t verr;
+
+static void rd(uint32_t s, int n)
+{
+    if(sd->read(pdrv, buf, s, n) != RES_OK) {
+        printf("read error at %u\n", s);
+        exit(1);
+    }
+    for(int i = 0; i < n; i++) {
+        sectorData(s + i, ref);
+        if(memcmp(ref, buf + 512 * i, 512)) verr++;
+    }
+}
+
+static void wr(uint32_t s, int n)
+{
+    for(int i = 0; i < n * 512; i++) buf[i] = (uint8_t)(s + i * 13);
+    if(sd->write(pdrv, buf, s, n) != RES_OK) {
+        printf("write error at %u\n", s);
+        exit(1);
+    }
+}
+
+// Renamer or upload: FAT and directory sectors, 4KB of file
+// data, sync
+static void otherTraffic(uint32_t &upl)
+{
+    sd->status(pdrv);
+    rd(8192 + 200 + rand() % 64, 1);
+    sd->status(pdrv);
+    wr(upl, 8);
+    upl += 8;
+    rd(32768 + 640 + rand() % 64, 1);
+    wr(32768 + 640, 1);
+    sd->ioctl(pdrv, CTRL_SYNC, NULL);
+}
+
+// Read 20MB of music, n sectors per call, with a FAT sector read
+// every 32KB; optionally other traffic every 16KB
+static double run(int n, bool other)
+{
+    const uint32_t total = 20 * 1048576 / 512;
+    const uint32_t start = 100000;
+    uint32_t upl = 3000000;
+    double t0 = nowNs;
+
+    srand(1);
+    for(uint32_t s = 0; s < total; s += n) {
+        sd->status(pdrv);
+        rd(start + s, n);
+        if(!(s % 64)) rd(8192 + (start + s) / 128, 1);
+        if(other && !(s % 32)) otherTraffic(upl);
+    }
+
+    return total * 512.0 / ((nowNs - t0) / 1e9) / 1e6;
+}
+
+int main(int argc, char **argv)
+{
+    int hz = argc > 1 ? atoi(argv[1]) : 25000000;
+    uint64_t c0;
+    double r;
+
+    hostSpiXfer = cardXfer;
+    hostSpiClock = cardClock;
+    hostPinWrite = cardSelect;
+
+    pdrv = sdcard_init(5, &SPI, hz);
+    if(pdrv == 0xff || !(sd = hostDiskio[pdrv]) || sd->init(pdrv)) {
+        printf("init failed\n");
+        return 1;
+    }
+
+    for(int n : { 1, 4, 16 }) {
+        c0 = card.cmds;
+        r = run(n, false);
+        if(n == 1) {
+            printf("SD at %.1fMHz, card in %s mode\n", cardHz / 1e6, card.hs ? "High Speed" : "Default Speed");
+        }
+        printf("  %2d sectors/read:                %5.2f MB/s, %6llu cmds\n",
+                n, r, (unsigned long long)(card.cmds - c0));
+    }
+
+    c0 = card.cmds;
+    r = run(4, true);
+    printf("   4 sectors/read, other traffic: %5.2f MB/s, %6llu cmds\n",
+                r, (unsigned long long)(card.cmds - c0));
+
+    nacFirst = 1e6;
+    c0 = card.cmds;
+    r = run(4, false);
+    printf("   4 sectors/read, 1ms latency:   %5.2f MB/s, %6llu cmds\n",
+                r, (unsigned long long)(card.cmds - c0));
+
+    printf("  %llu verify errors, %llu CRC errors\n", (unsigned long long)verr, (unsigned long long)card.crcErr);
+
+    return (verr || card.crcErr) ? 1 : 0;
+}
@@ -0,0 +1,123 @@
+/*
+ * Audio engine: Start latency of sound effects, file vs PCM cache
+ *
+ * Runs the audio engine as a coroutine (HOST_TASKS_COOP), so the
+ * time from play_file() to the first block of output is CPU only.
+ * "file" is an effect that isn't cacheable: SD open, ID3 check,
+ * MP3 decoder start-up and the first frame. "cache" is a listed
+ * effect played from RAM after its first play.
+ *
+ * Three listed effects are played in turn: two long ones that take
+ * most of the internal RAM budget (40KB), and a 52ms key click.
+ * All must stay cached; capturing the click must not evict the
+ * others.
+ */
+
+#include <Arduino.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include "driver/i2s.h"
+
+#include "remote_global.h"
+#include "remote_audio.h"
+#include "remote_settings.h"
+#include "mp3gen.h"
+
+#define ROUNDS  50
+
+typedef std::chrono::steady_clock Clock;
+
+static Clock::time_point t0, t1;
+static bool waiting;
+
+static void onOutput(const int16_t *, size_t, double)
+{
+    if(waiting) {
+        t1 = Clock::now();
+        waiting = false;
+    }
+}
+
+static void writeMp3(const char *dir, const char *fn, int nfr)
+{
+    std::vector<unsigned char> s(nfr * MP3GEN_FRAME + 8);
+    char path[256];
+
+    snprintf(path, sizeof(path), "%s%s", dir, fn);
+    FILE *f = fopen(path, "wb");
+    fwrite(s.data(), 1, mp3gen_random(s.data(), nfr, 1, 90), f);
+    fclose(f);
+}
+
+// Play fn to the end; returns the start latency in us
+static double play(const char *fn)
+{
+    waiting = true;
+    t0 = Clock::now();
+    play_file(fn, PA_ALLOWSD);
+    while(waiting) delay(1);
+    while(!checkAudioReallyDone()) delay(1);
+    return std::chrono::duration<double, std::micro>(t1 - t0).count();
+}
+
+static double median(std::vector<double> v)
+{
+    std::sort(v.begin(), v.end());
+    return v[v.size() / 2];
+}
+
+static unsigned stat(const char *s, const char *key)
+{
+    const char *p = strstr(s, key);
+    return p ? strtoul(p + strlen(key), NULL, 10) : 0;
+}
+
+int main()
+{
+    static const char *fx[] = { "/brakeon.mp3", "/brakeoff.mp3", "/key1.mp3" };
+    char dir[] = "/tmp/bench_start.XXXXXX";
+    std::vector<double> file, cache;
+    char buf[256];
+
+    if(!mkdtemp(dir)) {
+        perror("mkdtemp");
+        return 1;
+    }
+    // 2304 bytes of mono PCM per frame, less one frame: 39KB in all,
+    // 6KB free for capturing the click
+    writeMp3(dir, "/brakeon.mp3", 9);
+    writeMp3(dir, "/brakeoff.mp3", 8);
+    writeMp3(dir, "/key1.mp3", 3);
+    writeMp3(dir, "/fx.mp3", 9);
+
+    hostTasks = HOST_TASKS_COOP;
+    hostSDRoot = dir;
+    hostI2SOut = onOutput;
+
+    settings_setup();
+    audio_setup();
+
+    for(const char *f : fx) play(f);
+    audio_cacheResetStats();
+
+    for(int r = 0; r < ROUNDS; r++) {
+        file.push_back(play("/fx.mp3"));
+        for(const char *f : fx) cache.push_back(play(f));
+    }
+
+    audio_cacheStats(buf, sizeof(buf));
+    printf("%s", buf);
+    printf("start: file %.0fus, cache %.0fus (median of %zu/%zu)\n",
+            median(file), median(cache), file.size(), cache.size());
+
+    for(const char *f : { "/brakeon.mp3", "/brakeoff.mp3", "/key1.mp3", "/fx.mp3" }) {
+        snprintf(buf, sizeof(buf), "%s%s", dir, f);
+        remove(buf);
+    }
+    rmdir(dir);
+
+    // Stats since the reset; misses mean effects were evicted
+    audio_cacheStats(buf, sizeof(buf));
+    return stat(buf, "miss=") != 0 || stat(buf, "hit=") != ROUNDS * 3;
+}
@@ -0,0 +1,16 @@
+/*
+ * Layer III Huffman decoding without OPT_HUFFWIDE, for
+ * test_huffman.c
+ */
+
+#define NO_OPT_HUFFWIDE
+#define mad_layer_III mad_layer_III_tree
+
+#include "src/ESP8266Audio/libmad/layer3.c"
+
+enum mad_error huff_tree(struct mad_bitptr *ptr, mad_fixed_t xr[576],
+                         struct channel *channel, unsigned int const *sfbwidth,
+                         unsigned int part2_length)
+{
+  return III_huffdecode(ptr, xr, channel, sfbwidth, part2_length);
+}
@@ -0,0 +1,123 @@
+/*
+ * Synthetic Layer III streams for tests and benchmarks
+ *
+ * No encoder is available on the build machine, so streams are
+ * made up: 128kbps/44.1kHz frames, no CRC, no bit reservoir.
+ *
+ * mp3gen_random(): Random side info (big_values, table
+ * selection, region split, global_gain from gain to gain + 39)
+ * and random main data. About 1% of the frames end in Huffman
+ * data errors. With gain 130, much of the output is clipped;
+ * gain 90 stays below full scale.
+ *
+ * mp3gen_switching(): As mp3gen_random(), but stereo, and each
+ * channel of each granule picks its own block type (long, start,
+ * short, mixed short, stop), so L and R often differ.
+ */
+
+#ifndef _HOST_MP3GEN_H
+#define _HOST_MP3GEN_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#define MP3GEN_FRAME 417
+
+static unsigned long long mp3gen_rs = 88172645463325252ULL;
+
+static unsigned mp3gen_rnd(void)
+{
+  mp3gen_rs ^= mp3gen_rs << 13; mp3gen_rs ^= mp3gen_rs >> 7; mp3gen_rs ^= mp3gen_rs << 17;
+  return (unsigned)mp3gen_rs;
+}
+
+static unsigned char *mp3gen_bp;
+static int mp3gen_bl;
+
+static void mp3gen_put(unsigned v, int n)
+{
+  while (n--) {
+    if (mp3gen_bl == 0) {
+      *++mp3gen_bp = 0;
+      mp3gen_bl = 8;
+    }
+    mp3gen_bl--;
+    if (v >> n & 1)
+      *mp3gen_bp |= 1 << mp3gen_bl;
+  }
+}
+
+/* Frame header; main_data_begin, private bits and scfsi all 0 */
+static void mp3gen_header(unsigned char *f, int mono)
+{
+  f[0] = 0xff; f[1] = 0xfb; f[2] = 0x90; f[3] = mono ? 0xc0 : 0x00;
+  mp3gen_bp = f + 3;
+  mp3gen_bl = 0;
+  mp3gen_put(0, 9); mp3gen_put(0, mono ? 5 : 3); mp3gen_put(0, 4 * (mono ? 1 : 2));
+}
+
+/* Side info of one channel, bits: main data per channel; ws:
+   window switching with a random block type */
+static void mp3gen_channel(int bits, int gain, int ws)
+{
+  static unsigned char const sel[] = {
+    1, 2, 3, 5, 6, 7, 8, 9, 10, 11, 12, 13, 15, 16, 17,
+    18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31
+  };
+
+  // big_values: Most granules fit into part2_3_length
+  mp3gen_put(bits - mp3gen_rnd() % 64, 12);
+  mp3gen_put(bits / 24 + mp3gen_rnd() % (bits / 24), 9);
+  mp3gen_put(gain + mp3gen_rnd() % 40, 8);
+  mp3gen_put(mp3gen_rnd() % 16, 4);
+  mp3gen_put(ws, 1);
+  if (ws) {
+    int bt = 1 + mp3gen_rnd() % 3;
+    mp3gen_put(bt, 2);
+    mp3gen_put(bt == 2 && (mp3gen_rnd() & 1), 1);
+    for (int i = 0; i < 2; i++)
+      mp3gen_put(sel[mp3gen_rnd() % sizeof(sel)], 5);
+    for (int i = 0; i < 3; i++)
+      mp3gen_put(mp3gen_rnd() % 4, 3);
+  }
+  else {
+    for (int i = 0; i < 3; i++)
+      mp3gen_put(sel[mp3gen_rnd() % sizeof(sel)], 5);
+    mp3gen_put(mp3gen_rnd() % 16, 4); mp3gen_put(mp3gen_rnd() % 8, 3);
+  }
+  mp3gen_put(0, 1); mp3gen_put(0, 1); mp3gen_put(mp3gen_rnd() & 1, 1);
+}
+
+static unsigned long mp3gen_stream(unsigned char *s, int nfr, int mono, int gain, int sw)
+{
+  int nch = mono ? 1 : 2, si = mono ? 17 : 32, md = MP3GEN_FRAME - 4 - si;
+  int bits = md * 8 / (2 * nch);
+  unsigned char *f = s;
+
+  for (int k = 0; k < nfr; k++, f += MP3GEN_FRAME) {
+    mp3gen_header(f, mono);
+    for (int gr = 0; gr < 2; gr++) {
+      for (int ch = 0; ch < nch; ch++)
+        mp3gen_channel(bits, gain, sw && (mp3gen_rnd() & 1));
+    }
+    for (int i = 4 + si; i < MP3GEN_FRAME; i++)
+      f[i] = mp3gen_rnd();
+  }
+
+  return (unsigned long)nfr * MP3GEN_FRAME;
+}
+
+/* nfr frames into s (nfr * MP3GEN_FRAME bytes plus 8 of padding,
+   zeroed); returns the stream length */
+static inline unsigned long mp3gen_random(unsigned char *s, int nfr, int mono, int gain)
+{
+  return mp3gen_stream(s, nfr, mono, gain, 0);
+}
+
+/* Same for mp3gen_switching() */
+static inline unsigned long mp3gen_switching(unsigned char *s, int nfr, int gain)
+{
+  return mp3gen_stream(s, nfr, 0, gain, 1);
+}
+
+#endif
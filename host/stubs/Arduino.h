@@ -0,0 +1,171 @@
+/*
+ * Host build: Minimal Arduino-ESP32 core
+ *
+ * Only what the modules built by ../Makefile use. Time is virtual:
+ * millis()/micros() only advance through delay(), yield() (1us)
+ * and host_advance(), so tests are deterministic. With tasks on
+ * (hostTasks, see tasks.cpp), these calls also let other tasks
+ * run.
+ */
+
+#ifndef _HOST_ARDUINO_H
+#define _HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <math.h>
+#include <limits.h>
+#include <time.h>
+
+#include "pgmspace.h"
+#include "esp_system.h"
+
+#define IRAM_ATTR
+
+#define LOW             0
+#define HIGH            1
+#define INPUT           1
+#define OUTPUT          3
+#define INPUT_PULLUP    5
+#define INPUT_PULLDOWN  9
+#define RISING          1
+#define FALLING         2
+#define CHANGE          3
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+// Virtual clock
+
+#define HOST_TASKS_OFF      0
+#define HOST_TASKS_COOP     1
+#define HOST_TASKS_THREADS  2
+
+extern uint64_t hostMicros;
+extern int hostTasks;
+
+void host_sleep(uint64_t us);
+
+static inline unsigned long millis() { return (unsigned long)(hostMicros / 1000); }
+static inline unsigned long micros() { return (unsigned long)hostMicros; }
+static inline void delayMicroseconds(unsigned int us) 
+{ 
+    if(hostTasks) host_sleep(us);
+    else hostMicros += us;
+}
+static inline void delay(unsigned long ms) 
+{ 
+    if(hostTasks) host_sleep((uint64_t)ms * 1000);
+    else hostMicros += (uint64_t)ms * 1000;
+}
+static inline void yield() { delayMicroseconds(1); }
+static inline void host_advance(unsigned long ms) { delay(ms); }
+
+// GPIO: Inputs read as HIGH (all buttons released) unless set
+// through host_setPin(), which also runs attached interrupts.
+
+#define NUM_DIGITAL_PINS    40
+#define digitalPinToInterrupt(p)  (p)
+
+extern uint8_t hostPinLevel[NUM_DIGITAL_PINS];
+extern void (*hostPinWrite)(int pin, int val);
+
+static inline void pinMode(int, int) {}
+static inline void digitalWrite(int pin, int val) { if(hostPinWrite) hostPinWrite(pin, val); }
+static inline int  digitalRead(int pin) { return (pin >= 0 && pin < NUM_DIGITAL_PINS) ? hostPinLevel[pin] : HIGH; }
+void attachInterruptArg(int pin, void (*isr)(void *), void *arg, int mode);
+void detachInterrupt(int pin);
+void host_setPin(int pin, int val);
+
+template<class T> static inline T min(T a, T b) { return a < b ? a : b; }
+template<class T> static inline T max(T a, T b) { return a > b ? a : b; }
+
+// Core log macros: Off, as with the core's default log level
+
+#define log_e(...)  ((void)0)
+#define log_w(...)  ((void)0)
+#define log_i(...)  ((void)0)
+#define log_d(...)  ((void)0)
+
+// Print, Serial
+
+class Print {
+    public:
+        virtual ~Print() {}
+        virtual size_t write(uint8_t c) = 0;
+        size_t print(const char *s) { size_t n = 0; while(*s) n += write(*s++); return n; }
+        size_t println(const char *s = "") { size_t n = print(s); return n + write('\n'); }
+        int printf(const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+};
+
+class HostSerial : public Print {
+    public:
+        size_t write(uint8_t c) override;
+        void begin(unsigned long) {}
+        void flush() {}
+};
+
+extern HostSerial Serial;
+
+class String {
+    public:
+        String(const char *s = "") { _s = strdup(s ? s : ""); }
+        String(const String &o) { _s = strdup(o._s); }
+        ~String() { free(_s); }
+        String &operator=(const String &o) { if(this != &o) { free(_s); _s = strdup(o._s); } return *this; }
+        const char *c_str() const { return _s; }
+        size_t length() const { return strlen(_s); }
+        bool isEmpty() const { return !*_s; }
+        char charAt(unsigned i) const { return i < length() ? _s[i] : 0; }
+    private:
+        char *_s;
+};
+
+struct HostESP { uint32_t getCycleCount() { return (uint32_t)hostMicros * 240; } };
+extern HostESP ESP;
+
+static inline uint32_t getCpuFrequencyMhz() { return 240; }
+static inline uint32_t esp_random() { return (uint32_t)rand(); }
+static inline bool  psramFound() { return false; }
+static inline void *ps_malloc(size_t s) { return malloc(s); }
+static inline void *ps_realloc(void *p, size_t s) { return realloc(p, s); }
+
+// FreeRTOS: See tasks.cpp. With tasks off, no task is started;
+// a task handle is a dummy, so code that checks for its task
+// takes the "running" path, and mutexes and critical sections
+// are no-ops.
+
+typedef void    *TaskHandle_t;
+typedef void    *SemaphoreHandle_t;
+typedef uint32_t TickType_t;
+typedef struct { int x; } portMUX_TYPE;
+
+#define pdTRUE                      1
+#define pdFALSE                     0
+#define pdPASS                      1
+#define portMAX_DELAY               0xffffffff
+#define portTICK_PERIOD_MS          1
+#define pdMS_TO_TICKS(x)            (x)
+#define portMUX_INITIALIZER_UNLOCKED { 0 }
+#define portENTER_CRITICAL(x)       ((void)(x), host_critical(true))
+#define portEXIT_CRITICAL(x)        ((void)(x), host_critical(false))
+#define portENTER_CRITICAL_ISR(x)   portENTER_CRITICAL(x)
+#define portEXIT_CRITICAL_ISR(x)    portEXIT_CRITICAL(x)
+
+int  xTaskCreatePinnedToCore(void (*fn)(void *), const char *name, int stack, void *arg, int prio, TaskHandle_t *h, int core);
+static inline void vTaskDelay(TickType_t t) { delay(t); }
+void vTaskDelayUntil(TickType_t *last, TickType_t inc);
+static inline TickType_t xTaskGetTickCount() { return millis(); }
+TaskHandle_t xTaskGetCurrentTaskHandle();
+void xTaskNotifyGive(TaskHandle_t h);
+uint32_t ulTaskNotifyTake(int clear, TickType_t ticks);
+SemaphoreHandle_t xSemaphoreCreateMutex();
+int  xSemaphoreTake(SemaphoreHandle_t s, TickType_t ticks);
+int  xSemaphoreGive(SemaphoreHandle_t s);
+void host_critical(bool enter);
+
+#endif
@@ -0,0 +1,45 @@
+/*
+ * Host build: AsyncUDP on the fake network
+ *
+ * The packet handler runs in the context of host_udpDeliver().
+ */
+
+#ifndef _HOST_ASYNCUDP_H
+#define _HOST_ASYNCUDP_H
+
+#include <IPAddress.h>
+
+class AsyncUDPPacket {
+    public:
+        AsyncUDPPacket(IPAddress from, uint16_t port, const uint8_t *data, size_t len) 
+            : _from(from), _port(port), _data(data), _len(len) {}
+        uint8_t  *data() { return (uint8_t *)_data; }
+        size_t    length() { return _len; }
+        IPAddress remoteIP() { return _from; }
+        uint16_t  remotePort() { return _port; }
+
+    private:
+        IPAddress _from;
+        uint16_t  _port;
+        const uint8_t *_data;
+        size_t    _len;
+};
+
+typedef void (*AuPacketHandlerFunctionWithArg)(void *arg, AsyncUDPPacket &packet);
+
+class AsyncUDP {
+    public:
+        AsyncUDP() {}
+        ~AsyncUDP() { close(); }
+        bool listenMulticast(const IPAddress addr, uint16_t port);
+        void onPacket(AuPacketHandlerFunctionWithArg cb, void *arg = NULL) { _cb = cb; _arg = arg; }
+        void close();
+
+        // net.cpp
+        IPAddress _group;
+        uint16_t  _port = 0;
+        AuPacketHandlerFunctionWithArg _cb = NULL;
+        void     *_arg = NULL;
+};
+
+#endif
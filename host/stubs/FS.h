@@ -0,0 +1,130 @@
+/*
+ * Host build: fs::FS on a directory of the host
+ *
+ * Files and directory listing. As in core 2.x, File::name() is
+ * the last path component, File::path() the full path.
+ */
+
+#ifndef _HOST_FS_H
+#define _HOST_FS_H
+
+#include <Arduino.h>
+#include <memory>
+#include <string>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define FILE_READ   "r"
+#define FILE_WRITE  "w"
+#define FILE_APPEND "a"
+
+namespace fs {
+
+enum SeekMode { SeekSet = 0, SeekCur = 1, SeekEnd = 2 };
+
+class File {
+    public:
+        File() {}
+        File(FILE *f, const std::string &path) : _f(f, fclose), _path(path) {}
+        File(DIR *d, const std::string &path, const std::string &host)
+            : _d(d, closedir), _path(path), _host(host) {}
+
+        operator bool() const { return _f || _d; }
+
+        int read() { int c = _f ? fgetc(_f.get()) : EOF; return c == EOF ? -1 : c; }
+        size_t read(uint8_t *buf, size_t len) { return _f ? fread(buf, 1, len, _f.get()) : 0; }
+        size_t write(uint8_t c) { return write(&c, 1); }
+        size_t write(const uint8_t *buf, size_t len) { return _f ? fwrite(buf, 1, len, _f.get()) : 0; }
+        bool seek(uint32_t pos, SeekMode mode = SeekSet) { return _f && !fseek(_f.get(), pos, mode); }
+        size_t position() const { return _f ? ftell(_f.get()) : 0; }
+        size_t size() const
+        {
+            struct stat st;
+            return (_f && !fstat(fileno(_f.get()), &st)) ? st.st_size : 0;
+        }
+        int available() { return _f ? (int)(size() - position()) : 0; }
+        void flush() { if(_f) fflush(_f.get()); }
+        void close() { _f.reset(); _d.reset(); }
+        const char *path() const { return _path.c_str(); }
+        const char *name() const
+        {
+            size_t i = _path.rfind('/');
+            return _path.c_str() + (i == std::string::npos ? 0 : i + 1);
+        }
+        bool isDirectory() { return !!_d; }
+
+        File openNextFile(const char *mode = FILE_READ)
+        {
+            struct dirent *e;
+
+            while(_d && (e = readdir(_d.get()))) {
+                if(!strcmp(e->d_name, ".") || !strcmp(e->d_name, "..")) continue;
+                std::string p = _path + (_path.back() == '/' ? "" : "/") + e->d_name;
+                std::string h = _host + "/" + e->d_name;
+                if(DIR *d = opendir(h.c_str())) return File(d, p, h);
+                std::string m = std::string(mode) + "b";
+                if(FILE *f = fopen(h.c_str(), m.c_str())) return File(f, p);
+            }
+            return File();
+        }
+        void rewindDirectory() { if(_d) rewinddir(_d.get()); }
+
+    private:
+        std::shared_ptr<FILE> _f;
+        std::shared_ptr<DIR> _d;
+        std::string _path, _host;
+};
+
+// Root directory on the host; may be changed while mounted
+struct FSImpl {
+    FSImpl(const char *root = ".") : root(root) {}
+    std::string root;
+};
+
+typedef std::shared_ptr<FSImpl> FSImplPtr;
+
+class FS {
+    public:
+        FS(FSImplPtr impl) : _impl(impl) {}
+        FS(const char *root = ".") : _impl(new FSImpl(root)) {}
+
+        File open(const char *path, const char *mode = FILE_READ, bool create = false)
+        {
+            std::string h = full(path);
+            if(!strcmp(mode, FILE_READ)) {
+                if(DIR *d = opendir(h.c_str())) return File(d, path, h);
+            }
+            std::string m = std::string(mode) + "b";
+            FILE *f = fopen(h.c_str(), m.c_str());
+            return f ? File(f, path) : File();
+        }
+        File open(const String &path, const char *mode = FILE_READ) { return open(path.c_str(), mode); }
+        bool exists(const char *path) { return !access(full(path).c_str(), F_OK); }
+        bool remove(const char *path) { return !::remove(full(path).c_str()); }
+        bool rename(const char *from, const char *to) { return !::rename(full(from).c_str(), full(to).c_str()); }
+        bool mkdir(const char *path) { return !::mkdir(full(path).c_str(), 0755); }
+        bool rmdir(const char *path) { return !::rmdir(full(path).c_str()); }
+
+        void host_setRoot(const char *root) { _impl->root = root; }
+
+    protected:
+        FSImplPtr _impl;
+
+    private:
+        std::string full(const char *path) { return _impl->root + "/" + path; }
+};
+
+}
+
+// SD.begin() mounts this directory; NULL: no card (fs.cpp)
+extern const char *hostSDRoot;
+
+using fs::FS;
+using fs::File;
+using fs::SeekMode;
+using fs::SeekSet;
+using fs::SeekCur;
+using fs::SeekEnd;
+
+#endif
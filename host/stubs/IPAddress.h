@@ -0,0 +1,44 @@
+/*
+ * Host build: IPAddress
+ *
+ * Stored as lwIP does: first octet in the lowest byte of the
+ * uint32_t.
+ */
+
+#ifndef _HOST_IPADDRESS_H
+#define _HOST_IPADDRESS_H
+
+#include <Arduino.h>
+
+class IPAddress {
+    public:
+        IPAddress(uint32_t a = 0) : _a(a) {}
+        IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : _a(a | (b << 8) | (c << 16) | ((uint32_t)d << 24)) {}
+
+        operator uint32_t() const { return _a; }
+        uint8_t operator[](int i) const { return _a >> (8 * i); }
+        bool operator==(const IPAddress &o) const { return _a == o._a; }
+        bool operator!=(const IPAddress &o) const { return _a != o._a; }
+
+        bool fromString(const char *s)
+        {
+            unsigned a, b, c, d;
+            char x;
+            if(sscanf(s, "%u.%u.%u.%u%c", &a, &b, &c, &d, &x) != 4 || (a | b | c | d) > 255)
+                return false;
+            _a = IPAddress(a, b, c, d);
+            return true;
+        }
+        String toString() const
+        {
+            char buf[16];
+            snprintf(buf, sizeof(buf), "%u.%u.%u.%u", (*this)[0], (*this)[1], (*this)[2], (*this)[3]);
+            return String(buf);
+        }
+        bool isMulticast() const { return ((*this)[0] & 0xf0) == 0xe0; }
+
+    private:
+        uint32_t _a;
+};
+
+#endif
@@ -0,0 +1,34 @@
+/*
+ * Host build: LittleFS on a directory of the host
+ *
+ * Mounted at hostFlashRoot by begin().
+ */
+
+#ifndef _HOST_LITTLEFS_H
+#define _HOST_LITTLEFS_H
+
+#include <FS.h>
+
+extern const char *hostFlashRoot;
+
+namespace fs {
+
+class LittleFSFS : public FS {
+    public:
+        LittleFSFS() : FS(FSImplPtr(new FSImpl(hostFlashRoot))) {}
+        bool begin(bool formatOnFail = false, const char *basePath = "/littlefs", uint8_t maxOpen = 10, const char *label = "spiffs")
+        {
+            host_setRoot(hostFlashRoot);
+            return true;
+        }
+        void end() {}
+        bool format() { return true; }
+        size_t totalBytes() { return 0x160000; }
+        size_t usedBytes() { return 0; }
+};
+
+}
+
+extern fs::LittleFSFS LittleFS;
+
+#endif
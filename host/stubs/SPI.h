@@ -0,0 +1,58 @@
+/*
+ * Host build: SPIClass on a fake bus
+ *
+ * Bytes go to hostSpiXfer (0xff back if not set), the clock
+ * of each transaction to hostSpiClock.
+ */
+
+#ifndef _HOST_SPI_H
+#define _HOST_SPI_H
+
+#include <Arduino.h>
+
+#define MSBFIRST    1
+#define SPI_MODE0   0
+#define SS          5
+
+extern uint8_t (*hostSpiXfer)(uint8_t out);
+extern void    (*hostSpiClock)(uint32_t hz);
+
+struct SPISettings {
+    SPISettings(uint32_t freq = 1000000, int order = MSBFIRST, int mode = SPI_MODE0) : freq(freq) {}
+    uint32_t freq;
+};
+
+class SPIClass {
+    public:
+        void begin(int sck = -1, int miso = -1, int mosi = -1, int ss = -1) {}
+        void end() {}
+        void beginTransaction(SPISettings s) { if(hostSpiClock) hostSpiClock(s.freq); }
+        void endTransaction() {}
+        uint8_t transfer(uint8_t b) { return hostSpiXfer ? hostSpiXfer(b) : 0xff; }
+        uint16_t transfer16(uint16_t w) 
+        { 
+            uint16_t h = transfer(w >> 8); 
+            return (h << 8) | transfer(w); 
+        }
+        uint32_t transfer32(uint32_t w)
+        {
+            uint32_t r = 0;
+            for(int i = 3; i >= 0; i--) r = (r << 8) | transfer(w >> (8 * i));
+            return r;
+        }
+        void transferBytes(const uint8_t *d, uint8_t *o, uint32_t n)
+        {
+            for(uint32_t i = 0; i < n; i++) {
+                uint8_t r = transfer(d ? d[i] : 0xff);
+                if(o) o[i] = r;
+            }
+        }
+        void writeBytes(const uint8_t *d, uint32_t n) { for(uint32_t i = 0; i < n; i++) transfer(d[i]); }
+        void write(uint8_t b) { transfer(b); }
+        void write16(uint16_t w) { transfer16(w); }
+        void write32(uint32_t w) { transfer32(w); }
+};
+
+extern SPIClass SPI;
+
+#endif
@@ -0,0 +1,28 @@
+/*
+ * Host build: Arduino UDP interface
+ */
+
+#ifndef _HOST_UDP_H
+#define _HOST_UDP_H
+
+#include <IPAddress.h>
+
+class UDP {
+    public:
+        virtual ~UDP() {}
+        virtual uint8_t begin(uint16_t port) = 0;
+        virtual uint8_t beginMulticast(IPAddress ip, uint16_t port) = 0;
+        virtual void stop() = 0;
+        virtual int  beginPacket(IPAddress ip, uint16_t port) = 0;
+        virtual int  endPacket() = 0;
+        virtual size_t write(uint8_t c) = 0;
+        virtual size_t write(const uint8_t *buf, size_t len) = 0;
+        virtual int  parsePacket() = 0;
+        virtual int  available() = 0;
+        virtual int  read() = 0;
+        virtual int  read(uint8_t *buf, size_t len) = 0;
+        virtual IPAddress remoteIP() = 0;
+        virtual uint16_t remotePort() = 0;
+};
+
+#endif
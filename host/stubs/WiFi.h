@@ -0,0 +1,35 @@
+/*
+ * Host build: WiFi station on the fake network
+ *
+ * WiFi.status() is hostWiFiStatus; see net.cpp.
+ */
+
+#ifndef _HOST_WIFI_H
+#define _HOST_WIFI_H
+
+#include <IPAddress.h>
+#include <WiFiClient.h>
+#include <WiFiUdp.h>
+
+typedef enum {
+    WL_NO_SHIELD        = 255,
+    WL_IDLE_STATUS      = 0,
+    WL_NO_SSID_AVAIL    = 1,
+    WL_SCAN_COMPLETED   = 2,
+    WL_CONNECTED        = 3,
+    WL_CONNECT_FAILED   = 4,
+    WL_CONNECTION_LOST  = 5,
+    WL_DISCONNECTED     = 6
+} wl_status_t;
+
+extern wl_status_t hostWiFiStatus;
+
+class HostWiFi {
+    public:
+        wl_status_t status() { return hostWiFiStatus; }
+        IPAddress localIP() { return hostIP; }
+};
+
+extern HostWiFi WiFi;
+
+#endif
@@ -0,0 +1,25 @@
+/*
+ * Host build: WiFiClient
+ *
+ * No TCP on the fake network; connect() always fails.
+ */
+
+#ifndef _HOST_WIFICLIENT_H
+#define _HOST_WIFICLIENT_H
+
+#include <IPAddress.h>
+
+class WiFiClient {
+    public:
+        int connect(IPAddress ip, uint16_t port, int timeout = 0) { return 0; }
+        int connect(const char *host, uint16_t port, int timeout = 0) { return 0; }
+        uint8_t connected() { return 0; }
+        int  available() { return 0; }
+        int  read() { return -1; }
+        size_t write(const uint8_t *buf, size_t len) { return 0; }
+        void flush() {}
+        void stop() {}
+        operator bool() { return false; }
+};
+
+#endif
@@ -0,0 +1,56 @@
+/*
+ * Host build: WiFiUDP on the fake network
+ *
+ * See net.cpp. Datagrams sent go to hostUdpSend; datagrams
+ * passed to host_udpDeliver() queue up in every socket bound to
+ * their port (and group, if multicast).
+ */
+
+#ifndef _HOST_WIFIUDP_H
+#define _HOST_WIFIUDP_H
+
+#include <Udp.h>
+#include <deque>
+#include <vector>
+
+struct HostDatagram {
+    IPAddress from;
+    uint16_t  fromPort;
+    std::vector<uint8_t> data;
+};
+
+extern IPAddress hostIP;
+extern void (*hostUdpSend)(IPAddress to, uint16_t port, uint16_t fromPort, const uint8_t *data, size_t len);
+void host_udpDeliver(IPAddress from, uint16_t fromPort, IPAddress to, uint16_t port, const uint8_t *data, size_t len);
+
+class WiFiUDP : public UDP {
+    public:
+        WiFiUDP() {}
+        ~WiFiUDP() { stop(); }
+        uint8_t begin(uint16_t port) override;
+        uint8_t beginMulticast(IPAddress ip, uint16_t port) override;
+        void stop() override;
+        int  beginPacket(IPAddress ip, uint16_t port) override;
+        int  endPacket() override;
+        size_t write(uint8_t c) override { return write(&c, 1); }
+        size_t write(const uint8_t *buf, size_t len) override;
+        int  parsePacket() override;
+        int  available() override { return _rx.size() - _rxPos; }
+        int  read() override { uint8_t c; return read(&c, 1) == 1 ? c : -1; }
+        int  read(uint8_t *buf, size_t len) override;
+        IPAddress remoteIP() override { return _rxFrom; }
+        uint16_t remotePort() override { return _rxFromPort; }
+
+        // net.cpp
+        uint16_t  _port = 0;
+        IPAddress _group;
+        std::deque<HostDatagram> _q;
+
+    private:
+        std::vector<uint8_t> _tx, _rx;
+        size_t    _rxPos = 0;
+        IPAddress _txTo, _rxFrom;
+        uint16_t  _txPort = 0, _rxFromPort = 0;
+};
+
+#endif
@@ -0,0 +1,66 @@
+/*
+ * Host build: TwoWire on a fake bus
+ */
+
+#include <Arduino.h>
+#include <Wire.h>
+
+FakeI2C fakeI2C;
+TwoWire Wire;
+
+// Start, address, bytes, stop: 9 bits each at 400kHz
+static void busTime(int bytes)
+{
+    delayMicroseconds((bytes + 1) * 9 * 10 / 4 + 3);
+}
+
+void TwoWire::beginTransmission(uint8_t addr)
+{
+    _addr = addr;
+    _tx.clear();
+}
+
+uint8_t TwoWire::endTransmission(bool stop)
+{
+    auto d = fakeI2C.devs.find(_addr);
+    int ret = 0;
+
+    if(d == fakeI2C.devs.end() || d->second.nack) {
+        ret = 2;    // NACK on address
+    }
+    busTime(ret ? 0 : _tx.size());
+    fakeI2C.log.push_back({ _addr, false, stop, ret, _tx });
+    _tx.clear();
+
+    return ret;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t addr, uint8_t len)
+{
+    auto d = fakeI2C.devs.find(addr);
+    FakeI2CTxn t = { addr, true, true, 0, {} };
+
+    _rx.clear();
+    if(d != fakeI2C.devs.end() && !d->second.nack) {
+        while(len-- && !d->second.rx.empty()) {
+            t.data.push_back(d->second.rx.front());
+            d->second.rx.pop_front();
+        }
+    }
+    t.ret = t.data.size();
+    _rx.assign(t.data.begin(), t.data.end());
+    busTime(t.ret);
+    fakeI2C.log.push_back(t);
+
+    return t.ret;
+}
+
+int TwoWire::read()
+{
+    if(_rx.empty()) return -1;
+
+    int c = _rx.front();
+    _rx.pop_front();
+
+    return c;
+}
@@ -0,0 +1,57 @@
+/*
+ * Host build: TwoWire on a fake bus
+ *
+ * Every transaction is logged. A device is present if it has an
+ * entry in devs; reads return the bytes queued in its rx. Each
+ * transaction advances the virtual clock by its time at 400kHz.
+ */
+
+#ifndef _HOST_WIRE_H
+#define _HOST_WIRE_H
+
+#include <Arduino.h>
+#include <deque>
+#include <map>
+#include <vector>
+
+struct FakeI2CTxn {
+    uint8_t addr;
+    bool    read;
+    bool    stop;
+    int     ret;                    // endTransmission() result, bytes read
+    std::vector<uint8_t> data;
+};
+
+struct FakeI2CDev {
+    bool    nack = false;           // Address NACK
+    std::deque<uint8_t> rx;
+};
+
+struct FakeI2C {
+    std::map<uint8_t, FakeI2CDev> devs;
+    std::vector<FakeI2CTxn> log;
+    void reset() { devs.clear(); log.clear(); }
+};
+
+extern FakeI2C fakeI2C;
+
+class TwoWire {
+    public:
+        bool    begin(int sda = -1, int scl = -1, uint32_t freq = 0) { return true; }
+        void    beginTransmission(uint8_t addr);
+        size_t  write(uint8_t c) { _tx.push_back(c); return 1; }
+        size_t  write(const uint8_t *buf, size_t len) { _tx.insert(_tx.end(), buf, buf + len); return len; }
+        uint8_t endTransmission(bool stop = true);
+        uint8_t requestFrom(uint8_t addr, uint8_t len);
+        int     available() { return (int)_rx.size(); }
+        int     read();
+
+    private:
+        uint8_t _addr = 0;
+        std::vector<uint8_t> _tx;
+        std::deque<uint8_t> _rx;
+};
+
+extern TwoWire Wire;
+
+#endif
@@ -0,0 +1,21 @@
+/*
+ * Host build: FatFs disk interface
+ */
+
+#ifndef _HOST_DISKIO_H
+#define _HOST_DISKIO_H
+
+typedef BYTE DSTATUS;
+typedef enum { RES_OK = 0, RES_ERROR, RES_WRPRT, RES_NOTRDY, RES_PARERR } DRESULT;
+
+#define STA_NOINIT          0x01
+#define STA_NODISK          0x02
+#define STA_PROTECT         0x04
+
+#define CTRL_SYNC           0
+#define GET_SECTOR_COUNT    1
+#define GET_SECTOR_SIZE     2
+#define GET_BLOCK_SIZE      3
+#define CTRL_TRIM           4
+
+#endif
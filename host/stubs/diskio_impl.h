@@ -0,0 +1,34 @@
+/*
+ * Host build: ESP-IDF FatFs driver registry
+ *
+ * ff_diskio_register() stores the driver in hostDiskio[], so a
+ * test can call it as FatFs would.
+ */
+
+#ifndef _HOST_DISKIO_IMPL_H
+#define _HOST_DISKIO_IMPL_H
+
+#include "esp_system.h"
+
+typedef struct {
+    DSTATUS (*init)(unsigned char pdrv);
+    DSTATUS (*status)(unsigned char pdrv);
+    DRESULT (*read)(unsigned char pdrv, unsigned char *buff, DWORD sector, UINT count);
+    DRESULT (*write)(unsigned char pdrv, const unsigned char *buff, DWORD sector, UINT count);
+    DRESULT (*ioctl)(unsigned char pdrv, unsigned char cmd, void *buff);
+} ff_diskio_impl_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern const ff_diskio_impl_t *hostDiskio[FF_VOLUMES];
+
+void ff_diskio_register(BYTE pdrv, const ff_diskio_impl_t *impl);
+esp_err_t ff_diskio_get_drive(BYTE *out_pdrv);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,75 @@
+/*
+ * Host build: I2S driver on the virtual clock
+ *
+ * The DMA buffers are modelled as a queue that plays out at the
+ * sample rate: i2s_write() takes what fits, and waits for room
+ * (on the virtual clock) only if given a timeout. Each block
+ * taken goes to hostI2SOut with the time it starts playing. If
+ * the queue runs empty between two writes, that is an underrun;
+ * hostI2S counts them. 16-bit stereo only. See i2s.cpp.
+ */
+
+#ifndef _HOST_DRIVER_I2S_H
+#define _HOST_DRIVER_I2S_H
+
+#include <Arduino.h>
+
+typedef int i2s_port_t;
+
+typedef enum {
+    I2S_MODE_MASTER = 1, I2S_MODE_SLAVE = 2, I2S_MODE_TX = 4, I2S_MODE_RX = 8,
+    I2S_MODE_DAC_BUILT_IN = 16, I2S_MODE_ADC_BUILT_IN = 32, I2S_MODE_PDM = 64
+} i2s_mode_t;
+typedef enum { I2S_BITS_PER_SAMPLE_16BIT = 16, I2S_BITS_PER_SAMPLE_32BIT = 32 } i2s_bits_per_sample_t;
+typedef enum { I2S_CHANNEL_FMT_RIGHT_LEFT = 0 } i2s_channel_fmt_t;
+typedef enum {
+    I2S_COMM_FORMAT_STAND_I2S = 1, I2S_COMM_FORMAT_STAND_MSB = 3,
+    I2S_COMM_FORMAT_I2S = 1, I2S_COMM_FORMAT_I2S_MSB = 1, I2S_COMM_FORMAT_I2S_LSB = 2
+} i2s_comm_format_t;
+typedef enum { I2S_DAC_CHANNEL_DISABLE = 0, I2S_DAC_CHANNEL_BOTH_EN = 3 } i2s_dac_mode_t;
+
+#define I2S_PIN_NO_CHANGE       (-1)
+#define ESP_INTR_FLAG_LEVEL1    (1 << 1)
+
+typedef struct {
+    i2s_mode_t            mode;
+    uint32_t              sample_rate;
+    i2s_bits_per_sample_t bits_per_sample;
+    i2s_channel_fmt_t     channel_format;
+    i2s_comm_format_t     communication_format;
+    int                   intr_alloc_flags;
+    int                   dma_buf_count;
+    int                   dma_buf_len;
+    int                   use_apll;
+} i2s_config_t;
+
+typedef struct {
+    int bck_io_num;
+    int ws_io_num;
+    int data_out_num;
+    int data_in_num;
+} i2s_pin_config_t;
+
+struct HostI2S {
+    bool     on;
+    uint32_t rate;
+    uint32_t frames;            // DMA buffer size
+    double   endUs;             // When the queued frames have played
+    uint64_t written;           // Frames taken
+    uint64_t underruns;
+    double   underrunUs;        // Total time the queue was empty
+    double   cutUs;             // Total queued time dropped unplayed
+};
+
+extern HostI2S hostI2S;
+extern void (*hostI2SOut)(const int16_t *lr, size_t frames, double startUs);
+
+esp_err_t i2s_driver_install(i2s_port_t port, const i2s_config_t *cfg, int qsize, void *q);
+esp_err_t i2s_driver_uninstall(i2s_port_t port);
+esp_err_t i2s_set_pin(i2s_port_t port, const i2s_pin_config_t *pins);
+esp_err_t i2s_set_dac_mode(i2s_dac_mode_t mode);
+esp_err_t i2s_set_sample_rates(i2s_port_t port, uint32_t rate);
+esp_err_t i2s_zero_dma_buffer(i2s_port_t port);
+esp_err_t i2s_write(i2s_port_t port, const void *src, size_t size, size_t *written, TickType_t ticks);
+
+#endif
@@ -0,0 +1,34 @@
+/*
+ * Host build: No flash partitions; the sound-pack partition
+ * is never found
+ */
+
+#ifndef _HOST_ESP_PARTITION_H
+#define _HOST_ESP_PARTITION_H
+
+#include <esp_system.h>
+
+typedef enum { ESP_PARTITION_TYPE_APP = 0, ESP_PARTITION_TYPE_DATA = 1 } esp_partition_type_t;
+typedef int esp_partition_subtype_t;
+typedef enum { SPI_FLASH_MMAP_DATA = 0 } spi_flash_mmap_memory_t;
+typedef uint32_t spi_flash_mmap_handle_t;
+
+typedef struct {
+    esp_partition_type_t type;
+    esp_partition_subtype_t subtype;
+    uint32_t address;
+    uint32_t size;
+    char label[17];
+} esp_partition_t;
+
+static inline const esp_partition_t *esp_partition_find_first(esp_partition_type_t, esp_partition_subtype_t, const char *)
+{
+    return NULL;
+}
+
+static inline esp_err_t esp_partition_mmap(const esp_partition_t *, size_t, size_t, spi_flash_mmap_memory_t, const void **, spi_flash_mmap_handle_t *)
+{
+    return ESP_FAIL;
+}
+
+#endif
@@ -0,0 +1,31 @@
+/*
+ * Host build: ESP-IDF types and calls
+ */
+
+#ifndef _HOST_ESP_SYSTEM_H
+#define _HOST_ESP_SYSTEM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef int esp_err_t;
+
+#define ESP_OK                  0
+#define ESP_FAIL                -1
+#define ESP_ERR_INVALID_STATE   0x103
+
+#define ESP_IDF_VERSION_VAL(a, b, c)    (((a) << 16) | ((b) << 8) | (c))
+#define ESP_IDF_VERSION_MAJOR   4
+#define ESP_IDF_VERSION         ESP_IDF_VERSION_VAL(4, 4, 0)
+#define CONFIG_IDF_TARGET_ESP32 1
+
+typedef struct { int model; uint32_t features; uint16_t revision; uint8_t cores; } esp_chip_info_t;
+
+static inline void esp_chip_info(esp_chip_info_t *i) { i->model = 1; i->features = 0; i->revision = 3; i->cores = 2; }
+
+#ifdef __cplusplus
+extern "C"
+#endif
+void esp_restart(void) __attribute__((noreturn));
+
+#endif
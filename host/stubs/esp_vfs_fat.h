@@ -0,0 +1,16 @@
+/*
+ * Host build: No VFS
+ */
+
+#ifndef _HOST_ESP_VFS_FAT_H
+#define _HOST_ESP_VFS_FAT_H
+
+static inline esp_err_t esp_vfs_fat_register(const char *, const char *, size_t, FATFS **f) 
+{ 
+    static FATFS fs;
+    *f = &fs;
+    return ESP_OK;
+}
+static inline esp_err_t esp_vfs_fat_unregister_path(const char *) { return ESP_OK; }
+
+#endif
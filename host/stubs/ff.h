@@ -0,0 +1,28 @@
+/*
+ * Host build: FatFs types; mount and mkfs do nothing
+ */
+
+#ifndef _HOST_FF_H
+#define _HOST_FF_H
+
+#include <stdint.h>
+
+typedef uint8_t  BYTE;
+typedef uint16_t WORD;
+typedef uint32_t DWORD;
+typedef uint64_t QWORD;
+typedef unsigned UINT;
+typedef DWORD    LBA_t;
+
+typedef struct { int dummy; } FATFS;
+typedef int FRESULT;
+
+#define FR_OK       0
+#define FF_VOLUMES  2
+#define FF_MAX_SS   512
+#define FM_ANY      7
+
+static inline FRESULT f_mount(FATFS *, const char *, BYTE) { return FR_OK; }
+static inline FRESULT f_mkfs(const char *, BYTE, DWORD, void *, UINT) { return FR_OK; }
+
+#endif
@@ -0,0 +1,45 @@
+/*
+ * Host build: SD and LittleFS on directories of the host
+ *
+ * SDFS replaces src/SD/SD.cpp; the card is present if hostSDRoot
+ * is set when SD.begin() is called.
+ */
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include "src/SD/SD.h"
+
+const char *hostSDRoot = NULL;
+const char *hostFlashRoot = ".";
+
+fs::LittleFSFS LittleFS;
+
+SDFS::SDFS(FSImplPtr impl) : FS(impl), _pdrv(0xff) {}
+
+bool SDFS::begin(uint8_t ssPin, SPIClass &spi, uint32_t frequency, const char *mountpoint, uint8_t max_files, bool format_if_empty)
+{
+    if(!hostSDRoot) return false;
+    host_setRoot(hostSDRoot);
+    _pdrv = 0;
+    return true;
+}
+
+void SDFS::end()
+{
+    _pdrv = 0xff;
+}
+
+sdcard_type_t SDFS::cardType()
+{
+    return (_pdrv == 0xff) ? CARD_NONE : CARD_SDHC;
+}
+
+uint64_t SDFS::cardSize()    { return (_pdrv == 0xff) ? 0 : 8ULL << 30; }
+size_t   SDFS::numSectors()  { return cardSize() / 512; }
+size_t   SDFS::sectorSize()  { return 512; }
+uint64_t SDFS::totalBytes()  { return cardSize(); }
+uint64_t SDFS::usedBytes()   { return 0; }
+bool     SDFS::readRAW(uint8_t *buffer, uint32_t sector)  { return false; }
+bool     SDFS::writeRAW(uint8_t *buffer, uint32_t sector) { return false; }
+
+SDFS SD = SDFS(FSImplPtr(new FSImpl(".")));
@@ -0,0 +1,110 @@
+/*
+ * Host build: Definitions for the stubs
+ */
+
+#include <Arduino.h>
+
+uint64_t   hostMicros = 0;
+HostSerial Serial;
+HostESP    ESP;
+
+// A reboot ends the run; tests that expect one catch the exit
+void esp_restart()
+{
+    fflush(stdout);
+    fprintf(stderr, "esp_restart()\n");
+    exit(3);
+}
+
+size_t HostSerial::write(uint8_t c)
+{
+    return fputc(c, stdout) == EOF ? 0 : 1;
+}
+
+int Print::printf(const char *fmt, ...)
+{
+    char buf[512];
+    va_list ap;
+
+    va_start(ap, fmt);
+    int len = vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+
+    print(buf);
+
+    return len;
+}
+
+// GPIO, SPI, FatFs driver registry
+
+#include <SPI.h>
+extern "C" {
+    #include <ff.h>
+    #include <diskio.h>
+    #include <diskio_impl.h>
+}
+
+void    (*hostPinWrite)(int pin, int val) = NULL;
+uint8_t hostPinLevel[NUM_DIGITAL_PINS];
+
+static struct {
+    void (*isr)(void *);
+    void *arg;
+    int   mode;
+} pinIsr[NUM_DIGITAL_PINS];
+
+static struct PinInit {
+    PinInit() { memset(hostPinLevel, HIGH, sizeof(hostPinLevel)); }
+} pinInit;
+
+void attachInterruptArg(int pin, void (*isr)(void *), void *arg, int mode)
+{
+    if(pin < 0 || pin >= NUM_DIGITAL_PINS) return;
+    pinIsr[pin].isr = isr;
+    pinIsr[pin].arg = arg;
+    pinIsr[pin].mode = mode;
+}
+
+void detachInterrupt(int pin)
+{
+    if(pin >= 0 && pin < NUM_DIGITAL_PINS) pinIsr[pin].isr = NULL;
+}
+
+// Runs the interrupt in the caller's context
+void host_setPin(int pin, int val)
+{
+    int old;
+
+    if(pin < 0 || pin >= NUM_DIGITAL_PINS) return;
+    old = hostPinLevel[pin];
+    hostPinLevel[pin] = val ? HIGH : LOW;
+    if(old == hostPinLevel[pin] || !pinIsr[pin].isr) return;
+
+    switch(pinIsr[pin].mode) {
+    case RISING:  if(!val) return; break;
+    case FALLING: if(val) return; break;
+    }
+    pinIsr[pin].isr(pinIsr[pin].arg);
+}
+
+uint8_t (*hostSpiXfer)(uint8_t out) = NULL;
+void    (*hostSpiClock)(uint32_t hz) = NULL;
+SPIClass SPI;
+
+const ff_diskio_impl_t *hostDiskio[FF_VOLUMES];
+
+void ff_diskio_register(BYTE pdrv, const ff_diskio_impl_t *impl)
+{
+    if(pdrv < FF_VOLUMES) hostDiskio[pdrv] = impl;
+}
+
+esp_err_t ff_diskio_get_drive(BYTE *out_pdrv)
+{
+    for(BYTE i = 0; i < FF_VOLUMES; i++) {
+        if(!hostDiskio[i]) {
+            *out_pdrv = i;
+            return ESP_OK;
+        }
+    }
+    return ESP_FAIL;
+}
@@ -0,0 +1,83 @@
+/*
+ * Host build: I2S driver on the virtual clock
+ */
+
+#include <Arduino.h>
+#include "driver/i2s.h"
+
+HostI2S hostI2S;
+void (*hostI2SOut)(const int16_t *lr, size_t frames, double startUs) = NULL;
+
+esp_err_t i2s_driver_install(i2s_port_t port, const i2s_config_t *cfg, int qsize, void *q)
+{
+    if(port || hostI2S.on) return ESP_FAIL;
+
+    hostI2S.on = true;
+    hostI2S.rate = cfg->sample_rate;
+    hostI2S.frames = cfg->dma_buf_count * cfg->dma_buf_len;
+    hostI2S.endUs = hostMicros;
+
+    return ESP_OK;
+}
+
+esp_err_t i2s_driver_uninstall(i2s_port_t port)
+{
+    hostI2S.on = false;
+    return ESP_OK;
+}
+
+esp_err_t i2s_set_pin(i2s_port_t, const i2s_pin_config_t *) { return ESP_OK; }
+esp_err_t i2s_set_dac_mode(i2s_dac_mode_t) { return ESP_OK; }
+
+esp_err_t i2s_set_sample_rates(i2s_port_t port, uint32_t rate)
+{
+    hostI2S.rate = rate;
+    return ESP_OK;
+}
+
+esp_err_t i2s_zero_dma_buffer(i2s_port_t port)
+{
+    if(hostI2S.endUs > hostMicros) hostI2S.cutUs += hostI2S.endUs - hostMicros;
+    hostI2S.endUs = hostMicros;
+    return ESP_OK;
+}
+
+esp_err_t i2s_write(i2s_port_t port, const void *src, size_t size, size_t *written, TickType_t ticks)
+{
+    const int16_t *p = (const int16_t *)src;
+    size_t want = size / 4, done = 0;
+    double perFrame;
+    uint64_t until;
+
+    *written = 0;
+    if(!hostI2S.on || !hostI2S.rate) return ESP_FAIL;
+
+    perFrame = 1e6 / hostI2S.rate;
+    until = (ticks == portMAX_DELAY) ? UINT64_MAX : hostMicros + ticks * 1000ULL;
+
+    for(;;) {
+        double now = hostMicros;
+        if(hostI2S.endUs < now) {
+            if(hostI2S.written) {
+                hostI2S.underruns++;
+                hostI2S.underrunUs += now - hostI2S.endUs;
+            }
+            hostI2S.endUs = now;
+        }
+        double queued = (hostI2S.endUs - now) / perFrame;
+        size_t room = (queued >= hostI2S.frames) ? 0 : (size_t)(hostI2S.frames - queued);
+        size_t n = want - done < room ? want - done : room;
+        if(n) {
+            if(hostI2SOut) hostI2SOut(p + 2 * done, n, hostI2S.endUs);
+            hostI2S.endUs += n * perFrame;
+            hostI2S.written += n;
+            done += n;
+        }
+        if(done == want || hostMicros >= until) break;
+        // Wait until a DMA buffer's worth has played
+        delayMicroseconds(1 + (unsigned)(perFrame * (want - done < 64 ? want - done : 64)));
+    }
+
+    *written = done * 4;
+    return ESP_OK;
+}
@@ -0,0 +1,88 @@
+/*
+ * Host build: lwIP raw sockets, as used by mqtt.cpp's ping
+ *
+ * There is no IP stack on the fake network; socket() fails.
+ * The other lwip/ headers include this one.
+ */
+
+#ifndef _HOST_LWIP_SOCKETS_H
+#define _HOST_LWIP_SOCKETS_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <sys/time.h>
+
+#define AF_INET         2
+#define SOCK_RAW        3
+#define SOL_SOCKET      0xfff
+#define SO_RCVTIMEO     0x1006
+#define IP_PROTO_ICMP   1
+#define ICMP_ECHO       8
+#define ICMP_ER         0
+
+typedef int8_t   err_t;
+typedef size_t   mem_size_t;
+#ifndef __socklen_t_defined
+typedef uint32_t socklen_t;
+#define __socklen_t_defined
+#endif
+
+typedef struct { uint32_t addr; } ip4_addr_t;
+struct in_addr { uint32_t s_addr; };
+struct sockaddr { uint8_t sa_len; uint8_t sa_family; char sa_data[14]; };
+struct sockaddr_in {
+    uint8_t  sin_len;
+    uint8_t  sin_family;
+    uint16_t sin_port;
+    struct in_addr sin_addr;
+    char     sin_zero[8];
+};
+
+struct ip_hdr {
+    uint8_t  _v_hl, _tos;
+    uint16_t _len, _id, _offset;
+    uint8_t  _ttl, _proto;
+    uint16_t _chksum;
+    uint32_t src, dest;
+};
+#define IPH_HL(h)   ((h)->_v_hl & 0x0f)
+
+struct icmp_echo_hdr {
+    uint8_t  type, code;
+    uint16_t chksum, id, seqno;
+};
+#define ICMPH_TYPE_SET(h, t)    ((h)->type = (t))
+#define ICMPH_CODE_SET(h, c)    ((h)->code = (c))
+
+#define inet_addr_from_ip4addr(a, i)    ((a)->s_addr = (i)->addr)
+
+static inline uint16_t lwip_htons(uint16_t x) { return (x << 8) | (x >> 8); }
+#define htons(x)    lwip_htons(x)
+#define ntohs(x)    lwip_htons(x)
+
+static inline void *mem_malloc(mem_size_t s) { return malloc(s); }
+static inline void  mem_free(void *p) { free(p); }
+
+static inline uint16_t inet_chksum(const void *p, uint16_t len)
+{
+    const uint8_t *b = (const uint8_t *)p;
+    uint32_t a = 0;
+    for(int i = 0; i + 1 < len; i += 2) a += b[i] | (b[i+1] << 8);
+    if(len & 1) a += b[len-1];
+    while(a >> 16) a = (a & 0xffff) + (a >> 16);
+    return ~a;
+}
+
+static inline int lwip_socket(int, int, int) { return -1; }
+static inline int lwip_setsockopt(int, int, int, const void *, socklen_t) { return -1; }
+static inline int lwip_sendto(int, const void *, size_t, int, const struct sockaddr *, socklen_t) { return -1; }
+static inline int lwip_recvfrom(int, void *, size_t, int, struct sockaddr *, socklen_t *) { return -1; }
+static inline int lwip_close(int) { return -1; }
+
+#define socket      lwip_socket
+#define setsockopt  lwip_setsockopt
+#define sendto      lwip_sendto
+#define recvfrom    lwip_recvfrom
+#define closesocket lwip_close
+
+#endif
@@ -0,0 +1,126 @@
+/*
+ * Host build: Fake network
+ *
+ * One host (the device, hostIP) and whatever the test attaches
+ * to hostUdpSend. No latency or loss; a test that wants them
+ * delays or drops in its own hook.
+ */
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <AsyncUDP.h>
+#include <algorithm>
+
+IPAddress   hostIP(192, 168, 4, 2);
+wl_status_t hostWiFiStatus = WL_CONNECTED;
+HostWiFi    WiFi;
+
+void (*hostUdpSend)(IPAddress to, uint16_t port, uint16_t fromPort, const uint8_t *data, size_t len) = NULL;
+
+// Never destroyed: static sockets unregister after main()
+static std::vector<WiFiUDP *>  &socks = *new std::vector<WiFiUDP *>;
+static std::vector<AsyncUDP *> &asocks = *new std::vector<AsyncUDP *>;
+
+void host_udpDeliver(IPAddress from, uint16_t fromPort, IPAddress to, uint16_t port, const uint8_t *data, size_t len)
+{
+    bool mc = to.isMulticast();
+
+    if(!mc && to != hostIP) return;
+
+    for(WiFiUDP *s : socks) {
+        if(s->_port == port && (mc ? s->_group == to : !s->_group)) {
+            s->_q.push_back({ from, fromPort, std::vector<uint8_t>(data, data + len) });
+        }
+    }
+    for(AsyncUDP *s : asocks) {
+        if(s->_port == port && s->_group == to && s->_cb) {
+            AsyncUDPPacket p(from, fromPort, data, len);
+            s->_cb(s->_arg, p);
+        }
+    }
+}
+
+// WiFiUDP
+
+uint8_t WiFiUDP::begin(uint16_t port)
+{
+    stop();
+    _port = port;
+    socks.push_back(this);
+    return 1;
+}
+
+uint8_t WiFiUDP::beginMulticast(IPAddress ip, uint16_t port)
+{
+    begin(port);
+    _group = ip;
+    return 1;
+}
+
+void WiFiUDP::stop()
+{
+    socks.erase(std::remove(socks.begin(), socks.end(), this), socks.end());
+    _port = 0;
+    _group = IPAddress();
+    _q.clear();
+}
+
+int WiFiUDP::beginPacket(IPAddress ip, uint16_t port)
+{
+    _txTo = ip;
+    _txPort = port;
+    _tx.clear();
+    return 1;
+}
+
+size_t WiFiUDP::write(const uint8_t *buf, size_t len)
+{
+    _tx.insert(_tx.end(), buf, buf + len);
+    return len;
+}
+
+int WiFiUDP::endPacket()
+{
+    if(hostWiFiStatus != WL_CONNECTED) return 0;
+    if(hostUdpSend) hostUdpSend(_txTo, _txPort, _port, _tx.data(), _tx.size());
+    return 1;
+}
+
+int WiFiUDP::parsePacket()
+{
+    _rx.clear();
+    _rxPos = 0;
+    if(_q.empty()) return 0;
+
+    _rx = _q.front().data;
+    _rxFrom = _q.front().from;
+    _rxFromPort = _q.front().fromPort;
+    _q.pop_front();
+
+    return _rx.size();
+}
+
+int WiFiUDP::read(uint8_t *buf, size_t len)
+{
+    len = std::min(len, _rx.size() - _rxPos);
+    memcpy(buf, _rx.data() + _rxPos, len);
+    _rxPos += len;
+    return len;
+}
+
+// AsyncUDP
+
+bool AsyncUDP::listenMulticast(const IPAddress addr, uint16_t port)
+{
+    close();
+    _group = addr;
+    _port = port;
+    asocks.push_back(this);
+    return true;
+}
+
+void AsyncUDP::close()
+{
+    asocks.erase(std::remove(asocks.begin(), asocks.end(), this), asocks.end());
+    _port = 0;
+}
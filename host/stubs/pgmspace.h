@@ -0,0 +1,19 @@
+/*
+ * Host build: Flash is plain memory
+ */
+
+#ifndef _HOST_PGMSPACE_H
+#define _HOST_PGMSPACE_H
+
+#include <stdint.h>
+#include <string.h>
+
+#define PROGMEM
+#define PGM_P               const char *
+#define PSTR(x)             (x)
+#define pgm_read_byte(a)    (*(const uint8_t *)(a))
+#define pgm_read_word(a)    (*(const uint16_t *)(a))
+#define pgm_read_dword(a)   (*(const uint32_t *)(a))
+#define memcpy_P            memcpy
+
+#endif
@@ -0,0 +1,112 @@
+/*
+ * Host build: Stand-in for remote_settings.cpp
+ *
+ * The real module needs ArduinoJson and Update. Here, settings
+ * are the compiled-in defaults (a test may change them before
+ * setup()), nothing is read from or written to the file systems,
+ * and no sound-pack is installed. Flash FS is mounted at
+ * hostFlashRoot, SD at hostSDRoot (if set). Audio files count as
+ * installed if the flash FS (or SD in Flash-RO mode) has /VER.
+ */
+
+#include "remote_global.h"
+#include <LittleFS.h>
+#include "src/SD/SD.h"
+#include "remote_main.h"
+#include "remote_settings.h"
+#include "remote_audio.h"
+#include "remote_wifi.h"
+
+Settings   settings;
+IPSettings ipsettings;
+
+bool haveFS = false;
+bool haveSD = false;
+bool FlashROMode = false;
+bool haveAudioFiles = false;
+uint8_t musFolderNum = 0;
+
+const char rspv[] = "RM12";
+
+void settings_setup()
+{
+    haveNewBoard = false;
+
+    haveFS = LittleFS.begin();
+
+    if((haveSD = SD.begin(SD_CS_PIN, SPI, 16000000))) {
+        haveSD = (SD.cardType() != CARD_NONE);
+    }
+    if(haveSD && (SD.exists("/REM_FLASH_RO") || !haveFS)) {
+        FlashROMode = true;
+    }
+
+    haveAudioFiles = FlashROMode ? SD.exists("/VER") : LittleFS.exists("/VER");
+
+    myRemID = 0x5eed1234;
+}
+
+void unmount_fs()
+{
+    if(haveFS) {
+        LittleFS.end();
+        haveFS = false;
+    }
+    if(haveSD) {
+        SD.end();
+        haveSD = false;
+        #if defined(REMOTE_SND_NEGCACHE) || defined(REMOTE_SND_CACHE)
+        audio_flushLookups();
+        #endif
+    }
+}
+
+bool evalBool(char *s)
+{
+    return *s != '0';
+}
+
+void write_settings() {}
+bool checkConfigExists() { return false; }
+#ifdef REMOTE_HAVEMQTT
+void write_mqtt_settings() {}
+#endif
+
+// Secondary and tertiary settings: None saved, so loads keep
+// the defaults
+void loadCalib() {}
+void saveCalib() {}
+void loadBrightness() {}
+void storeBrightness() {}
+void saveBrightness() {}
+void loadCurVolume() {}
+void storeCurVolume() {}
+void saveCurVolume() {}
+void loadMovieMode() {}
+void saveMovieMode() {}
+void loadDisplayGPSMode() {}
+void saveDisplayGPSMode() {}
+void saveUpdAvail() {}
+void loadUpdVers(int &v, int &r) { v = r = 0; }
+void saveUpdVers(int v, int r) {}
+void saveAllSecCP() {}
+void saveCarMode() {}
+bool loadVis() { return false; }
+void storeVis() {}
+void saveVis() {}
+void loadMusFoldNum() {}
+void saveMusFoldNum() {}
+void loadShuffle() {}
+void saveShuffle() {}
+void saveAllTerCP() {}
+bool loadIpSettings() { return false; }
+void writeIpSettings() {}
+void deleteIpSettings() {}
+
+// Sound-pack installer: Never offered
+bool check_if_default_audio_present() { return false; }
+bool prepareCopyAudioFiles() { return false; }
+void doCopyAudioFiles() { esp_restart(); }
+bool check_allow_CPA() { return false; }
+void delete_ID_file() {}
+void moveSettings() {}
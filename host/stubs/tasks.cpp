@@ -0,0 +1,317 @@
+/*
+ * Host build: FreeRTOS tasks
+ *
+ * HOST_TASKS_OFF (default): No task is started (see Arduino.h).
+ *
+ * HOST_TASKS_COOP: Tasks are coroutines on the virtual clock. A
+ * task runs until it blocks (delay, yield, vTaskDelay, notify
+ * take, taken mutex); then the next ready task runs, and if none
+ * is ready, the clock jumps to the earliest wake-up. Code between
+ * two blocking calls takes no virtual time, as on an infinitely
+ * fast CPU, and runs are deterministic.
+ *
+ * HOST_TASKS_THREADS: Tasks are pthreads, for code that must work
+ * under real concurrency. Blocking calls yield the CPU and move
+ * the clock; notifications, mutexes and critical sections are
+ * real.
+ */
+
+#include <Arduino.h>
+#include <pthread.h>
+#include <sched.h>
+#include <ucontext.h>
+#include <vector>
+
+int hostTasks = HOST_TASKS_OFF;
+
+#define STACK_SIZE  (256 * 1024)
+#define FOREVER     UINT64_MAX
+
+struct HostTask {
+    const char *name;
+    void      (*fn)(void *);
+    void       *arg;
+    bool        dead;
+    // COOP
+    ucontext_t  ctx;
+    char       *stack;
+    uint64_t    wakeAt;
+    bool        waitNotify;
+    // THREADS
+    pthread_t       thr;
+    pthread_mutex_t m;
+    pthread_cond_t  c;
+    uint32_t    notify;
+};
+
+static HostTask mainTask = { "main" };
+static std::vector<HostTask *> tasks = { &mainTask };
+static size_t cur = 0;
+static thread_local HostTask *self = &mainTask;
+static pthread_mutex_t critMux;
+static pthread_once_t  threadsOnce = PTHREAD_ONCE_INIT;
+
+// COOP
+
+static bool ready(const HostTask *t)
+{
+    if(t->dead) return false;
+    if(t->waitNotify && t->notify) return true;
+    return t->wakeAt <= hostMicros;
+}
+
+static void schedule()
+{
+    size_t n = tasks.size(), next;
+
+    for(;;) {
+        uint64_t w = FOREVER;
+        for(size_t i = 1; i <= n; i++) {
+            next = (cur + i) % n;
+            if(ready(tasks[next])) goto found;
+        }
+        for(HostTask *t : tasks) {
+            if(!t->dead && t->wakeAt < w) w = t->wakeAt;
+        }
+        if(w == FOREVER) {
+            fprintf(stderr, "host tasks: all tasks blocked forever\n");
+            abort();
+        }
+        hostMicros = w;
+    }
+
+found:
+    if(next != cur) {
+        HostTask *from = tasks[cur];
+        cur = next;
+        self = tasks[next];
+        swapcontext(&from->ctx, &tasks[next]->ctx);
+    }
+}
+
+static void block(uint64_t until, bool notify)
+{
+    HostTask *t = tasks[cur];
+
+    t->wakeAt = until;
+    t->waitNotify = notify;
+    schedule();
+    t->waitNotify = false;
+    t->wakeAt = 0;
+}
+
+static void coopEntry()
+{
+    HostTask *t = tasks[cur];
+
+    t->fn(t->arg);
+    // A FreeRTOS task must not return; treat it as deleted
+    t->dead = true;
+    schedule();
+}
+
+// THREADS
+
+static void initSync(HostTask *t)
+{
+    pthread_mutex_init(&t->m, NULL);
+    pthread_cond_init(&t->c, NULL);
+}
+
+static void threadsInit()
+{
+    pthread_mutexattr_t a;
+
+    initSync(&mainTask);
+
+    pthread_mutexattr_init(&a);
+    pthread_mutexattr_settype(&a, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&critMux, &a);
+}
+
+static void *threadEntry(void *p)
+{
+    HostTask *t = (HostTask *)p;
+
+    self = t;
+    t->fn(t->arg);
+    t->dead = true;
+    return NULL;
+}
+
+// API
+
+void host_sleep(uint64_t us)
+{
+    if(hostTasks == HOST_TASKS_COOP) {
+        block(hostMicros + us, false);
+    } else if(hostTasks == HOST_TASKS_THREADS) {
+        __atomic_fetch_add(&hostMicros, us, __ATOMIC_RELAXED);
+        sched_yield();
+    } else {
+        hostMicros += us;
+    }
+}
+
+int xTaskCreatePinnedToCore(void (*fn)(void *), const char *name, int, void *arg, int, TaskHandle_t *h, int)
+{
+    HostTask *t;
+
+    if(hostTasks == HOST_TASKS_OFF) {
+        if(h) *h = (TaskHandle_t)1;
+        return pdPASS;
+    }
+
+    t = new HostTask();
+    t->name = name;
+    t->fn = fn;
+    t->arg = arg;
+
+    if(hostTasks == HOST_TASKS_COOP) {
+        t->stack = (char *)malloc(STACK_SIZE);
+        getcontext(&t->ctx);
+        t->ctx.uc_stack.ss_sp = t->stack;
+        t->ctx.uc_stack.ss_size = STACK_SIZE;
+        t->ctx.uc_link = NULL;
+        makecontext(&t->ctx, coopEntry, 0);
+        t->wakeAt = hostMicros;
+        tasks.push_back(t);
+    } else {
+        pthread_once(&threadsOnce, threadsInit);
+        initSync(t);
+        tasks.push_back(t);
+        if(pthread_create(&t->thr, NULL, threadEntry, t)) {
+            tasks.pop_back();
+            delete t;
+            return pdFALSE;
+        }
+    }
+
+    if(h) *h = (TaskHandle_t)t;
+    return pdPASS;
+}
+
+void vTaskDelayUntil(TickType_t *last, TickType_t inc)
+{
+    TickType_t due = *last + inc;
+
+    if((int32_t)(due - xTaskGetTickCount()) > 0) {
+        delay(due - xTaskGetTickCount());
+    }
+    *last = due;
+}
+
+void xTaskNotifyGive(TaskHandle_t h)
+{
+    HostTask *t = (HostTask *)h;
+
+    if(hostTasks == HOST_TASKS_OFF || !t) return;
+
+    if(hostTasks == HOST_TASKS_THREADS) {
+        pthread_mutex_lock(&t->m);
+        t->notify++;
+        pthread_cond_signal(&t->c);
+        pthread_mutex_unlock(&t->m);
+    } else {
+        t->notify++;
+    }
+}
+
+uint32_t ulTaskNotifyTake(int clear, TickType_t ticks)
+{
+    HostTask *t = self;
+    uint32_t r;
+
+    if(hostTasks == HOST_TASKS_OFF) return 0;
+
+    if(hostTasks == HOST_TASKS_COOP) {
+        if(!t->notify && ticks) {
+            block(ticks == portMAX_DELAY ? FOREVER : hostMicros + ticks * 1000ULL, true);
+        }
+    } else {
+        pthread_mutex_lock(&t->m);
+        if(!t->notify && ticks) {
+            if(ticks == portMAX_DELAY) {
+                while(!t->notify) pthread_cond_wait(&t->c, &t->m);
+            } else {
+                struct timespec ts;
+                clock_gettime(CLOCK_REALTIME, &ts);
+                ts.tv_nsec += (ticks % 1000) * 1000000L;
+                ts.tv_sec += ticks / 1000 + ts.tv_nsec / 1000000000L;
+                ts.tv_nsec %= 1000000000L;
+                pthread_cond_timedwait(&t->c, &t->m, &ts);
+                if(!t->notify) __atomic_fetch_add(&hostMicros, ticks * 1000ULL, __ATOMIC_RELAXED);
+            }
+        }
+    }
+
+    r = t->notify;
+    if(r) t->notify = clear ? 0 : r - 1;
+
+    if(hostTasks == HOST_TASKS_THREADS) pthread_mutex_unlock(&t->m);
+
+    return r;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle()
+{
+    return (TaskHandle_t)self;
+}
+
+struct HostMutex {
+    pthread_mutex_t m;
+    bool held;
+};
+
+SemaphoreHandle_t xSemaphoreCreateMutex()
+{
+    HostMutex *m = new HostMutex();
+
+    pthread_mutex_init(&m->m, NULL);
+    return (SemaphoreHandle_t)m;
+}
+
+int xSemaphoreTake(SemaphoreHandle_t s, TickType_t ticks)
+{
+    HostMutex *m = (HostMutex *)s;
+
+    switch(hostTasks) {
+    case HOST_TASKS_COOP: {
+        uint64_t until = (ticks == portMAX_DELAY) ? FOREVER : hostMicros + ticks * 1000ULL;
+        while(m->held) {
+            if(hostMicros >= until) return pdFALSE;
+            host_sleep(1);
+        }
+        break;
+        }
+    case HOST_TASKS_THREADS:
+        if(ticks == portMAX_DELAY) {
+            pthread_mutex_lock(&m->m);
+        } else if(pthread_mutex_trylock(&m->m)) {
+            return pdFALSE;
+        }
+        break;
+    }
+    m->held = true;
+
+    return pdTRUE;
+}
+
+int xSemaphoreGive(SemaphoreHandle_t s)
+{
+    HostMutex *m = (HostMutex *)s;
+
+    m->held = false;
+    if(hostTasks == HOST_TASKS_THREADS) pthread_mutex_unlock(&m->m);
+
+    return pdTRUE;
+}
+
+void host_critical(bool enter)
+{
+    if(hostTasks != HOST_TASKS_THREADS) return;
+
+    pthread_once(&threadsOnce, threadsInit);
+    if(enter) pthread_mutex_lock(&critMux);
+    else      pthread_mutex_unlock(&critMux);
+}
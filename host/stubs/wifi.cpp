@@ -0,0 +1,93 @@
+/*
+ * Host build: Stand-in for remote_wifi.cpp
+ *
+ * The real module needs WiFiManager. Here, the station is up as
+ * soon as hostWiFiStatus says so (see net.cpp); there is no AP
+ * and no config portal. The MQTT client runs on WiFiClient,
+ * which never connects.
+ */
+
+#include "remote_global.h"
+#include <WiFi.h>
+#include "remote_settings.h"
+#include "remote_wifi.h"
+#ifdef REMOTE_HAVEMQTT
+#include "mqtt.h"
+#endif
+
+bool wifiSetupDone = false;
+bool wifiIsOff = false;
+bool wifiAPIsOff = false;
+bool wifiInAPMode = false;
+bool carMode = false;
+
+#ifdef REMOTE_HAVEMQTT
+bool useMQTT = false;
+#ifdef REMOTE_HAVEMQTT_MP
+bool pubMP = false;
+#endif
+
+static WiFiClient   mqttWClient;
+static PubSubClient mqttClient(mqttWClient);
+#endif
+
+void wifi_setup()
+{
+    #ifdef REMOTE_HAVEMQTT
+    if((useMQTT = evalBool(settings.useMQTT))) {
+        mqttClient.setServer(settings.mqttServer, 1883);
+        mqttClient.setClientID(settings.hostName);
+    }
+    #endif
+
+    wifiSetupDone = true;
+}
+
+void wifi_loop()
+{
+    #ifdef REMOTE_HAVEMQTT
+    if(useMQTT) {
+        if(mqttClient.connected()) {
+            mqttClient.loop();
+        }
+    }
+    #endif
+}
+
+void wifiOn(unsigned long newDelay) {}
+bool wifiNeedReConnect(bool &blocks) { blocks = false; return false; }
+void wifiStartCP() {}
+bool updateAvailable() { return false; }
+
+void updateConfigPortalVisValues() {}
+void updateConfigPortalVis2Values() {}
+void updateConfigPortalUpdValues() {}
+
+bool wifi_getIP(uint8_t &a, uint8_t &b, uint8_t &c, uint8_t &d)
+{
+    IPAddress ip = WiFi.localIP();
+
+    a = ip[0]; b = ip[1]; c = ip[2]; d = ip[3];
+    return true;
+}
+
+bool isIp(char *str)
+{
+    IPAddress ip;
+
+    return ip.fromString(str);
+}
+
+bool checkIPConfig() { return false; }
+
+#ifdef REMOTE_HAVEMQTT
+bool mqttConnected()
+{
+    return useMQTT && mqttClient.connected();
+}
+
+bool mqttPublish(const char *topic, const char *pl, unsigned int len)
+{
+    return mqttConnected() && mqttClient.publish(topic, (const uint8_t *)pl, len);
+}
+#endif
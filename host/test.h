@@ -0,0 +1,27 @@
+/*
+ * Host build: Checks for test_*
+ */
+
+#ifndef _HOST_TEST_H
+#define _HOST_TEST_H
+
+#include <stdio.h>
+
+static int testFails = 0;
+static int testChecks = 0;
+
+#define CHECK(c) do {                                                   \
+        testChecks++;                                                   \
+        if(!(c)) {                                                      \
+            testFails++;                                                \
+            printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #c); \
+        }                                                               \
+    } while(0)
+
+static int testResult(const char *name)
+{
+    printf("%s: %d checks, %d failed\n", name, testChecks, testFails);
+    return testFails ? 1 : 0;
+}
+
+#endif
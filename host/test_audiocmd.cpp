@@ -0,0 +1,189 @@
+/*
+ * Audio engine: Command queue under real concurrency
+ *
+ * The engine runs as a pthread (HOST_TASKS_THREADS), and a second
+ * thread plays the main loop's part: It posts commands through
+ * play_file() and stopAudio() and waits for the engine's
+ * acknowledgements. Every sound is a WAV on the fake SD holding a
+ * constant sample value of its own, so the I2S output shows which
+ * sounds played, in what order, and how much of each.
+ *
+ * Checked: sounds come out in the order posted, none comes out
+ * twice, and a full queue makes the poster wait rather than drop
+ * commands. A sound counts as done only when the generator has
+ * passed on all of it. stopAudio() returns only after the engine
+ * has executed the stop.
+ */
+
+#include <Arduino.h>
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <vector>
+#include <pthread.h>
+#include "driver/i2s.h"
+#include "test.h"
+
+#include "remote_global.h"
+#include "remote_audio.h"
+#include "remote_settings.h"
+
+#define BURST   200             // Posted back to back
+#define SHORT   300             // frames
+#define LONG    44100
+#define VAL(k)  (100 * ((k) + 1))
+
+static const int longSnd = BURST + 20;
+
+static std::mutex outMux;
+static std::vector<int> order;  // Sound index of each run of output
+static std::vector<uint32_t> frames(BURST + 32);
+static uint32_t foreign;        // Frames matching no sound
+
+static void onOutput(const int16_t *lr, size_t n, double)
+{
+    std::lock_guard<std::mutex> l(outMux);
+
+    for(size_t i = 0; i < n; i++) {
+        int v = lr[2*i];
+        if(!v) continue;
+        if(v % 100 || lr[2*i+1] != v || v / 100 > (int)frames.size()) {
+            foreign++;
+            continue;
+        }
+        int k = v / 100 - 1;
+        if(order.empty() || order.back() != k) order.push_back(k);
+        frames[k]++;
+    }
+}
+
+static uint32_t played(int k)
+{
+    std::lock_guard<std::mutex> l(outMux);
+    return frames[k];
+}
+
+static void writeWav(const char *dir, int k, uint32_t n)
+{
+    char fn[256];
+    uint32_t len = n * 2;
+    uint32_t h[] = { 0x46464952, 36 + len, 0x45564157, 0x20746d66, 16,
+                     0x00010001, 44100, 44100 * 2, 0x00100002, 0x61746164, len };
+    std::vector<int16_t> s(n, VAL(k));
+
+    snprintf(fn, sizeof(fn), "%s/s%d.wav", dir, k);
+    FILE *f = fopen(fn, "wb");
+    fwrite(h, 1, 44, f);
+    fwrite(s.data(), 2, n, f);
+    fclose(f);
+}
+
+static void play(int k)
+{
+    char fn[16];
+
+    snprintf(fn, sizeof(fn), "/s%d.wav", k);
+    play_file(fn, PA_WAV|PA_ALLOWSD);
+}
+
+// Wait until cond is true; false after 2s of real time. delay()
+// moves the virtual clock but doesn't make the engine run, so
+// don't wait for a fixed virtual time.
+template<typename C> static bool waitFor(C cond)
+{
+    auto t0 = std::chrono::steady_clock::now();
+
+    while(!cond()) {
+        if(std::chrono::steady_clock::now() - t0 > std::chrono::seconds(2)) return false;
+        delay(1);
+    }
+    return true;
+}
+
+static bool done()
+{
+    return checkAudioReallyDone();
+}
+
+static void *control(void *)
+{
+    const int ack = BURST;
+    bool inOrder = true;
+
+    // Back to back: The queue (16 entries) overflows many times
+    // over; each play stops the previous sound
+    for(int k = 0; k < BURST; k++) {
+        play(k);
+    }
+    CHECK(waitFor(done));
+    CHECK(waitFor([] { return played(BURST - 1) == SHORT; }));
+
+    // Done means the generator has passed on all of the sound; 
+    // only what the mixer holds (256 frames) may still be due
+    for(int k = ack; k < ack + 20; k++) {
+        play(k);
+        CHECK(waitFor(done));
+        CHECK(played(k) + 256 >= SHORT);
+        CHECK(waitFor([k] { return played(k) == SHORT; }));
+    }
+
+    // stopAudio() waits for the engine: At most what the mixer
+    // holds comes out afterwards
+    play(longSnd);
+    CHECK(waitFor([] { return played(longSnd) > 1000; }));
+    CHECK(!done());
+    stopAudio();
+    uint32_t atStop = played(longSnd);
+    for(int i = 0; i < 300; i++) delay(1);
+    CHECK(played(longSnd) - atStop <= 256);
+    CHECK(played(longSnd) < LONG);
+
+    std::lock_guard<std::mutex> l(outMux);
+    for(size_t i = 1; i < order.size(); i++) {
+        if(order[i] <= order[i-1]) inOrder = false;
+    }
+    CHECK(inOrder);
+    CHECK(order.back() == longSnd);
+    CHECK(!foreign);
+    for(int k = 0; k < BURST - 1; k++) {
+        CHECK(frames[k] <= SHORT);
+    }
+    printf("%zu of %d back-to-back sounds were heard before the next one stopped them\n",
+            std::count_if(frames.begin(), frames.begin() + BURST, [](uint32_t f) { return f > 0; }),
+            BURST);
+
+    return NULL;
+}
+
+int main()
+{
+    char dir[] = "/tmp/test_audiocmd.XXXXXX";
+    pthread_t thr;
+
+    if(!mkdtemp(dir)) {
+        perror("mkdtemp");
+        return 1;
+    }
+    for(int k = 0; k < BURST + 20; k++) writeWav(dir, k, SHORT);
+    writeWav(dir, BURST + 20, LONG);
+
+    hostTasks = HOST_TASKS_THREADS;
+    hostSDRoot = dir;
+    hostI2SOut = onOutput;
+
+    settings_setup();
+    aud_state.curVolume = VOL_LEVELS - 1;   // Gain 1.0
+    audio_setup();
+
+    pthread_create(&thr, NULL, control, NULL);
+    pthread_join(thr, NULL);
+
+    for(int k = 0; k <= BURST + 20; k++) {
+        char fn[256];
+        snprintf(fn, sizeof(fn), "%s/s%d.wav", dir, k);
+        remove(fn);
+    }
+    rmdir(dir);
+
+    return testResult("audiocmd");
+}
@@ -0,0 +1,150 @@
+/*
+ * libmad: Fixed-point backends against each other
+ *
+ * Decodes synthetic streams (mp3gen.h) with libmad built for
+ *
+ *   mad64  FPM_64BIT, OPT_ACCURACY: the reference
+ *   madxa  FPM_XTENSA, OPT_ACCURACY: MULSH emulated in C, full
+ *          64-bit products through MAD_F_MLX
+ *   madx   FPM_XTENSA, OPT_SPEED: as on the ESP32; high words
+ *          only, D[] not pre-shifted, no SSO
+ *   (mad   FPM_DEFAULT, OPT_SPEED with SSO: the host's libhost)
+ *
+ * madxa must give the reference's PCM bit for bit. madx drops the
+ * low 4 bits of each product, so it may be off by an LSB now and
+ * then; it must stay well ahead of FPM_DEFAULT.
+ * The streams' global gain keeps the output below full scale;
+ * overflowing products wrap differently in each backend.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "src/ESP8266Audio/libmad/config.h"
+#include "src/ESP8266Audio/libmad/mad.h"
+#include "mp3gen.h"
+#include "test.h"
+
+#define NFR   (383 * 2)
+#define MAXPCM (NFR * 1152 * 2)
+
+struct out {
+  int16_t *pcm;
+  long n;
+};
+
+static enum mad_flow output(void *data, struct mad_header const *header, struct mad_pcm *pcm)
+{
+  struct out *o = data;
+
+  for (int i = 0; i < pcm->length; i++) {
+    for (int ch = 0; ch < pcm->channels; ch++)
+      o->pcm[o->n++] = pcm->samples[ch][i];
+  }
+  return MAD_FLOW_CONTINUE;
+}
+
+#define DECODER(p)                                                        \
+  void p##mad_stream_init(struct mad_stream *);                           \
+  void p##mad_stream_buffer(struct mad_stream *, unsigned char const *, unsigned long); \
+  void p##mad_frame_init(struct mad_frame *);                             \
+  int  p##mad_frame_decode(struct mad_frame *, struct mad_stream *);     \
+  void p##mad_synth_init(struct mad_synth *);                             \
+  enum mad_flow p##mad_synth_frame(struct mad_synth *, struct mad_frame const *, \
+                          enum mad_flow (*)(void *, struct mad_header const *, struct mad_pcm *), void *); \
+  static long decode_##p(unsigned char const *s, unsigned long len, int16_t *pcm) \
+  {                                                                       \
+    static struct mad_stream st;                                          \
+    static struct mad_frame fr;                                           \
+    static struct mad_synth sy;                                           \
+    struct out o = { pcm, 0 };                                            \
+    p##mad_stream_init(&st);                                              \
+    p##mad_frame_init(&fr);                                               \
+    p##mad_synth_init(&sy);                                               \
+    p##mad_stream_buffer(&st, s, len);                                    \
+    for (;;) {                                                            \
+      if (p##mad_frame_decode(&fr, &st)) {                                \
+        if (MAD_RECOVERABLE(st.error))                                    \
+          continue;                                                       \
+        break;                                                            \
+      }                                                                   \
+      p##mad_synth_frame(&sy, &fr, output, &o);                           \
+    }                                                                     \
+    return o.n;                                                           \
+  }
+
+DECODER(mad64_)
+DECODER(madxa_)
+DECODER(madx_)
+DECODER()
+
+static int peak(int16_t const *a, long n)
+{
+  int m = 0;
+
+  for (long i = 0; i < n; i++) {
+    if (abs(a[i]) > m)
+      m = abs(a[i]);
+  }
+  return m;
+}
+
+/* Largest difference; *cnt: number of samples that differ */
+static int cmp(int16_t const *a, int16_t const *b, long n, long *cnt)
+{
+  int m = 0;
+
+  *cnt = 0;
+  for (long i = 0; i < n; i++) {
+    int d = abs(a[i] - b[i]);
+    if (d) {
+      (*cnt)++;
+      if (d > m)
+        m = d;
+    }
+  }
+  return m;
+}
+
+int main(void)
+{
+  unsigned char *s = calloc(NFR, MP3GEN_FRAME + 8);
+  int16_t *ref = malloc(MAXPCM * 2), *pcm = malloc(MAXPCM * 2);
+
+  for (int mono = 0; mono < 2; mono++) {
+    unsigned long len = mp3gen_random(s, NFR, mono, 90);
+    long n, m, cnt;
+    int ex, ed;
+
+    n = decode_mad64_(s, len, ref);
+    CHECK(n > NFR * 1152 * 9 / 10 * (2 - mono));
+    CHECK(peak(ref, n) < 32000);
+
+    m = decode_madxa_(s, len, pcm);
+    CHECK(m == n);
+    CHECK(cmp(ref, pcm, n, &cnt) == 0);
+    CHECK(cnt == 0);
+
+    m = decode_madx_(s, len, pcm);
+    CHECK(m == n);
+    ex = cmp(ref, pcm, n, &cnt);
+    CHECK(ex <= 1);
+    CHECK(cnt < n / 20);
+    printf("%s: FPM_XTENSA: max error %d, %.3f%% of samples off",
+           mono ? "mono" : "stereo", ex, 100.0 * cnt / n);
+
+    m = decode_(s, len, pcm);
+    CHECK(m == n);
+    ed = cmp(ref, pcm, n, &cnt);
+    CHECK(ed > ex);
+    printf("; FPM_DEFAULT: max error %d, %.3f%% off\n", ed, 100.0 * cnt / n);
+  }
+
+  free(s);
+  free(ref);
+  free(pcm);
+
+  return testResult("fpm");
+}
@@ -0,0 +1,93 @@
+/*
+ * Layer III Huffman decoding: Single-lookup tables (OPT_HUFFWIDE)
+ * against the tree decoder
+ *
+ * Random bits hit every code word with its design probability.
+ * Table selection, region split and count1 table are random as
+ * well. Output, error code and final bit position must be the same.
+ */
+
+#define mad_layer_III mad_layer_III_wide
+
+#include "src/ESP8266Audio/libmad/layer3.c"
+
+#include <stdio.h>
+#include <time.h>
+
+#ifndef OPT_HUFFWIDE
+#error OPT_HUFFWIDE not defined
+#endif
+
+enum mad_error huff_tree(struct mad_bitptr *, mad_fixed_t *, struct channel *,
+                         unsigned int const *, unsigned int);
+
+static unsigned long long rs = 88172645463325252ULL;
+
+static unsigned rnd(void)
+{
+  rs ^= rs << 13; rs ^= rs >> 7; rs ^= rs << 17;
+  return (unsigned)rs;
+}
+
+static double now(void)
+{
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+int main(int argc, char **argv)
+{
+  static unsigned char buf[8192];
+  static unsigned char const sel[] = {
+    0, 1, 2, 3, 5, 6, 7, 8, 9, 10, 11, 12, 13, 15,
+    16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31
+  };
+  int n = argc > 1 ? atoi(argv[1]) : 100000, diff = 0, errs = 0;
+  double tt = 0, tw = 0;
+
+  for (int it = 0; it < n; it++) {
+    struct channel ch;
+    mad_fixed_t xa[576], xb[576];
+    struct mad_bitptr pa, pb;
+
+    memset(&ch, 0, sizeof(ch));
+    for (int i = 0; i < (int)sizeof(buf); i++)
+      buf[i] = rnd();
+    ch.part2_3_length = 500 + rnd() % 3596;
+    ch.big_values = rnd() % 289;
+    ch.global_gain = 100 + rnd() % 100;
+    for (int i = 0; i < 3; i++)
+      ch.table_select[i] = sel[rnd() % sizeof(sel)];
+    ch.region0_count = rnd() % 16;
+    ch.region1_count = rnd() % 8;
+    ch.flags = rnd() & count1table_select;
+    for (int i = 0; i < 39; i++)
+      ch.scalefac[i] = rnd() % 8;
+
+    unsigned int const *sfbw = sfbwidth_table[rnd() % 9].l;
+
+    mad_bit_init(&pa, buf);
+    mad_bit_skip(&pa, rnd() % 8);
+    pb = pa;
+
+    double t0 = now();
+    enum mad_error ea = huff_tree(&pa, xa, &ch, sfbw, 0);
+    double t1 = now();
+    enum mad_error eb = III_huffdecode(&pb, xb, &ch, sfbw, 0);
+    double t2 = now();
+
+    tt += t1 - t0;
+    tw += t2 - t1;
+    if (ea)
+      errs++;
+    if (ea != eb || (ea == MAD_ERROR_NONE && memcmp(xa, xb, sizeof(xa))) ||
+        pa.byte != pb.byte || pa.left != pb.left)
+      diff++;
+  }
+
+  printf("huffman: %d granules (%d end in errors), %d mismatches; "
+         "tree %.3fs, wide %.3fs, %.2fx\n", n, errs, diff, tt, tw, tt / tw);
+
+  return diff != 0;
+}
@@ -0,0 +1,204 @@
+/*
+ * remI2CBus on the fake bus: Transactions, statistics, merging
+ * and rate limiting of posted writes
+ */
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "test.h"
+
+#include "i2cbus.h"
+
+// flush() is normally called by the bus task
+class remI2CBusTest {
+    public:
+        static int flush(remI2CBus &b) { return b.flush(); }
+        static I2C_Stat *stat(remI2CBus &b, uint8_t addr) { return b.findStat(addr); }
+        static int jobs(remI2CBus &b) { return b._numJobs; }
+};
+typedef remI2CBusTest T;
+
+static const uint8_t A = 0x70, B = 0x71;
+
+static void setup()
+{
+    fakeI2C.reset();
+    fakeI2C.devs[A];
+    fakeI2C.devs[B];
+}
+
+static void testTransactions()
+{
+    remI2CBus b;
+    uint8_t w[3] = { 1, 2, 3 }, r[2];
+
+    setup();
+    fakeI2C.devs.erase(B);
+
+    CHECK(b.write(A, w, 3) == 0);
+    CHECK(fakeI2C.log.size() == 1);
+    CHECK(fakeI2C.log[0].addr == A && fakeI2C.log[0].data.size() == 3 && fakeI2C.log[0].data[2] == 3);
+
+    // Missing device: NACK counted as error
+    CHECK(b.write(B, w, 3) != 0);
+    CHECK(b.probe(A));
+    CHECK(!b.probe(B));
+    CHECK(T::stat(b, B)->errors == 1);
+    CHECK(T::stat(b, B)->count == 2);
+
+    // Short read is an error
+    fakeI2C.devs[A].rx = { 0xaa };
+    CHECK(b.read(A, r, 2) == 1 && r[0] == 0xaa);
+    CHECK(T::stat(b, A)->errors == 1);
+
+    // Repeated start: No stop after the register address
+    fakeI2C.log.clear();
+    fakeI2C.devs[A].rx = { 0x12, 0x34 };
+    CHECK(b.writeRead(A, w, 1, r, 2) == 2 && r[0] == 0x12 && r[1] == 0x34);
+    CHECK(fakeI2C.log.size() == 2 && !fakeI2C.log[0].stop && fakeI2C.log[1].read);
+
+    // Separate transactions, with delay in between
+    fakeI2C.log.clear();
+    fakeI2C.devs[A].rx = { 0x56 };
+    unsigned long t0 = millis();
+    CHECK(b.writeRead(A, w, 1, r, 1, false, 5) == 1 && r[0] == 0x56);
+    CHECK(fakeI2C.log.size() == 2 && fakeI2C.log[0].stop);
+    CHECK(millis() - t0 >= 5);
+
+    // Count and bytes: write (3), probe, read (2), writeRead (1+2),
+    // write (1) + read (1)
+    I2C_Stat *s = T::stat(b, A);
+    CHECK(s->count == 6);
+    CHECK(s->bytes == 3 + 2 + 3 + 1 + 1);
+    CHECK(s->busyUs > 0);
+
+    char buf[256];
+    b.getStats(buf, sizeof(buf));
+    CHECK(strstr(buf, "i2c 0x70 n=6 ") != NULL);
+    CHECK(strstr(buf, "i2c 0x71 n=2 ") != NULL);
+    b.resetStats();
+    CHECK(T::stat(b, A)->count == 0 && T::stat(b, A)->addr == A);
+}
+
+static void testSyncPost()
+{
+    remI2CBus b;
+    uint8_t d[2] = { 1, 2 };
+
+    setup();
+
+    // No bus task: Posted writes go out immediately
+    CHECK(!b.isAsync());
+    b.post(A, 0, d, 2);
+    b.post(A, 0, d, 2);
+    CHECK(fakeI2C.log.size() == 2);
+    CHECK(!b.isPending(A, 0));
+}
+
+static void testMerge()
+{
+    remI2CBus b;
+    uint8_t d1[2] = { 0, 1 }, d2[2] = { 1, 2 }, d3[2] = { 0, 3 };
+
+    setup();
+    b.begin();
+    CHECK(b.isAsync());
+
+    b.post(A, 0, d1, 2);
+    b.post(A, 1, d2, 2);
+    b.post(A, 0, d3, 2);    // Replaces d1, moves behind d2
+    CHECK(fakeI2C.log.empty());
+    CHECK(b.isPending(A, 0) && b.isPending(A, 1));
+    CHECK(T::jobs(b) == 2);
+
+    CHECK(T::flush(b) == 0);
+    CHECK(fakeI2C.log.size() == 2);
+    CHECK(fakeI2C.log[0].data[1] == 2);
+    CHECK(fakeI2C.log[1].data[1] == 3);
+    CHECK(!b.isPending(A, 0) && !b.isPending(A, 1));
+    CHECK(T::stat(b, A)->merged == 1);
+    CHECK(T::stat(b, A)->count == 2);
+}
+
+static void testRateLimit()
+{
+    remI2CBus b;
+    uint8_t d[2] = { 0, 0 };
+    int wait;
+
+    setup();
+    b.begin();
+    b.setMinInterval(A, 10);
+
+    // First batch is due immediately
+    b.post(A, 0, d, 2);
+    CHECK(T::flush(b) == 0);
+    CHECK(fakeI2C.log.size() == 1);
+
+    // Next one has to wait for the interval; B is not held up
+    for(int i = 0; i < 5; i++) {
+        d[1] = i;
+        b.post(A, 0, d, 2);
+    }
+    b.post(B, 0, d, 2);
+    wait = T::flush(b);
+    CHECK(wait > 0 && wait <= 10);
+    CHECK(fakeI2C.log.size() == 2 && fakeI2C.log[1].addr == B);
+    CHECK(b.isPending(A, 0));
+
+    host_advance(wait - 1);
+    CHECK(T::flush(b) > 0);
+    CHECK(fakeI2C.log.size() == 2);
+
+    host_advance(1);
+    CHECK(T::flush(b) == 0);
+    CHECK(fakeI2C.log.size() == 3);
+    CHECK(fakeI2C.log[2].addr == A && fakeI2C.log[2].data[1] == 4);
+    CHECK(T::stat(b, A)->merged == 4);
+}
+
+static void testOverflow()
+{
+    remI2CBus b;
+    uint8_t d[I2CB_MAXDATA + 1] = { 0 };
+
+    setup();
+    b.begin();
+
+    // Too long for the queue: Written at once
+    b.post(A, 0, d, I2CB_MAXDATA + 1);
+    CHECK(fakeI2C.log.size() == 1);
+
+    // Queue full: Dropped and counted, not written ahead of the
+    // queued ones or the device's interval
+    b.setMinInterval(A, 10);
+    for(int i = 0; i < I2CB_MAXJOBS + 2; i++) {
+        d[1] = i;
+        b.post(A, i, d, 2);
+    }
+    CHECK(fakeI2C.log.size() == 1);
+    CHECK(T::jobs(b) == I2CB_MAXJOBS);
+    CHECK(!b.isPending(A, I2CB_MAXJOBS));
+    CHECK(T::stat(b, A)->dropped == 2);
+
+    char buf[256];
+    b.getStats(buf, sizeof(buf));
+    CHECK(strstr(buf, " drop=2 ") != NULL);
+
+    CHECK(T::flush(b) == 0);
+    CHECK(fakeI2C.log.size() == 1 + I2CB_MAXJOBS);
+    for(int i = 0; i < I2CB_MAXJOBS; i++) {
+        CHECK(fakeI2C.log[1 + i].data[1] == i);
+    }
+}
+
+int main()
+{
+    testTransactions();
+    testSyncPost();
+    testMerge();
+    testRateLimit();
+    testOverflow();
+
+    return testResult("i2cbus");
+}
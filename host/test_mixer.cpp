@@ -0,0 +1,170 @@
+/*
+ * AudioOutputMixer: Resampler quality, anti-aliasing when
+ * downsampling, and mixing of two inputs
+ */
+
+#include <Arduino.h>
+#include <vector>
+#include "test.h"
+
+#include "src/ESP8266Audio/AudioOutputMixer.h"
+
+class Sink : public AudioOutput {
+    public:
+        std::vector<int16_t> out;   // Left channel
+        bool begin() override { return true; }
+        bool SetRate(int) override { return true; }
+        bool SetBitsPerSample(int) override { return true; }
+        bool SetChannels(int) override { return true; }
+        bool SetGain(float, int = 0) override { return true; }
+        size_t ConsumeSample(int16_t l, int16_t) override { out.push_back(l); return 1; }
+        size_t ConsumeSamples(const int16_t *s, size_t n) override 
+        { 
+            for(size_t i = 0; i < n; i++) out.push_back(s[2*i]);
+            return n; 
+        }
+        bool stop() override { return true; }
+};
+
+// Feed a sine at rate through the mixer, return 1s of output
+static std::vector<int16_t> run(int rate, double f, double amp = 16000)
+{
+    Sink s;
+    AudioOutputMixer m(1024, &s, 44100);
+    AudioOutputMixerStub *in = m.NewInput();
+    int16_t buf[512];
+    long n = 0;
+
+    in->SetRate(rate);
+    in->SetChannels(2);
+    in->SetBitsPerSample(16);
+    in->SetGain(1.0f);
+    in->begin();
+
+    while(s.out.size() < 44100) {
+        for(int i = 0; i < 256; i++, n++) {
+            buf[2*i] = buf[2*i+1] = (int16_t)lrint(amp * sin(2 * M_PI * f * n / rate));
+        }
+        for(size_t done = 0; done < 256; m.Pump()) {
+            done += in->ConsumeSamples(buf + 2*done, 256 - done);
+        }
+    }
+    s.out.resize(44100);
+
+    return s.out;
+}
+
+// Fit a sine of frequency f to the output, past the
+// gain ramp and filter delay; returns SNR in dB, fitted level in
+// dB relative to amp
+static double fit(const std::vector<int16_t> &y, double f, double amp, double *level)
+{
+    double ss = 0, cc = 0, sc = 0, sy = 0, cy = 0;
+
+    for(size_t i = 4000; i < y.size(); i++) {
+        double s = sin(2 * M_PI * f * i / 44100), c = cos(2 * M_PI * f * i / 44100), v = y[i];
+        ss += s * s; cc += c * c; sc += s * c; sy += s * v; cy += c * v;
+    }
+    double d = ss * cc - sc * sc;
+    double a = (sy * cc - cy * sc) / d, b = (cy * ss - sy * sc) / d;
+    double sig = 0, noise = 0;
+
+    for(size_t i = 4000; i < y.size(); i++) {
+        double s = a * sin(2 * M_PI * f * i / 44100) + b * cos(2 * M_PI * f * i / 44100);
+        sig += s * s;
+        noise += (y[i] - s) * (y[i] - s);
+    }
+
+    if(level) *level = 20 * log10(sqrt(a * a + b * b) / amp);
+
+    return 10 * log10(sig / (noise > 1e-9 ? noise : 1e-9));
+}
+
+static double rmsDb(const std::vector<int16_t> &y, double amp)
+{
+    double e = 0;
+
+    for(size_t i = 4000; i < y.size(); i++) e += (double)y[i] * y[i];
+
+    return 20 * log10(sqrt(e / (y.size() - 4000)) / (amp / sqrt(2)));
+}
+
+static void testQuality()
+{
+    static const struct { int rate; double f; double minSnr; } t[] = {
+        { 44100, 1000, 85 },    // Same rate: no resampling
+        { 22050, 1000, 78 },
+        { 22050, 5000, 60 },
+        { 24000, 1000, 70 },
+        { 32000, 1000, 70 },
+        { 32000, 5000, 70 },
+        { 48000, 1000, 70 },
+    };
+
+    for(auto &c : t) {
+        double level, snr = fit(run(c.rate, c.f), c.f, 16000, &level);
+        printf("  %5d Hz, %4.0f Hz tone: SNR %5.1f dB, level %+5.2f dB\n", c.rate, c.f, snr, level);
+        CHECK(snr >= c.minSnr);
+        CHECK(fabs(level) < 0.5);
+    }
+}
+
+// 48k -> 44.1k: Input between the output's Nyquist frequency
+// (22.05k) and the input's (24k) aliases to 20.1k-22.05k. Spec:
+// 23k (aliasing to 21.1k) down by at least 40dB; flat (0.5dB) to
+// 15k. The 8-tap filter used for upsampling gets 23k to -12dB at
+// best, so downsampling has a longer one (AUDIO_MIXER_DTAPS). Its
+// transition band lies between 15k and 22.05k.
+static void testDownsample()
+{
+    static const struct { double f, minDb, maxDb; } t[] = {
+        { 15000, -0.5,   0.5 },
+        { 19000, -200,   0.5 },      // Transition band
+        { 21500, -200,   0.5 },
+        { 23000, -200, -40 },
+    };
+
+    for(auto &c : t) {
+        double db = rmsDb(run(48000, c.f), 16000);
+        printf("  48000 Hz, %5.0f Hz tone: %6.1f dB\n", c.f, db);
+        CHECK(db >= c.minDb && db <= c.maxDb);
+    }
+}
+
+static void testMix()
+{
+    Sink s;
+    AudioOutputMixer m(1024, &s, 44100);
+    AudioOutputMixerStub *a = m.NewInput(), *b = m.NewInput();
+    int16_t ba[512], bb[512];
+
+    for(auto in : { a, b }) {
+        in->SetRate(44100);
+        in->SetChannels(2);
+        in->SetBitsPerSample(16);
+        in->SetGain(1.0f);
+        in->begin();
+    }
+    for(int i = 0; i < 512; i++) {
+        ba[i] = 1000;
+        bb[i] = 2000;
+    }
+    while(s.out.size() < 8192) {
+        size_t da = 0, db = 0;
+        while(da < 256 || db < 256) {
+            if(da < 256) da += a->ConsumeSamples(ba + 2*da, 256 - da);
+            if(db < 256) db += b->ConsumeSamples(bb + 2*db, 256 - db);
+            m.Pump();
+        }
+    }
+    CHECK(abs(s.out[8000] - 3000) <= 1);
+}
+
+int main()
+{
+    testQuality();
+    testDownsample();
+    testMix();
+
+    return testResult("mixer");
+}
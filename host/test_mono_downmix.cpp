@@ -0,0 +1,161 @@
+/*
+ * libmad: MAD_OPTION_SINGLECHANNEL against a reference downmix
+ *
+ * Decodes a synthetic stereo stream (mp3gen_switching()) once in
+ * stereo and once with MAD_OPTION_SINGLECHANNEL, and compares the
+ * mono output with (L+R)/2 of the stereo output. In the stream,
+ * each channel picks its block type per granule, so the decoder
+ * takes both of its downmix paths and switches between them:
+ * Same block layout (spectra mixed, one IMDCT) and different
+ * layout (both transformed, subband samples and overlap mixed).
+ *
+ * Runs on the ESP32's fixed-point backend (FPM_XTENSA, see
+ * test_fpm.c) and on FPM_64BIT with OPT_ACCURACY.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <vector>
+
+#include "src/ESP8266Audio/libmad/config.h"
+#include "src/ESP8266Audio/libmad/mad.h"
+#include "mp3gen.h"
+#include "test.h"
+
+#define NFR     (383 * 2)
+
+static enum mad_flow output(void *data, struct mad_header const *, struct mad_pcm *pcm)
+{
+    std::vector<int16_t> *o = (std::vector<int16_t> *)data;
+
+    for(int i = 0; i < pcm->length; i++) {
+        for(int ch = 0; ch < pcm->channels; ch++) {
+            o->push_back(pcm->samples[ch][i]);
+        }
+    }
+    return MAD_FLOW_CONTINUE;
+}
+
+#define DECODER(p)                                                                      \
+    extern "C" {                                                                        \
+        void p##mad_stream_init(struct mad_stream *);                                   \
+        void p##mad_stream_buffer(struct mad_stream *, unsigned char const *, unsigned long); \
+        void p##mad_frame_init(struct mad_frame *);                                     \
+        int  p##mad_frame_decode(struct mad_frame *, struct mad_stream *);              \
+        void p##mad_synth_init(struct mad_synth *);                                     \
+        enum mad_flow p##mad_synth_frame(struct mad_synth *, struct mad_frame const *,  \
+                enum mad_flow (*)(void *, struct mad_header const *, struct mad_pcm *), void *); \
+    }                                                                                   \
+    static void decode_##p(const unsigned char *s, unsigned long len, int opts,         \
+                           std::vector<int16_t> &pcm)                                   \
+    {                                                                                   \
+        static struct mad_stream st;                                                    \
+        static struct mad_frame fr;                                                     \
+        static struct mad_synth sy;                                                     \
+        pcm.clear();                                                                    \
+        p##mad_stream_init(&st);                                                        \
+        p##mad_frame_init(&fr);                                                         \
+        p##mad_synth_init(&sy);                                                         \
+        mad_stream_options(&st, opts);                                                  \
+        p##mad_stream_buffer(&st, s, len);                                              \
+        for(;;) {                                                                       \
+            if(p##mad_frame_decode(&fr, &st)) {                                         \
+                if(MAD_RECOVERABLE(st.error)) continue;                                 \
+                break;                                                                  \
+            }                                                                           \
+            p##mad_synth_frame(&sy, &fr, output, &pcm);                                 \
+        }                                                                               \
+    }
+
+DECODER(madx_)
+DECODER(mad64_)
+
+// Granules whose channels have the same block layout, and
+// granules whose channels differ; read from the side info
+static void layouts(const unsigned char *s, int *same, int *diff)
+{
+    *same = *diff = 0;
+    for(int k = 0; k < NFR; k++, s += MP3GEN_FRAME) {
+        int pos = 32 + 20, l[2];
+        auto bits = [s, &pos](int n) {
+            unsigned v = 0;
+            while(n--) { v = v << 1 | (s[pos >> 3] >> (7 - (pos & 7)) & 1); pos++; }
+            return v;
+        };
+        for(int gr = 0; gr < 2; gr++) {
+            for(int ch = 0; ch < 2; ch++) {
+                int p0 = pos;
+                pos += 33;
+                l[ch] = 0;
+                if(bits(1)) {
+                    l[ch] = bits(2) << 1;
+                    l[ch] |= bits(1);
+                }
+                pos = p0 + 59;
+            }
+            if(l[0] == l[1]) (*same)++; else (*diff)++;
+        }
+    }
+}
+
+// Largest deviation of mono from (L+R)/2; *cnt: samples off by
+// more than one LSB
+static double cmp(const std::vector<int16_t> &st, const std::vector<int16_t> &mo, long *cnt)
+{
+    double m = 0;
+
+    *cnt = 0;
+    for(size_t i = 0; i < mo.size(); i++) {
+        double d = fabs(mo[i] - (st[2*i] + st[2*i+1]) / 2.0);
+        if(d > 1) (*cnt)++;
+        if(d > m) m = d;
+    }
+    return m;
+}
+
+static int peak(const std::vector<int16_t> &a)
+{
+    int m = 0;
+
+    for(int16_t v : a) {
+        if(abs(v) > m) m = abs(v);
+    }
+    return m;
+}
+
+int main()
+{
+    std::vector<unsigned char> s(NFR * MP3GEN_FRAME + 8);
+    std::vector<int16_t> st, mo;
+    unsigned long len = mp3gen_switching(s.data(), NFR, 90);
+    int same, diff;
+    long cnt;
+    double e;
+
+    layouts(s.data(), &same, &diff);
+    CHECK(same > NFR / 4);
+    CHECK(diff > NFR / 4);
+    printf("%d granules with the same block layout in L and R, %d different\n", same, diff);
+
+    decode_mad64_(s.data(), len, 0, st);
+    decode_mad64_(s.data(), len, MAD_OPTION_SINGLECHANNEL, mo);
+    CHECK(st.size() > NFR * 1152 * 2 * 9 / 10);
+    CHECK(peak(st) < 32000);
+    CHECK(mo.size() * 2 == st.size());
+    e = cmp(st, mo, &cnt);
+    CHECK(e <= 1);
+    printf("FPM_64BIT: max error %.1f LSB\n", e);
+
+    decode_madx_(s.data(), len, 0, st);
+    decode_madx_(s.data(), len, MAD_OPTION_SINGLECHANNEL, mo);
+    CHECK(mo.size() * 2 == st.size());
+    e = cmp(st, mo, &cnt);
+    CHECK(e <= 2);
+    CHECK(cnt < (long)mo.size() / 100);
+    printf("FPM_XTENSA: max error %.1f LSB, %.3f%% of samples off by more than 1\n",
+            e, 100.0 * cnt / mo.size());
+
+    return testResult("mono_downmix");
+}
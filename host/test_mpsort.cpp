@@ -0,0 +1,122 @@
+/*
+ * Renamer's sort: Natural order, and runs spilled to the file system
+ */
+
+#include <Arduino.h>
+#include <FS.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "test.h"
+
+#include "mpsort.h"
+
+static char root[] = "/tmp/mpsortXXXXXX";
+static int  idleCalls;
+
+static void idle()
+{
+    idleCalls++;
+}
+
+static std::vector<std::string> sortNames(fs::FS *fs, const std::vector<std::string> &in, int *runs = NULL)
+{
+    std::vector<std::string> out;
+    MpRen_Ctx x;
+    const char *n;
+
+    CHECK(mpren_init(&x, fs, idle));
+    for(auto &s : in) {
+        if(!mpren_add(&x, s.c_str())) break;
+    }
+    mpren_sort(&x);
+    if(runs) *runs = x.runs;
+    while((n = mpren_next(&x))) {
+        out.push_back(n);
+    }
+    mpren_free(&x);
+
+    return out;
+}
+
+static void testOrder(fs::FS *fs)
+{
+    std::vector<std::string> exp = {
+        "01 intro.mp3",
+        "1 Intro.mp3",          // Same key as above; name decides
+        "2.mp3",
+        "10.mp3",
+        "a.mp3",
+        "ABC.mp3",
+        "abc.mp3",
+        "B.mp3",
+        "Track 2.mp3",
+        "track 9b.mp3",
+        "Track 10.mp3",
+        "Track 10a.mp3",
+        "Track 100.mp3",
+    };
+    std::vector<std::string> in = exp;
+
+    std::reverse(in.begin(), in.end());
+    std::swap(in[0], in[5]);
+    CHECK(sortNames(fs, in) == exp);
+}
+
+static void testRuns(fs::FS *fs)
+{
+    std::vector<std::string> in, exp, out;
+    std::string pad(200, 'x');
+    int runs = 0;
+
+    // 1000 long names don't fit into the sort buffers
+    for(int i = 0; i < 1000; i++) {
+        exp.push_back("Song " + std::to_string(i) + " " + pad + ".mp3");
+    }
+    in = exp;
+    srand(1);
+    for(int i = in.size() - 1; i > 0; i--) {
+        std::swap(in[i], in[rand() % (i + 1)]);
+    }
+
+    idleCalls = 0;
+    out = sortNames(fs, in, &runs);
+    CHECK(runs > 0 && runs <= MPREN_MAXRUNS);
+    CHECK(idleCalls > 0);
+    CHECK(out == exp);
+
+    // Runs are removed
+    CHECK(!fs->exists("/RM_SORT0.TMP"));
+
+    // Too many for all runs: The names added so far come out sorted.
+    // (Names are < 256 characters, as checked by the caller.)
+    std::string pad2(235, 'y');
+    in.clear();
+    for(int i = 3000; i > 0; i--) {
+        in.push_back("Song " + std::to_string(i) + " " + pad2 + ".mp3");
+    }
+    out = sortNames(fs, in, &runs);
+    CHECK(runs == MPREN_MAXRUNS);
+    CHECK(out.size() > 1000 && out.size() < in.size());
+    CHECK(out.back().size() < 256);
+    CHECK(std::is_sorted(out.begin(), out.end(), [](const std::string &a, const std::string &b) {
+        return atoi(a.c_str() + 5) < atoi(b.c_str() + 5);
+    }));
+}
+
+int main()
+{
+    if(!mkdtemp(root)) {
+        perror("mkdtemp");
+        return 1;
+    }
+
+    fs::FS fs(root);
+
+    testOrder(&fs);
+    testRuns(&fs);
+
+    rmdir(root);
+
+    return testResult("mpsort");
+}
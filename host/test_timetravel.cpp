@@ -0,0 +1,138 @@
+/*
+ * Firmware simulation: A time travel triggered by a (fake) TCD
+ *
+ * Runs the sketch's setup() and loop() with its tasks as
+ * coroutines on the virtual clock (see stubs/tasks.cpp). The TCD
+ * answers the remote's BTTFN requests and then sends TT and
+ * REENTRY notifications over multicast; the remote must go
+ * through P0, P1 and P2 and back to idle with the TCD's timing.
+ * Ends with how much faster than real time the simulation ran.
+ */
+
+#include <Arduino.h>
+#include <WiFiUdp.h>
+#include <chrono>
+#include "test.h"
+
+#include "remote_main.h"
+#include "remote_settings.h"
+#include "remote_bttfn.h"
+
+void setup();
+void loop();
+
+#define PORT        1338
+#define VERSION     1
+
+static IPAddress tcdIP(192, 168, 4, 1);
+static IPAddress mcIP(224, 0, 0, 224);
+static int requests, answered;
+
+static void checksum(uint8_t *b)
+{
+    uint8_t a = 0;
+
+    for(int i = BPO_VER; i < BPO_CHKSUM; i++) a += b[i] ^ 0x55;
+    b[BPO_CHKSUM] = a;
+}
+
+// TCD: Answer requests with status (remote allowed) and caps
+static void tcdRecv(IPAddress to, uint16_t port, uint16_t fromPort, const uint8_t *d, size_t len)
+{
+    uint8_t b[BTTF_PACKET_SIZE];
+
+    if(to != tcdIP || port != PORT || len != BTTF_PACKET_SIZE) return;
+    if(!BTTFNPacket(d).valid(len)) return;
+    requests++;
+
+    memcpy(b, d, BTTF_PACKET_SIZE);
+    memset(b + 10, 0, BTTF_PACKET_SIZE - 10);
+    b[BPO_VER] = VERSION | 0x80;
+    b[BPO_TYPE] = 0x10 | 0x40;
+    b[BPO_R_STATUS] = 0x04;
+    b[BPO_R_CAPS] = 0x01;
+    checksum(b);
+    host_udpDeliver(tcdIP, PORT, hostIP, fromPort, b, BTTF_PACKET_SIZE);
+    answered++;
+}
+
+static void notify(uint8_t type, uint16_t p1 = 0, uint16_t p2 = 0)
+{
+    uint8_t b[BTTF_PACKET_SIZE] = { 'B', 'T', 'T', 'F' };
+
+    b[BPO_VER] = VERSION | 0x40;
+    b[BPO_TYPE] = type;
+    b[BPO_N_P1] = p1 & 0xff; b[BPO_N_P1 + 1] = p1 >> 8;
+    b[BPO_N_P2] = p2 & 0xff; b[BPO_N_P2 + 1] = p2 >> 8;
+    checksum(b);
+    host_udpDeliver(tcdIP, PORT, mcIP, PORT + 2, b, BTTF_PACKET_SIZE);
+}
+
+// Run the main loop until cond is true or ms have passed; one
+// loop iteration costs 1ms. Returns when cond became true, -1
+// on timeout.
+template<typename C> static long runUntil(unsigned long ms, C cond)
+{
+    unsigned long t0 = millis();
+
+    while(millis() - t0 < ms) {
+        loop();
+        if(cond()) return millis() - t0;
+        delay(1);
+    }
+    return -1;
+}
+
+int main()
+{
+    const uint16_t lead = 5000, p1 = 6000;
+    auto w0 = std::chrono::steady_clock::now();
+    long t;
+
+    hostTasks = HOST_TASKS_COOP;
+    hostUdpSend = tcdRecv;
+    strcpy(settings.tcdIP, "192.168.4.1");
+
+    setup();
+    CHECK(csf & CSF_OFF);
+
+    // Fake power on (active low)
+    host_setPin(15, LOW);
+    t = runUntil(1000, [] { return !(csf & CSF_OFF); });
+    CHECK(t >= 50);
+
+    t = runUntil(5000, [] { return remoteAllowed; });
+    CHECK(t >= 0);
+    CHECK(answered > 0 && answered == requests);
+
+    // TT with lead: P0 for the lead, then P1 until REENTRY
+    notify(2, lead, p1);
+    t = runUntil(100, [] { return (csf & (CSF_TT|CSF_TTP0)) == (CSF_TT|CSF_TTP0); });
+    CHECK(t >= 0 && t < 20);
+
+    t = runUntil(lead + 1000, [] { return !!(csf & CSF_TTP1); });
+    CHECK(t >= lead - 50 && t <= lead + 50);
+    CHECK(!(csf & CSF_TTP0));
+
+    // TCD sends REENTRY at the end of its P1
+    t = runUntil(p1 - 500, [] { return !(csf & CSF_TTP1); });
+    CHECK(t < 0);
+    notify(3);
+    t = runUntil(100, [] { return !!(csf & CSF_TTP2); });
+    CHECK(t >= 0 && t < 20);
+    CHECK(!(csf & CSF_TTP1));
+
+    t = runUntil(30000, [] { return !(csf & CSF_TT); });
+    CHECK(t >= 0);
+    CHECK(!(csf & (CSF_TTP0|CSF_TTP1|CSF_TTP2)));
+
+    // Still connected: requests kept being answered
+    CHECK(remoteAllowed);
+    CHECK(requests > 10);
+
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - w0).count();
+    printf("%.1fs simulated in %.2fs (%.0fx real time), %d BTTFN requests\n",
+            millis() / 1000.0, wall, millis() / 1000.0 / wall, requests);
+
+    return testResult("timetravel");
+}
@@ -0,0 +1,469 @@
+/*
+ * AudioGeneratorWAVLoop: PCM, IMA-ADPCM and QOA decoding
+ *
+ * Reference encoders below produce a file and the exact samples a
+ * decoder must return for it. Checked: bit-exact decoding, mono
+ * and stereo, and looped playback (second pass equal to the first).
+ */
+
+#include <Arduino.h>
+#include <vector>
+#include <algorithm>
+#include "test.h"
+
+#include "AudioGeneratorWAVLoop.h"
+
+typedef std::vector<uint8_t> Bytes;
+typedef std::vector<int16_t> Samples;
+
+// File in memory; wraps to loopStart at its end if that is set,
+// as AudioFileSourceLoop does
+class MemSrc : public AudioFileSource {
+    public:
+        MemSrc(const Bytes *b) : b(b) {}
+        uint32_t read(void *d, uint32_t len) override
+        {
+            uint32_t n = 0;
+            while(n < len) {
+                if(pos >= b->size()) {
+                    if(loopStart < 0) break;
+                    pos = loopStart;
+                }
+                uint32_t c = std::min<uint32_t>(len - n, b->size() - pos);
+                memcpy((uint8_t *)d + n, b->data() + pos, c);
+                pos += c;
+                n += c;
+            }
+            return n;
+        }
+        bool seek(int32_t p, int dir) override
+        {
+            if(dir == SEEK_SET)      pos = p;
+            else if(dir == SEEK_CUR) pos += p;
+            else                     pos = b->size() + p;
+            return pos <= b->size();
+        }
+        bool close() override { return true; }
+        bool isOpen() override { return true; }
+        uint32_t getPos() override { return pos; }
+        uint32_t getSize() override { return b->size(); }
+
+        int32_t loopStart = -1;
+
+    private:
+        const Bytes *b;
+        uint32_t pos = 0;
+};
+
+// Collects interleaved stereo; refuses more than max frames
+class Coll : public AudioOutput {
+    public:
+        Samples s;
+        size_t max = SIZE_MAX;
+        bool begin() override { return true; }
+        size_t ConsumeSamples(const int16_t *p, size_t f) override
+        {
+            f = std::min(f, max - s.size() / 2);
+            s.insert(s.end(), p, p + f * 2);
+            return f;
+        }
+        bool stop() override { return true; }
+};
+
+static double now()
+{
+    timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+static int clamp16(int v)
+{
+    return v < -32768 ? -32768 : (v > 32767 ? 32767 : v);
+}
+
+static void put16(Bytes &b, uint16_t v) { b.push_back(v); b.push_back(v >> 8); }
+static void put32(Bytes &b, uint32_t v) { put16(b, v); put16(b, v >> 16); }
+static void be16(Bytes &b, uint16_t v) { b.push_back(v >> 8); b.push_back(v); }
+static void be32(Bytes &b, uint32_t v) { be16(b, v >> 16); be16(b, v); }
+
+static void putStr(Bytes &b, const char *s)
+{
+    b.insert(b.end(), s, s + strlen(s));
+}
+
+// Test signal: Two tones, a sweep and noise
+static Samples signal(int ch, size_t frames)
+{
+    Samples v;
+    unsigned r = 1;
+
+    for(size_t i = 0; i < frames; i++) {
+        for(int c = 0; c < ch; c++) {
+            double t = i / 44100.0;
+            r = r * 1103515245 + 12345;
+            double x = 6000 * sin(2 * M_PI * (220 + c * 3) * t) +
+                       4000 * sin(2 * M_PI * (1375 + 200 * sin(t)) * t) * (0.5 + 0.5 * sin(3 * t)) +
+                       1500 * sin(2 * M_PI * 5100 * t) + ((int)(r >> 16) % 600 - 300);
+            v.push_back(clamp16((int)x));
+        }
+    }
+
+    return v;
+}
+
+// Expected output is always stereo
+static Samples toStereo(const Samples &in, int ch)
+{
+    Samples o;
+
+    for(size_t i = 0; i < in.size(); i += ch) {
+        o.push_back(in[i]);
+        o.push_back(in[i + ch - 1]);
+    }
+
+    return o;
+}
+
+// PCM ------------------------------------------------------------
+
+static Bytes encPcm(const Samples &in, int ch)
+{
+    Bytes w;
+
+    putStr(w, "RIFF"); put32(w, 36 + in.size() * 2); putStr(w, "WAVEfmt ");
+    put32(w, 16); put16(w, 1); put16(w, ch); put32(w, 44100); put32(w, 44100 * ch * 2);
+    put16(w, ch * 2); put16(w, 16);
+    putStr(w, "data"); put32(w, in.size() * 2);
+    for(int16_t s : in) put16(w, s);
+
+    return w;
+}
+
+// IMA-ADPCM ------------------------------------------------------
+
+static const int16_t imaStep[89] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230,
+    253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963,
+    1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
+    3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442,
+    11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794,
+    32767
+};
+static const int imaIdx[8] = { -1, -1, -1, -1, 2, 4, 6, 8 };
+
+struct Ima { int pred = 0, idx = 0; };
+
+static uint8_t imaEnc(Ima &s, int x)
+{
+    int step = imaStep[s.idx], d = x - s.pred, n = 0;
+
+    if(d < 0) { n = 8; d = -d; }
+    if(d >= step) { n |= 4; d -= step; }
+    if(d >= step / 2) { n |= 2; d -= step / 2; }
+    if(d >= step / 4) n |= 1;
+
+    int diff = step >> 3;
+    if(n & 4) diff += step;
+    if(n & 2) diff += step >> 1;
+    if(n & 1) diff += step >> 2;
+    s.pred = clamp16((n & 8) ? s.pred - diff : s.pred + diff);
+    s.idx = std::min(88, std::max(0, s.idx + imaIdx[n & 7]));
+
+    return n;
+}
+
+// The last block may be shorter: 1 + a multiple of 2 (mono) or 8
+// (stereo) frames. tail: Add a chunk after the data chunk.
+static Bytes encAdpcm(const Samples &in, int ch, int align, Samples &rec, bool tail = false)
+{
+    int spb = (align - 4 * ch) * 2 / ch + 1;
+    size_t frames = in.size() / ch;
+    Bytes d, w;
+    Ima s[2];
+
+    for(size_t f = 0; f < frames; f += spb) {
+        int n = std::min<size_t>(spb, frames - f);
+        // Header: First sample, step index
+        for(int c = 0; c < ch; c++) {
+            s[c].pred = in[f * ch + c];
+            put16(d, s[c].pred);
+            d.push_back(s[c].idx);
+            d.push_back(0);
+        }
+        // Mono: 2 samples per byte; stereo: 8 samples per channel
+        // in 4 bytes, alternating
+        for(int i = 1; i < n; i += (ch == 1) ? 2 : 8) {
+            for(int c = 0; c < ch; c++) {
+                for(int k = 0; k < ((ch == 1) ? 2 : 8); k += 2) {
+                    uint8_t n0 = imaEnc(s[c], in[(f + i + k) * ch + c]);
+                    uint8_t n1 = imaEnc(s[c], in[(f + i + k + 1) * ch + c]);
+                    d.push_back(n0 | n1 << 4);
+                }
+            }
+        }
+    }
+    // Expected output: Decode what was encoded
+    for(size_t b = 0; b < d.size(); b += align) {
+        Ima t[2];
+        const uint8_t *p = &d[b];
+        int16_t out[2][WAVLOOP_MAXBLOCK];
+        int n = (std::min<size_t>(align, d.size() - b) - 4 * ch) * 2 / ch + 1;
+        for(int c = 0; c < ch; c++, p += 4) {
+            t[c].pred = (int16_t)(p[0] | p[1] << 8);
+            t[c].idx = p[2];
+            out[c][0] = t[c].pred;
+        }
+        for(int i = 1; i < n; i += (ch == 1) ? 2 : 8) {
+            for(int c = 0; c < ch; c++) {
+                for(int k = 0; k < ((ch == 1) ? 2 : 8); k += 2, p++) {
+                    for(int h = 0; h < 2; h++) {
+                        int n = (*p >> (h * 4)) & 15, step = imaStep[t[c].idx];
+                        int diff = step >> 3;
+                        if(n & 4) diff += step;
+                        if(n & 2) diff += step >> 1;
+                        if(n & 1) diff += step >> 2;
+                        t[c].pred = clamp16((n & 8) ? t[c].pred - diff : t[c].pred + diff);
+                        t[c].idx = std::min(88, std::max(0, t[c].idx + imaIdx[n & 7]));
+                        out[c][i + k + h] = t[c].pred;
+                    }
+                }
+            }
+        }
+        for(int i = 0; i < n; i++) {
+            rec.push_back(out[0][i]);
+            rec.push_back(out[ch - 1][i]);
+        }
+    }
+
+    putStr(w, "RIFF"); put32(w, 0); putStr(w, "WAVEfmt ");
+    put32(w, 20); put16(w, WAVLOOP_FMT_ADPCM); put16(w, ch); put32(w, 44100);
+    put32(w, 44100 * align / spb); put16(w, align); put16(w, 4); put16(w, 2); put16(w, spb);
+    putStr(w, "fact"); put32(w, 4); put32(w, frames);
+    putStr(w, "data"); put32(w, d.size());
+    w.insert(w.end(), d.begin(), d.end());
+    if(tail) {
+        putStr(w, "LIST"); put32(w, 16); putStr(w, "INFOISFT"); put32(w, 4); putStr(w, "tst");
+        w.push_back(0);
+    }
+
+    return w;
+}
+
+// QOA ------------------------------------------------------------
+
+static const int qoaDq[16][8] = {
+    {    1,    -1,    3,    -3,    5,    -5,     7,     -7 },
+    {    5,    -5,   18,   -18,   32,   -32,    49,    -49 },
+    {   16,   -16,   53,   -53,   95,   -95,   147,   -147 },
+    {   34,   -34,  113,  -113,  203,  -203,   315,   -315 },
+    {   63,   -63,  210,  -210,  378,  -378,   588,   -588 },
+    {  104,  -104,  345,  -345,  621,  -621,   966,   -966 },
+    {  158,  -158,  528,  -528,  950,  -950,  1477,  -1477 },
+    {  228,  -228,  760,  -760, 1368, -1368,  2128,  -2128 },
+    {  316,  -316, 1053, -1053, 1895, -1895,  2947,  -2947 },
+    {  422,  -422, 1405, -1405, 2529, -2529,  3934,  -3934 },
+    {  548,  -548, 1828, -1828, 3290, -3290,  5117,  -5117 },
+    {  696,  -696, 2320, -2320, 4176, -4176,  6496,  -6496 },
+    {  868,  -868, 2893, -2893, 5207, -5207,  8099,  -8099 },
+    { 1064, -1064, 3548, -3548, 6386, -6386,  9933,  -9933 },
+    { 1286, -1286, 4288, -4288, 7718, -7718, 12005, -12005 },
+    { 1536, -1536, 5120, -5120, 9216, -9216, 14336, -14336 }
+};
+
+struct Lms { int h[4], w[4]; };
+
+static int lmsPredict(const Lms &l)
+{
+    return (l.h[0] * l.w[0] + l.h[1] * l.w[1] + l.h[2] * l.w[2] + l.h[3] * l.w[3]) >> 13;
+}
+
+static void lmsUpdate(Lms &l, int s, int r)
+{
+    int d = r >> 4;
+
+    for(int i = 0; i < 4; i++) l.w[i] += l.h[i] < 0 ? -d : d;
+    l.h[0] = l.h[1]; l.h[1] = l.h[2]; l.h[2] = l.h[3]; l.h[3] = s;
+}
+
+static Bytes encQoa(const Samples &in, int ch, Samples &rec)
+{
+    size_t frames = in.size() / ch;
+    Bytes o;
+    Lms l[2];
+
+    for(int c = 0; c < 2; c++) {
+        memset(&l[c], 0, sizeof(Lms));
+        l[c].w[2] = -(1 << 13);
+        l[c].w[3] = 1 << 14;
+    }
+
+    putStr(o, "qoaf");
+    be32(o, frames);
+
+    for(size_t f = 0; f < frames; f += QOA_SLICE_LEN * QOA_SLICES) {
+        size_t fl = std::min<size_t>(QOA_SLICE_LEN * QOA_SLICES, frames - f);
+        size_t slices = (fl + QOA_SLICE_LEN - 1) / QOA_SLICE_LEN;
+        Samples fr(fl * 2);
+
+        o.push_back(ch); o.push_back(0); be16(o, 44100); be16(o, fl);
+        be16(o, 8 + 16 * ch + slices * 8 * ch);
+        for(int c = 0; c < ch; c++) {
+            for(int i = 0; i < 4; i++) be16(o, l[c].h[i]);
+            for(int i = 0; i < 4; i++) be16(o, l[c].w[i]);
+        }
+
+        for(size_t s = 0; s < fl; s += QOA_SLICE_LEN) {
+            size_t n = std::min<size_t>(QOA_SLICE_LEN, fl - s);
+            for(int c = 0; c < ch; c++) {
+                // Try all scale factors, keep the best
+                unsigned long long best = ~0ULL;
+                uint64_t bestSlice = 0;
+                Lms bestLms = l[c];
+                int16_t bestRec[QOA_SLICE_LEN];
+                for(int sf = 0; sf < 16; sf++) {
+                    Lms t = l[c];
+                    unsigned long long err = 0;
+                    uint64_t slice = sf;
+                    int16_t rr[QOA_SLICE_LEN];
+                    for(size_t i = 0; i < n; i++) {
+                        int x = in[(f + s + i) * ch + c], p = lmsPredict(t), res = x - p;
+                        int q = 0, qe = INT_MAX;
+                        for(int k = 0; k < 8; k++) {
+                            int e = abs(res - qoaDq[sf][k]);
+                            if(e < qe) { qe = e; q = k; }
+                        }
+                        int r = qoaDq[sf][q], y = clamp16(p + r);
+                        err += (long long)(x - y) * (x - y);
+                        lmsUpdate(t, y, r);
+                        slice = slice << 3 | q;
+                        rr[i] = y;
+                    }
+                    slice <<= (QOA_SLICE_LEN - n) * 3;
+                    if(err < best) {
+                        best = err;
+                        bestSlice = slice;
+                        bestLms = t;
+                        memcpy(bestRec, rr, sizeof(rr));
+                    }
+                }
+                l[c] = bestLms;
+                be32(o, bestSlice >> 32);
+                be32(o, bestSlice);
+                for(size_t i = 0; i < n; i++) {
+                    fr[(s + i) * 2 + c] = bestRec[i];
+                    if(ch == 1) fr[(s + i) * 2 + 1] = bestRec[i];
+                }
+            }
+        }
+        rec.insert(rec.end(), fr.begin(), fr.end());
+    }
+
+    return o;
+}
+
+// Decoding -------------------------------------------------------
+
+// Decode file; with loops, keep going for that many times its
+// length. Returns decode time.
+static double decode(const Bytes &file, Samples &out, size_t frames, int loops = 0)
+{
+    MemSrc src(&file);
+    Coll o;
+    AudioGeneratorWAVLoop g;
+
+    if(loops) o.max = frames * (loops + 1);
+
+    double t0 = now();
+    if(!g.begin(&src, &o)) return -1;
+    if(loops) src.loopStart = g.startPos;
+    while(g.loop() && o.s.size() / 2 < o.max) { }
+    double t = now() - t0;
+
+    out = o.s;
+
+    return t;
+}
+
+static bool same(const Samples &a, size_t offs, const Samples &b)
+{
+    return a.size() >= offs + b.size() && !memcmp(a.data() + offs, b.data(), b.size() * 2);
+}
+
+static void testPcm()
+{
+    for(int ch = 1; ch <= 2; ch++) {
+        Samples in = signal(ch, 10000), out;
+        Bytes f = encPcm(in, ch);
+        CHECK(decode(f, out, 10000) >= 0);
+        CHECK(same(out, 0, toStereo(in, ch)));
+    }
+}
+
+static void testAdpcm()
+{
+    for(int ch = 1; ch <= 2; ch++) {
+        int align = 512 * ch, spb = (align - 4 * ch) * 2 / ch + 1;
+        size_t frames = spb * 434;      // About 10s
+        Samples in = signal(ch, frames), rec, out;
+        Bytes f = encAdpcm(in, ch, align, rec);
+
+        double t = decode(f, out, frames);
+        CHECK(t >= 0);
+        CHECK(rec.size() == frames * 2);
+        CHECK(same(out, 0, rec));
+        printf("  ADPCM %s: %.2f:1, %.2fms per second of audio\n", ch == 1 ? "mono  " : "stereo",
+                        frames * 2.0 * ch / f.size(), t * 1000 / (frames / 44100.0));
+
+        // Loop: Second pass equal to first
+        CHECK(decode(f, out, frames, 1) >= 0);
+        CHECK(same(out, frames * 2, rec));
+
+        // Last block shorter than the others, another chunk after
+        // the data: Neither may end up in the middle of a block
+        frames = spb * 10 + 1 + 8 * 3;
+        in.resize(frames * ch);
+        rec.clear();
+        f = encAdpcm(in, ch, align, rec, true);
+        CHECK(rec.size() == frames * 2);
+        CHECK(decode(f, out, frames) >= 0);
+        CHECK(same(out, 0, rec) && out.size() == rec.size());
+        CHECK(decode(f, out, frames, 2) >= 0);
+        CHECK(same(out, frames * 2, rec) && same(out, frames * 4, rec));
+    }
+}
+
+static void testQoa()
+{
+    for(int ch = 1; ch <= 2; ch++) {
+        size_t frames = QOA_SLICE_LEN * QOA_SLICES * 86;    // About 10s
+        Samples in = signal(ch, frames), rec, out;
+        Bytes f = encQoa(in, ch, rec);
+
+        double t = decode(f, out, frames);
+        CHECK(t >= 0);
+        CHECK(same(out, 0, rec) && out.size() == rec.size());
+        printf("  QOA   %s: %.2f:1, %.2fms per second of audio\n", ch == 1 ? "mono  " : "stereo",
+                        frames * 2.0 * ch / f.size(), t * 1000 / (frames / 44100.0));
+
+        CHECK(decode(f, out, frames, 1) >= 0);
+        CHECK(same(out, frames * 2, rec));
+
+        // Last frame shorter than the others
+        in.resize((frames - 1234) * ch);
+        rec.clear();
+        f = encQoa(in, ch, rec);
+        CHECK(decode(f, out, frames - 1234) >= 0);
+        CHECK(same(out, 0, rec) && out.size() == rec.size());
+    }
+}
+
+int main()
+{
+    testPcm();
+    testAdpcm();
+    testQoa();
+
+    return testResult("wavloop");
+}
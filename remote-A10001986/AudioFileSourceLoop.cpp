@@ -47,12 +47,306 @@ AudioFileSourceSDLoop::AudioFileSourceSDLoop(const char *filename)
 }
 */
 
+#ifndef REMOTE_SD_READAHEAD
+
 bool AudioFileSourceSDLoop::open(const char *filename)
 {
     f = SD.open(filename, FILE_READ);
     return f;
 }
 
+#else
+
+/*
+ * Read-ahead
+ *
+ * A reader task fills a ring of SDRA_BUFS buffers from the file,
+ * SDRA_BUFSIZE bytes at a time, at sector-aligned positions. FatFs
+ * then transfers whole sectors directly into our buffer, using
+ * multi-block reads. The consumer (the decoder) only copies from
+ * RAM and only waits if the ring is empty.
+ * The file is accessed by the reader task only, except for open
+ * and close. Seeking is done by dropping the buffers and handing
+ * the new position to the reader.
+ */
+
+TaskHandle_t AudioFileSourceSDLoop::raTask = NULL;
+AudioFileSourceSDLoop *AudioFileSourceSDLoop::raSrcs[SDRA_MAXSRC] = { NULL };
+volatile uint32_t AudioFileSourceSDLoop::raWaits = 0;
+
+#define SDRA_SECMASK  511
+#define SDRA_TIMEOUT  2000      // ms to wait for data before giving up
+
+AudioFileSourceSDLoop::~AudioFileSourceSDLoop()
+{
+    close();
+
+    for(int i = 0; i < SDRA_BUFS; i++) {
+        if(raBuf[i]) {
+            free(raBuf[i]);
+            raBuf[i] = NULL;
+        }
+    }
+}
+
+void AudioFileSourceSDLoop::readerTask(void *parameter)
+{
+    for(;;) {
+        bool didRead = false;
+        for(int i = 0; i < SDRA_MAXSRC; i++) {
+            AudioFileSourceSDLoop *s = raSrcs[i];
+            if(s && s->fill()) didRead = true;
+        }
+        if(!didRead) {
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(50));
+        }
+    }
+}
+
+// Reader side: Fill one buffer. Returns true if the file was read.
+bool AudioFileSourceSDLoop::fill()
+{
+    uint32_t gen, pos, len;
+    bool doSeek = false;
+    int idx;
+
+    portENTER_CRITICAL(&raMux);
+    if(!raActive || raEOF || (uint8_t)(raIn - raOut) >= SDRA_BUFS) {
+        portEXIT_CRITICAL(&raMux);
+        return false;
+    }
+    if(raSeekReq) {
+        raFillPos = raSeekPos;
+        raSeekReq = false;
+        doSeek = true;
+    }
+    gen = raGen;
+    pos = raFillPos;
+    idx = raIn % SDRA_BUFS;
+    raBusy = true;
+    portEXIT_CRITICAL(&raMux);
+
+    // The buffer at raIn is not visible to the consumer until
+    // raIn is incremented, so we can fill it outside the lock.
+    if(doSeek) f.seek(pos);
+    len = f.read(raBuf[idx], SDRA_BUFSIZE);
+
+    portENTER_CRITICAL(&raMux);
+    // Drop result if consumer has seeked in the meantime
+    if(gen == raGen) {
+        raBufPos[idx] = pos;
+        raLen[idx] = len;
+        raFillPos = pos + len;
+        raEOF = (len < SDRA_BUFSIZE);
+        raIn++;
+    }
+    raBusy = false;
+    portEXIT_CRITICAL(&raMux);
+
+    return true;
+}
+
+// Consumer side: Drop all buffers, restart reader at pos
+void AudioFileSourceSDLoop::reset(uint32_t pos)
+{
+    portENTER_CRITICAL(&raMux);
+    raGen++;
+    raOut = raIn;
+    raSeekPos = pos & ~SDRA_SECMASK;
+    raSeekReq = true;
+    raEOF = false;
+    portEXIT_CRITICAL(&raMux);
+    
+    raOff = pos - raSeekPos;
+    raPos = pos;
+
+    if(raTask) xTaskNotifyGive(raTask);
+}
+
+bool AudioFileSourceSDLoop::open(const char *filename)
+{
+    int i;
+    
+    close();
+    
+    f = SD.open(filename, FILE_READ);
+    if(!f) return false;
+
+    if(!raTask) {
+        if(xTaskCreatePinnedToCore(readerTask, "sdread", 3072, NULL, 2, &raTask, 0) != pdPASS) {
+            raTask = NULL;
+            #ifdef REMOTE_DBG
+            Serial.println("SD: Failed to create read-ahead task");
+            #endif
+            return true;
+        }
+    }
+
+    // Buffers are allocated on first use and kept for the lifetime
+    // of the source. Without them, we read directly.
+    if(!raBuf[0]) {
+        for(i = 0; i < SDRA_BUFS; i++) {
+            if(!(raBuf[i] = (uint8_t *)malloc(SDRA_BUFSIZE))) break;
+        }
+        if(i < SDRA_BUFS) {
+            while(i--) { free(raBuf[i]); raBuf[i] = NULL; }
+            return true;
+        }
+    }
+    
+    raIn = raOut = 0;
+    reset(0);
+
+    portENTER_CRITICAL(&raMux);
+    raActive = true;
+    portEXIT_CRITICAL(&raMux);
+
+    for(i = 0; i < SDRA_MAXSRC; i++) {
+        if(!raSrcs[i]) {
+            raSrcs[i] = this;
+            break;
+        }
+    }
+    if(i == SDRA_MAXSRC) {
+        close();
+        f = SD.open(filename, FILE_READ);
+        return f;
+    }
+
+    xTaskNotifyGive(raTask);
+
+    return true;
+}
+
+bool AudioFileSourceSDLoop::close()
+{
+    bool busy;
+
+    portENTER_CRITICAL(&raMux);
+    raActive = false;
+    busy = raBusy;
+    portEXIT_CRITICAL(&raMux);
+
+    // Wait for reader to finish with the file
+    while(busy) {
+        vTaskDelay(1);
+        portENTER_CRITICAL(&raMux);
+        busy = raBusy;
+        portEXIT_CRITICAL(&raMux);
+    }
+
+    for(int i = 0; i < SDRA_MAXSRC; i++) {
+        if(raSrcs[i] == this) raSrcs[i] = NULL;
+    }
+
+    if(f) f.close();
+    
+    return true;
+}
+
+uint32_t AudioFileSourceSDLoop::read(void *data, uint32_t len)
+{
+    uint8_t *d = reinterpret_cast<uint8_t*>(data);
+    uint32_t got = 0;
+    unsigned long waitStart = 0;
+
+    if(!raActive) return AudioFileSourceLoop::read(data, len);
+
+    while(got < len) {
+        bool avail, eof;
+
+        portENTER_CRITICAL(&raMux);
+        avail = (raIn != raOut);
+        eof = raEOF;
+        portEXIT_CRITICAL(&raMux);
+        
+        if(!avail) {
+            if(eof) {
+                // All data consumed
+                if(!doPlayLoop) break;
+                reset(startPos);
+                continue;
+            }
+            // Ring empty, reader still busy: Wait
+            if(!waitStart) {
+                waitStart = millis();
+                raWaits++;
+            } else if(millis() - waitStart > SDRA_TIMEOUT) {
+                #ifdef REMOTE_DBG
+                Serial.println("SD: Read-ahead timeout");
+                #endif
+                break;
+            }
+            xTaskNotifyGive(raTask);
+            vTaskDelay(1);
+            continue;
+        }
+
+        int idx = raOut % SDRA_BUFS;
+        uint32_t n = (raOff < raLen[idx]) ? raLen[idx] - raOff : 0;
+        if(n > len - got) n = len - got;
+        memcpy(d + got, raBuf[idx] + raOff, n);
+        got += n;
+        raOff += n;
+        raPos += n;
+
+        if(raOff >= raLen[idx]) {
+            // Buffer consumed, hand it back to reader
+            raOff = 0;
+            portENTER_CRITICAL(&raMux);
+            raOut++;
+            portEXIT_CRITICAL(&raMux);
+            xTaskNotifyGive(raTask);
+        }
+    }
+
+    return got;
+}
+
+bool AudioFileSourceSDLoop::seek(int32_t pos, int dir)
+{
+    if(!raActive) return AudioFileSourceLoop::seek(pos, dir);
+
+    if(dir == SEEK_CUR)      pos += raPos;
+    else if(dir == SEEK_END) pos += f.size();
+    else if(dir != SEEK_SET) return false;
+    
+    if(pos < 0 || (uint32_t)pos > f.size()) return false;
+
+    // Skip forward within buffered data if possible
+    for(;;) {
+        bool avail;
+        portENTER_CRITICAL(&raMux);
+        avail = (raIn != raOut);
+        portEXIT_CRITICAL(&raMux);
+        if(!avail) break;
+        
+        int idx = raOut % SDRA_BUFS;
+        if((uint32_t)pos < raBufPos[idx]) break;
+        if((uint32_t)pos < raBufPos[idx] + raLen[idx]) {
+            raOff = pos - raBufPos[idx];
+            raPos = pos;
+            return true;
+        }
+        raOff = 0;
+        portENTER_CRITICAL(&raMux);
+        raOut++;
+        portEXIT_CRITICAL(&raMux);
+    }
+
+    reset(pos);
+    
+    return true;
+}
+
+uint32_t AudioFileSourceSDLoop::getPos()
+{
+    if(!raActive) return AudioFileSourceLoop::getPos();
+    return raPos;
+}
+
+#endif
+
 // FlashFS -------------------------------------------
 
 AudioFileSourceFSLoop::AudioFileSourceFSLoop()
@@ -66,8 +360,141 @@ AudioFileSourceFSLoop::AudioFileSourceFSLoop(const char *filename)
 }
 */
 
+#ifndef REMOTE_SND_PART
+
 bool AudioFileSourceFSLoop::open(const char *filename)
 {
     f = LittleFS.open(filename, FILE_READ);
     return f;
 }
+
+#else
+
+/*
+ * Sound partition
+ *
+ * The partition is mapped into the data address space once; a file
+ * is then just a pointer and a length, reads are plain copies out of
+ * the flash cache.
+ */
+
+const esp_partition_t *AudioFileSourceFSLoop::sndPart = NULL;
+const uint8_t *AudioFileSourceFSLoop::sndBase = NULL;
+const SndP_Hdr *AudioFileSourceFSLoop::sndHdr = NULL;
+
+const esp_partition_t *AudioFileSourceFSLoop::findPart()
+{
+    if(!sndPart) {
+        sndPart = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, 
+                      (esp_partition_subtype_t)SNDP_SUBTYPE, SNDP_LABEL);
+    }
+    return sndPart;
+}
+
+// Returns true if the partition holds a complete sound-pack
+bool AudioFileSourceFSLoop::mountPart()
+{
+    spi_flash_mmap_handle_t handle;
+    const void *ptr;
+    const SndP_Hdr *h;
+
+    if(!findPart())
+        return false;
+
+    if(!sndBase) {
+        if(esp_partition_mmap(sndPart, 0, sndPart->size, SPI_FLASH_MMAP_DATA, &ptr, &handle) != ESP_OK) {
+            #ifdef REMOTE_DBG
+            Serial.println("Failed to map sound partition");
+            #endif
+            return false;
+        }
+        sndBase = (const uint8_t *)ptr;
+    }
+
+    h = (const SndP_Hdr *)sndBase;
+    if(h->magic != SNDP_MAGIC || h->count > SNDP_MAXENT || 
+       h->size < SNDP_DIRSIZE || h->size > sndPart->size) {
+        sndHdr = NULL;
+        return false;
+    }
+    
+    sndHdr = h;
+
+    #ifdef REMOTE_DBG
+    Serial.printf("Sound partition: %d files, %d bytes\n", h->count, h->size);
+    #endif
+    
+    return true;
+}
+
+const uint8_t *AudioFileSourceFSLoop::partFile(const char *fn, uint32_t *len)
+{
+    const SndP_Ent *e;
+    
+    if(!sndHdr)
+        return NULL;
+
+    e = (const SndP_Ent *)(sndHdr + 1);
+    for(uint32_t i = 0; i < sndHdr->count; i++, e++) {
+        if(!strncmp(e->fn, fn, SNDP_FNLEN)) {
+            if(e->offs < SNDP_DIRSIZE || e->offs + e->len > sndHdr->size)
+                return NULL;
+            *len = e->len;
+            return sndBase + e->offs;
+        }
+    }
+
+    return NULL;
+}
+
+bool AudioFileSourceFSLoop::open(const char *filename)
+{
+    if((mem = partFile(filename, &memLen))) {
+        if(f) f.close();
+        memPos = 0;
+        return true;
+    }
+    f = LittleFS.open(filename, FILE_READ);
+    return f;
+}
+
+uint32_t AudioFileSourceFSLoop::memRead(uint8_t *data, uint32_t len)
+{
+    if(len > memLen - memPos) len = memLen - memPos;
+    memcpy(data, mem + memPos, len);
+    memPos += len;
+    return len;
+}
+
+uint32_t AudioFileSourceFSLoop::read(void *data, uint32_t len)
+{
+    uint32_t glen;
+    
+    if(!mem) return AudioFileSourceLoop::read(data, len);
+    
+    glen = memRead(reinterpret_cast<uint8_t*>(data), len);
+    if(!doPlayLoop || glen == len) return glen;
+    memPos = startPos;
+    return glen + memRead(reinterpret_cast<uint8_t*>(data) + glen, len - glen);
+}
+
+bool AudioFileSourceFSLoop::seek(int32_t pos, int dir)
+{
+    if(!mem) return AudioFileSourceLoop::seek(pos, dir);
+    
+    if(dir == SEEK_CUR)      pos += memPos;
+    else if(dir == SEEK_END) pos += memLen;
+    else if(dir != SEEK_SET) return false;
+    if(pos < 0 || pos > (int32_t)memLen) return false;
+    memPos = pos;
+    return true;
+}
+
+bool AudioFileSourceFSLoop::close()
+{
+    mem = NULL;
+    f.close();
+    return true;
+}
+
+#endif
@@ -12,9 +12,13 @@
 #ifndef _AudioFileSourceLoop_H
 #define _AudioFileSourceLoop_H
 
+#include "remote_global.h"
 #include "src/ESP8266Audio/AudioFileSource.h"
 #include "src/SD/SD.h"
 #include <LittleFS.h>
+#ifdef REMOTE_SND_PART
+#include <esp_partition.h>
+#endif
 
 class AudioFileSourceLoop : public AudioFileSource
 {
@@ -38,6 +42,12 @@ class AudioFileSourceLoop : public AudioFileSource
     bool    doPlayLoop = false;
 };
 
+#ifdef REMOTE_SD_READAHEAD
+#define SDRA_BUFS     2         // Number of read-ahead buffers
+#define SDRA_BUFSIZE  8192      // Size of each buffer; multiple of sector size
+#define SDRA_MAXSRC   2         // Max number of concurrently open sources
+#endif
+
 class AudioFileSourceSDLoop : public AudioFileSourceLoop
 {
   public:
@@ -45,8 +55,71 @@ class AudioFileSourceSDLoop : public AudioFileSourceLoop
     //AudioFileSourceSDLoop(const char *filename);
     
     bool open(const char *filename) override;
+    #ifdef REMOTE_SD_READAHEAD
+    ~AudioFileSourceSDLoop();
+    uint32_t read(void *data, uint32_t len) override;
+    bool seek(int32_t pos, int dir) override;
+    bool close() override;
+    uint32_t getPos() override;
+
+    static uint32_t getWaits() { return raWaits; }
+
+  private:
+    static void readerTask(void *parameter);
+    bool fill();
+    void reset(uint32_t pos);
+
+    static TaskHandle_t raTask;
+    static AudioFileSourceSDLoop *raSrcs[SDRA_MAXSRC];
+    static volatile uint32_t raWaits;
+
+    portMUX_TYPE raMux = portMUX_INITIALIZER_UNLOCKED;
+
+    uint8_t  *raBuf[SDRA_BUFS] = { NULL };  // From first open() to destruction
+    uint32_t raBufPos[SDRA_BUFS];   // File position of buffer start
+    uint32_t raLen[SDRA_BUFS];      // Valid bytes in buffer
+    volatile uint8_t raIn = 0;      // Buffers filled (reader)
+    volatile uint8_t raOut = 0;     // Buffers consumed (consumer)
+    volatile uint32_t raGen = 0;    // Incremented on each seek
+    volatile bool raActive = false;
+    volatile bool raBusy = false;   // Reader is accessing the file
+    volatile bool raEOF = false;    // Reader has reached end of file
+    bool     raSeekReq = false;
+    uint32_t raSeekPos = 0;         // Sector-aligned position for reader
+    uint32_t raFillPos = 0;         // Reader's file position
+    uint32_t raOff = 0;             // Consumer's offset in current buffer
+    uint32_t raPos = 0;             // Consumer's file position
+    #endif
 };
 
+#ifdef REMOTE_SND_PART
+// Sound partition: Header and directory in the first sector, file
+// data follows (4-byte aligned). The installer writes the header
+// last, so an interrupted install leaves no valid header.
+#define SNDP_LABEL    "rmaudio"
+#define SNDP_SUBTYPE  0x40
+#define SNDP_MAGIC    0x50414d52    // "RMAP"
+#define SNDP_DIRSIZE  4096
+#define SNDP_FNLEN    36
+
+typedef struct {
+    uint32_t magic;
+    uint32_t count;       // Directory entries
+    uint32_t size;        // Bytes used, including directory
+    uint32_t reserved;
+} SndP_Hdr;
+
+typedef struct {
+    char     fn[SNDP_FNLEN];
+    uint32_t offs;        // From start of partition
+    uint32_t len;
+} SndP_Ent;
+
+#define SNDP_MAXENT ((SNDP_DIRSIZE - sizeof(SndP_Hdr)) / sizeof(SndP_Ent))
+#endif
+
+// Built-in sounds: From the sound partition if present, otherwise 
+// from the flash FS
 class AudioFileSourceFSLoop : public AudioFileSourceLoop
 {
   public:
@@ -54,6 +127,30 @@ class AudioFileSourceFSLoop : public AudioFileSourceLoop
     //AudioFileSourceFSLoop(const char *filename);
     
     bool open(const char *filename) override;
+    #ifdef REMOTE_SND_PART
+    uint32_t read(void *data, uint32_t len) override;
+    bool seek(int32_t pos, int dir) override;
+    bool close() override;
+    bool isOpen() override                { return mem || f; }
+    uint32_t getSize() override           { return mem ? memLen : AudioFileSourceLoop::getSize(); }
+    uint32_t getPos() override            { return mem ? memPos : AudioFileSourceLoop::getPos(); }
+
+    static const esp_partition_t *findPart();
+    static bool mountPart();
+    static void unmountPart()             { sndHdr = NULL; }
+    static const uint8_t *partFile(const char *fn, uint32_t *len);
+
+  private:
+    uint32_t memRead(uint8_t *data, uint32_t len);
+    
+    static const esp_partition_t *sndPart;
+    static const uint8_t *sndBase;
+    static const SndP_Hdr *sndHdr;        // NULL if not mounted/invalid
+
+    const uint8_t *mem = NULL;
+    uint32_t memLen = 0;
+    uint32_t memPos = 0;
+    #endif
 };
 
 #endif
@@ -1,6 +1,7 @@
 /*
   AudioGeneratorWAVLoop
-  Audio output generator that reads 8 and 16-bit WAV files
+  Audio output generator that reads 8 and 16-bit WAV files,
+  IMA-ADPCM WAV files and QOA files
   
   Copyright (C) 2017  Earle F. Philhower, III
   Adapted by Thomas Winischhofer (A10001986), 2023/2025
@@ -26,12 +27,82 @@
 //define DBG_OUT audioLogger->printf_P
 #endif
 
+// IMA-ADPCM step sizes and step index adjustment
+static const int16_t imaStepTab[89] = {
+        7,     8,     9,    10,    11,    12,    13,    14,    16,    17,
+       19,    21,    23,    25,    28,    31,    34,    37,    41,    45,
+       50,    55,    60,    66,    73,    80,    88,    97,   107,   118,
+      130,   143,   157,   173,   190,   209,   230,   253,   279,   307,
+      337,   371,   408,   449,   494,   544,   598,   658,   724,   796,
+      876,   963,  1060,  1166,  1282,  1411,  1552,  1707,  1878,  2066,
+     2272,  2499,  2749,  3024,  3327,  3660,  4026,  4428,  4871,  5358,
+     5894,  6484,  7132,  7845,  8630,  9493, 10442, 11487, 12635, 13899,
+    15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+static const int8_t imaIndexTab[8] = { -1, -1, -1, -1, 2, 4, 6, 8 };
+
+// QOA: Residuals for each scale factor and quantized value
+// (https://qoaformat.org)
+static const int16_t qoaDequantTab[16][8] = {
+    {    1,    -1,    3,    -3,    5,    -5,     7,     -7 },
+    {    5,    -5,   18,   -18,   32,   -32,    49,    -49 },
+    {   16,   -16,   53,   -53,   95,   -95,   147,   -147 },
+    {   34,   -34,  113,  -113,  203,  -203,   315,   -315 },
+    {   63,   -63,  210,  -210,  378,  -378,   588,   -588 },
+    {  104,  -104,  345,  -345,  621,  -621,   966,   -966 },
+    {  158,  -158,  528,  -528,  950,  -950,  1477,  -1477 },
+    {  228,  -228,  760,  -760, 1368, -1368,  2128,  -2128 },
+    {  316,  -316, 1053, -1053, 1895, -1895,  2947,  -2947 },
+    {  422,  -422, 1405, -1405, 2529, -2529,  3934,  -3934 },
+    {  548,  -548, 1828, -1828, 3290, -3290,  5117,  -5117 },
+    {  696,  -696, 2320, -2320, 4176, -4176,  6496,  -6496 },
+    {  868,  -868, 2893, -2893, 5207, -5207,  8099,  -8099 },
+    { 1064, -1064, 3548, -3548, 6386, -6386,  9933,  -9933 },
+    { 1286, -1286, 4288, -4288, 7718, -7718, 12005, -12005 },
+    { 1536, -1536, 5120, -5120, 9216, -9216, 14336, -14336 }
+};
+
+static inline int16_t clamp16(int32_t v)
+{
+    if(v < -32768) return -32768;
+    if(v > 32767)  return 32767;
+    return v;
+}
+
+static inline int16_t imaDecode(int32_t *pred, int8_t *index, uint8_t n)
+{
+    int32_t step = imaStepTab[*index];
+    int32_t diff = step >> 3;
+    
+    if(n & 4) diff += step;
+    if(n & 2) diff += step >> 1;
+    if(n & 1) diff += step >> 2;
+    *pred = clamp16((n & 8) ? *pred - diff : *pred + diff);
+    
+    *index += imaIndexTab[n & 7];
+    if(*index < 0) *index = 0;
+    else if(*index > 88) *index = 88;
+    
+    return *pred;
+}
+
+static inline uint16_t rdBE16(const uint8_t *p)
+{
+    return (p[0] << 8) | p[1];
+}
+
+static inline uint32_t rdBE32(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+}
+
 AudioGeneratorWAVLoop::AudioGeneratorWAVLoop()
 {
     running = false;
     file = NULL;
     output = NULL;
-    buffSize = 128;
+    buffSize = AUDIO_BLOCK_FRAMES * 4;
+    format = WAVLOOP_FMT_PCM;
     buff = NULL;
     buffPtr = 0;
     buffLen = 0;
@@ -63,89 +134,248 @@ bool AudioGeneratorWAVLoop::freeBuf()
     return false;
 }
 
-// Handle buffered reading, reload each time we run out of data
-bool AudioGeneratorWAVLoop::GetBufferedData16x2(int16_t& destL, int16_t& destR)
+// Set up the next block of frames, reload buffer each time we run out
+// of data. 16 bit stereo is handed to the output straight from the
+// buffer; everything else is converted into blk[].
+bool AudioGeneratorWAVLoop::FillBlock()
 {
+    if(format == WAVLOOP_FMT_ADPCM) return FillADPCM();
+    if(format == WAVLOOP_FMT_QOA) return FillQOA();
+    
     if(buffPtr >= buffLen) {
         buffPtr = 0;
-        //uint32_t toRead = availBytes > buffSize ? buffSize : availBytes;
-        //buffLen = file->read( buff, toRead );
-        //availBytes -= buffLen;
         buffLen = file->read( buff, buffSize );
         if(buffPtr >= buffLen)
             return false; // No data left!
     }
-    destL = *(int16_t *)(buff+buffPtr);
-    buffPtr += 2;
-    destR = *(int16_t *)(buff+buffPtr);
-    buffPtr += 2;
-    return true;
+
+    int frames = 0;
+
+    if(bitsPerSample == 16 && channels == 2) {
+        frames = (buffLen - buffPtr) >> 2;
+        blkPtr = (const int16_t *)(buff + buffPtr);
+        buffPtr = buffLen;
+    } else {
+        int16_t *dst = blk;
+        blkPtr = blk;
+        if(bitsPerSample == 16) {
+            while(frames < AUDIO_BLOCK_FRAMES && buffPtr + 2 <= buffLen) {
+                int16_t s = *(int16_t *)(buff+buffPtr);
+                buffPtr += 2;
+                *dst++ = s;
+                *dst++ = s;
+                frames++;
+            }
+        } else if(channels == 2) {
+            while(frames < AUDIO_BLOCK_FRAMES && buffPtr + 2 <= buffLen) {
+                *dst++ = ((int16_t)buff[buffPtr++] - 128) << 8;
+                *dst++ = ((int16_t)buff[buffPtr++] - 128) << 8;
+                frames++;
+            }
+        } else {
+            while(frames < AUDIO_BLOCK_FRAMES && buffPtr < buffLen) {
+                int16_t s = ((int16_t)buff[buffPtr++] - 128) << 8;
+                *dst++ = s;
+                *dst++ = s;
+                frames++;
+            }
+        }
+        // Drop trailing partial frame
+        if(!frames) buffPtr = buffLen;
+    }
+
+    blkFrames = frames;
+    return (frames > 0);
 }
 
-bool AudioGeneratorWAVLoop::GetBufferedData16(int16_t& dest)
+// IMA-ADPCM: Each block starts with a header per channel (first
+// sample, step index), followed by 4-bit codes, low nibble first.
+// In stereo files, channels alternate every 4 bytes (8 samples).
+// The last block may be shorter; it is read up to the end of the
+// data chunk only. Looped playback then starts over at startPos,
+// on a block boundary.
+bool AudioGeneratorWAVLoop::FillADPCM()
 {
-    if(buffPtr >= buffLen) {
-        buffPtr = 0;
-        //uint32_t toRead = availBytes > buffSize ? buffSize : availBytes;
-        //buffLen = file->read( buff, toRead );
-        //availBytes -= buffLen;
-        buffLen = file->read( buff, buffSize );
-        if(buffPtr >= buffLen)
-            return false; // No data left!
+    int16_t *dst = blk;
+    int frames = 0;
+
+    blkPtr = blk;
+
+    while(frames <= AUDIO_BLOCK_FRAMES - 8) {
+        
+        if(buffPtr >= buffLen) {
+            uint32_t len = blockAlign;
+            if(!dataLeft) {
+                // Looping sources wrap to startPos when read at their
+                // end; others return nothing
+                file->seek(0, SEEK_END);
+                dataLeft = dataSize;
+            }
+            if(len > dataLeft) len = dataLeft;
+            buffPtr = 0;
+            buffLen = file->read(buff, len);
+            dataLeft -= buffLen;
+            if(buffLen <= 4 * channels) {
+                buffLen = 0;
+                break;
+            }
+            for(int c = 0; c < channels; c++) {
+                adPred[c] = (int16_t)(buff[c*4] | (buff[c*4+1] << 8));
+                adIndex[c] = buff[c*4+2] > 88 ? 88 : buff[c*4+2];
+            }
+            *dst++ = adPred[0];
+            *dst++ = adPred[channels - 1];
+            frames++;
+            buffPtr = 4 * channels;
+        }
+
+        if(channels == 1) {
+            uint8_t b = buff[buffPtr++];
+            int16_t s = imaDecode(&adPred[0], &adIndex[0], b & 0x0f);
+            *dst++ = s;
+            *dst++ = s;
+            s = imaDecode(&adPred[0], &adIndex[0], b >> 4);
+            *dst++ = s;
+            *dst++ = s;
+            frames += 2;
+        } else if(buffPtr + 8 <= buffLen) {
+            for(int c = 0; c < 2; c++) {
+                int16_t *d = dst + c;
+                for(int i = 0; i < 4; i++) {
+                    uint8_t b = buff[buffPtr++];
+                    *d = imaDecode(&adPred[c], &adIndex[c], b & 0x0f);
+                    d += 2;
+                    *d = imaDecode(&adPred[c], &adIndex[c], b >> 4);
+                    d += 2;
+                }
+            }
+            dst += 16;
+            frames += 8;
+        } else {
+            // Drop truncated group
+            buffPtr = buffLen;
+        }
     }
-    dest = *(int16_t *)(buff+buffPtr);
-    buffPtr += 2;
-    return true;
+
+    blkFrames = frames;
+    return (frames > 0);
 }
 
-bool AudioGeneratorWAVLoop::GetBufferedData8(uint8_t& dest)
+// QOA: Read the next frame into buff and set up the LMS state
+bool AudioGeneratorWAVLoop::ReadQOAFrame()
 {
-    if(buffPtr >= buffLen) {
-        buffPtr = 0;
-        //uint32_t toRead = availBytes > buffSize ? buffSize : availBytes;
-        //buffLen = file->read( buff, toRead );
-        //availBytes -= buffLen;
-        buffLen = file->read( buff, buffSize );
-        if(buffPtr >= buffLen)
-            return false; // No data left!
+    uint16_t fsize, hsize = 8 + 16 * channels;
+    uint16_t maxSize = hsize + QOA_SLICES * 8 * channels;
+
+    if(file->read(buff, 8) != 8)
+        return false;
+
+    fsize = rdBE16(buff + 6);
+    if(buff[0] != channels || fsize < hsize || fsize > maxSize) {
+        DBG_OUT(PSTR("AudioGeneratorWAVLoop::ReadQOAFrame: bad frame header\n"));
+        return false;
     }
-    dest = (uint8_t)buff[buffPtr++];
+    
+    if(file->read(buff + 8, fsize - 8) != (uint32_t)(fsize - 8))
+        return false;
+
+    for(int c = 0; c < channels; c++) {
+        const uint8_t *p = buff + 8 + c * 16;
+        for(int i = 0; i < 4; i++) {
+            qoaHist[c][i] = (int16_t)rdBE16(p + i*2);
+            qoaWeights[c][i] = (int16_t)rdBE16(p + 8 + i*2);
+        }
+    }
+
+    // Don't trust the sample count beyond what the frame holds
+    qoaLeft = rdBE16(buff + 4);
+    if(qoaLeft > ((fsize - hsize) / (8 * channels)) * QOA_SLICE_LEN) {
+        qoaLeft = ((fsize - hsize) / (8 * channels)) * QOA_SLICE_LEN;
+    }
+    
+    buffPtr = hsize;
+    buffLen = fsize;
+
     return true;
 }
 
+// QOA: Each slice (64 bits per channel, channels interleaved) holds
+// a 4-bit scale factor and 20 3-bit residuals. The prediction comes
+// from a 4-tap LMS filter per channel.
+bool AudioGeneratorWAVLoop::FillQOA()
+{
+    int16_t *dst = blk;
+    int frames = 0;
+
+    blkPtr = blk;
+
+    while(frames <= AUDIO_BLOCK_FRAMES - QOA_SLICE_LEN) {
+        
+        if(!qoaLeft) {
+            if(!ReadQOAFrame()) {
+                qoaLeft = 0;
+                break;
+            }
+            if(!qoaLeft) continue;
+        }
+
+        int n = (qoaLeft < QOA_SLICE_LEN) ? qoaLeft : QOA_SLICE_LEN;
+
+        for(int c = 0; c < channels; c++) {
+            const int16_t *dq;
+            int32_t *h = qoaHist[c];
+            int32_t *w = qoaWeights[c];
+            int16_t *d = dst + c;
+            uint64_t slice = ((uint64_t)rdBE32(buff + buffPtr) << 32) | rdBE32(buff + buffPtr + 4);
+            
+            buffPtr += 8;
+            dq = qoaDequantTab[slice >> 60];
+            
+            for(int i = 0; i < n; i++) {
+                int32_t p = (h[0] * w[0] + h[1] * w[1] + h[2] * w[2] + h[3] * w[3]) >> 13;
+                int32_t r = dq[(slice >> 57) & 7];
+                int32_t s = clamp16(p + r);
+                int32_t delta = r >> 4;
+                
+                slice <<= 3;
+                
+                w[0] += (h[0] < 0) ? -delta : delta;
+                w[1] += (h[1] < 0) ? -delta : delta;
+                w[2] += (h[2] < 0) ? -delta : delta;
+                w[3] += (h[3] < 0) ? -delta : delta;
+                h[0] = h[1]; h[1] = h[2]; h[2] = h[3]; h[3] = s;
+                
+                *d = s;
+                d += 2;
+            }
+        }
+
+        if(channels == 1) {
+            for(int i = 0; i < n; i++) {
+                dst[i*2+1] = dst[i*2];
+            }
+        }
+
+        dst += n * 2;
+        frames += n;
+        qoaLeft -= n;
+    }
+
+    blkFrames = frames;
+    return (frames > 0);
+}
+
 bool AudioGeneratorWAVLoop::loop()
 {
     if(!running) goto done; // Nothing to do here!
 
-    // First, try and push in the stored sample.  If we can't, then punt and try later
-    if(!output->ConsumeSample(sL, sR)) goto done; // Can't send, but no error detected
-
-    // Try and stuff the buffer one sample at a time
-    // TW: Unroll this
-    if(bitsPerSample == 16) {
-        if(channels == 2) {
-            do
-            {
-                if(!GetBufferedData16x2(sL, sR)) stop();
-            } while (running && output->ConsumeSample(sL, sR));
-        } else {
-            sR = 0;
-            do
-            {
-                if(!GetBufferedData16(sL)) stop();
-            } while (running && output->ConsumeSample(sL, sR));
+    // First, try and push out the pending block. If we can't, then punt
+    // and try later. Then refill and send blocks until the output is full.
+    while(FlushBlock()) {
+        if(!FillBlock()) {
+            stop();
+            break;
         }
-    } else if(bitsPerSample == 8) {
-        uint8_t l, r = 0;
-        do
-        {
-            if(!GetBufferedData8(l)) stop();
-            sL = ((int16_t)l - 128) << 8;
-            if(channels == 2) {
-                if(!GetBufferedData8(r)) stop();
-                sR = ((int16_t)r - 128) << 8;
-            }
-        } while (running && output->ConsumeSample(sL, sR));
     }
 
 done:
@@ -159,6 +389,7 @@ bool AudioGeneratorWAVLoop::ReadWAVInfo()
 {
     uint32_t u32;
     uint16_t u16;
+    uint32_t bufSz = buffSize;
     int toSkip;
   
     // WAV specification document:
@@ -169,6 +400,10 @@ bool AudioGeneratorWAVLoop::ReadWAVInfo()
         DBG_OUT(PSTR("AudioGeneratorWAVLoop::ReadWAVInfo: failed to read WAV data\n"));
         return false;
     };
+    if(u32 == 0x66616f71) {
+        // TW: "qoaf"
+        return ReadQOAInfo();
+    }
     if(u32 != 0x46464952) {
         DBG_OUT(PSTR("AudioGeneratorWAVLoop::ReadWAVInfo: cannot read WAV, invalid RIFF header, got: %08X \n"), (uint32_t) u32);
         return false;
@@ -206,6 +441,7 @@ bool AudioGeneratorWAVLoop::ReadWAVInfo()
     };
     if(u32 == 16) { toSkip = 0; }
     else if(u32 == 18) { toSkip = 18 - 16; }
+    else if(u32 == 20) { toSkip = 20 - 16; }   // TW: ADPCM
     else if(u32 == 40) { toSkip = 40 - 16; }
     else {
         DBG_OUT(PSTR("AudioGeneratorWAVLoop::ReadWAVInfo: cannot read WAV, appears not to be standard PCM \n"));
@@ -217,10 +453,11 @@ bool AudioGeneratorWAVLoop::ReadWAVInfo()
         DBG_OUT(PSTR("AudioGeneratorWAVLoop::ReadWAVInfo: failed to read WAV data\n"));
         return false;
     };
-    if(u16 != 1) {
-        DBG_OUT(PSTR("AudioGeneratorWAVLoop::ReadWAVInfo: cannot read WAV, AudioFormat appears not to be standard PCM \n"));
+    if(u16 != WAVLOOP_FMT_PCM && u16 != WAVLOOP_FMT_ADPCM) {
+        DBG_OUT(PSTR("AudioGeneratorWAVLoop::ReadWAVInfo: cannot read WAV, AudioFormat appears not to be standard PCM or IMA-ADPCM \n"));
         return false;
-    } // we only do standard PCM
+    } // we only do standard PCM and IMA-ADPCM
+    format = u16;
   
     // NumChannels
     if(!ReadU16(&channels)) {
@@ -242,12 +479,12 @@ bool AudioGeneratorWAVLoop::ReadWAVInfo()
         return false;
     }  // Weird rate, punt.  Will need to check w/DAC to see if supported
   
-    // Ignore byterate and blockalign
+    // Ignore byterate
     if(!ReadU32(&u32)) {
         DBG_OUT(PSTR("AudioGeneratorWAVLoop::ReadWAVInfo: failed to read WAV data\n"));
         return false;
     };
-    if(!ReadU16(&u16)) {
+    if(!ReadU16(&blockAlign)) {
         DBG_OUT(PSTR("AudioGeneratorWAVLoop::ReadWAVInfo: failed to read WAV data\n"));
         return false;
     };
@@ -257,7 +494,18 @@ bool AudioGeneratorWAVLoop::ReadWAVInfo()
         DBG_OUT(PSTR("AudioGeneratorWAVLoop::ReadWAVInfo: failed to read WAV data\n"));
         return false;
     };
-    if((bitsPerSample!=8) && (bitsPerSample != 16)) {
+    if(format == WAVLOOP_FMT_ADPCM) {
+        if(bitsPerSample != 4) {
+            DBG_OUT(PSTR("AudioGeneratorWAVLoop::ReadWAVInfo: cannot read WAV, only 4 bit ADPCM is supported \n"));
+            return false;
+        }
+        if((blockAlign <= 4 * channels) || (blockAlign % (4 * channels)) || (blockAlign > WAVLOOP_MAXBLOCK)) {
+            DBG_OUT(PSTR("AudioGeneratorWAVLoop::ReadWAVInfo: cannot read WAV, unsupported ADPCM block size \n"));
+            return false;
+        }
+        // Buffer holds one block
+        bufSz = blockAlign;
+    } else if((bitsPerSample!=8) && (bitsPerSample != 16)) {
         DBG_OUT(PSTR("AudioGeneratorWAVLoop::ReadWAVInfo: cannot read WAV, only 8 or 16 bits is supported \n"));
         return false;
     }  // Only 8 or 16 bits
@@ -304,9 +552,14 @@ bool AudioGeneratorWAVLoop::ReadWAVInfo()
   
     // TW: Set current pos as loop start pos
     startPos = file->getPos();
+
+    // TW: Don't trust the data size beyond the end of the file
+    dataSize = file->getSize() - startPos;
+    if(u32 && u32 < dataSize) dataSize = u32;
+    dataLeft = dataSize;
   
     // Now set up the buffer or fail
-    buff = reinterpret_cast<uint8_t *>(malloc(buffSize));
+    buff = reinterpret_cast<uint8_t *>(malloc(bufSz));
     if(!buff) {
         DBG_OUT(PSTR("AudioGeneratorWAVLoop::ReadWAVInfo: cannot read WAV, failed to set up buffer \n"));
         return false;
@@ -314,8 +567,53 @@ bool AudioGeneratorWAVLoop::ReadWAVInfo()
     buffPtr = 0;
     buffLen = 0;
 
-    // loop starts by pushing out samples, clear them here
-    sL = sR = 0;
+    // loop starts by pushing out the pending block, clear it here
+    blkFrames = 0;
+  
+    return true;
+}
+
+// TW: QOA file: "qoaf", number of samples per channel (ignored),
+// frames. Every frame has a header with channels and rate, and the
+// filter state; so the loop start is the first frame.
+bool AudioGeneratorWAVLoop::ReadQOAInfo()
+{
+    uint8_t hdr[8];
+    uint32_t bufSz;
+
+    format = WAVLOOP_FMT_QOA;
+    bitsPerSample = 16;
+    
+    // Skip sample count, peek at first frame header
+    if(file->read(hdr, 4) != 4 || file->read(hdr, 8) != 8) {
+        DBG_OUT(PSTR("AudioGeneratorWAVLoop::ReadQOAInfo: failed to read QOA data\n"));
+        return false;
+    }
+    channels = hdr[0];
+    sampleRate = (hdr[1] << 16) | (hdr[2] << 8) | hdr[3];
+    if((channels < 1) || (channels > 2) || (sampleRate < 1)) {
+        DBG_OUT(PSTR("AudioGeneratorWAVLoop::ReadQOAInfo: cannot read QOA, only mono and stereo are supported \n"));
+        return false;
+    }
+
+    startPos = 8;
+    if(!file->seek(startPos, SEEK_SET)) {
+        DBG_OUT(PSTR("AudioGeneratorWAVLoop::ReadQOAInfo: failed to read QOA data, seek failed\n"));
+        return false;
+    }
+
+    // Buffer holds one full frame
+    bufSz = 8 + 16 * channels + QOA_SLICES * 8 * channels;
+    buff = reinterpret_cast<uint8_t *>(malloc(bufSz));
+    if(!buff) {
+        DBG_OUT(PSTR("AudioGeneratorWAVLoop::ReadQOAInfo: cannot read QOA, failed to set up buffer \n"));
+        return false;
+    };
+    buffPtr = 0;
+    buffLen = 0;
+    qoaLeft = 0;
+    
+    blkFrames = 0;
   
     return true;
 }
@@ -365,14 +663,15 @@ bool AudioGeneratorWAVLoop::begin(AudioFileSource *source, AudioOutput *output)
     return true;
 }
 
-bool AudioGeneratorWAVLoop::beginQuick(AudioFileSource *source, AudioOutput *output, int chnls, uint32_t stPos)
+bool AudioGeneratorWAVLoop::beginQuick(AudioFileSource *source, AudioOutput *output, int chnls, uint32_t stPos, uint32_t rate)
 {
     file = source;
     this->output = output;
     
+    format = WAVLOOP_FMT_PCM;
     bitsPerSample = 16;
     channels = chnls;
-    sampleRate = 44100;
+    sampleRate = rate;
     startPos = stPos;
   
     //availBytes = 999999;  // unused
@@ -387,8 +686,8 @@ bool AudioGeneratorWAVLoop::beginQuick(AudioFileSource *source, AudioOutput *out
     buffPtr = 0;
     buffLen = 0;
 
-    // loop starts by pushing out samples, clear them here
-    sL = sR = 0;
+    // loop starts by pushing out the pending block, clear it here
+    blkFrames = 0;
   
     if(!output->SetRate(sampleRate)) {
         return freeBuf();
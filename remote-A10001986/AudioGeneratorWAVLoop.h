@@ -1,6 +1,7 @@
 /*
   AudioGeneratorWAVLoop
-  Audio output generator that reads 8 and 16-bit WAV files
+  Audio output generator that reads 8 and 16-bit WAV files,
+  IMA-ADPCM WAV files and QOA files
     
   Copyright (C) 2017  Earle F. Philhower, III
   Adapted by Thomas Winischhofer (A10001986), 2023/2025
@@ -24,13 +25,25 @@
 
 #include "src/ESP8266Audio/AudioGenerator.h"
 
+// TW: Formats (WAV AudioFormat; QOA is a file format of its own)
+#define WAVLOOP_FMT_PCM   0x0001
+#define WAVLOOP_FMT_ADPCM 0x0011
+#define WAVLOOP_FMT_QOA   0x514f
+
+// TW: Max ADPCM block size
+#define WAVLOOP_MAXBLOCK  4096
+
+// TW: QOA: Samples per slice, slices per frame
+#define QOA_SLICE_LEN     20
+#define QOA_SLICES        256
+
 class AudioGeneratorWAVLoop : public AudioGenerator
 {
   public:
     AudioGeneratorWAVLoop();
     virtual ~AudioGeneratorWAVLoop() override;
     virtual bool begin(AudioFileSource *source, AudioOutput *output) override;
-    bool beginQuick(AudioFileSource *source, AudioOutput *output, int chnls, uint32_t stPos);
+    bool beginQuick(AudioFileSource *source, AudioOutput *output, int chnls, uint32_t stPos, uint32_t rate = 44100);
     virtual bool loop() override;
     virtual bool stop() override;
     virtual bool isRunning() override;
@@ -43,25 +56,39 @@ class AudioGeneratorWAVLoop : public AudioGenerator
     bool ReadU32(uint32_t *dest) { return file->read(reinterpret_cast<uint8_t*>(dest), 4); }
     bool ReadU16(uint16_t *dest) { return file->read(reinterpret_cast<uint8_t*>(dest), 2); }
     bool ReadU8(uint8_t *dest) { return file->read(reinterpret_cast<uint8_t*>(dest), 1); }
-    bool GetBufferedData16x2(int16_t& destL, int16_t& destR);
-    bool GetBufferedData16(int16_t& dest);
-    bool GetBufferedData8(uint8_t& dest);
+    bool FillBlock();
+    bool FillADPCM();
+    bool FillQOA();
+    bool ReadQOAFrame();
     bool ReadWAVInfo();
+    bool ReadQOAInfo();
 
   protected:
 
     // WAV info
+    uint16_t format;
     uint16_t channels;
     uint32_t sampleRate;
     uint16_t bitsPerSample;
+    uint16_t blockAlign;    // ADPCM: Bytes per block
     
     //uint32_t availBytes;
+    uint32_t dataSize;      // ADPCM: Size of data chunk
+    uint32_t dataLeft;      // ADPCM: Bytes of data chunk not yet read
 
     // We need to buffer some data in-RAM to avoid doing 1000s of small reads
     uint32_t buffSize;
     uint8_t *buff;
     uint16_t buffPtr;
     uint16_t buffLen;
+
+    // TW: Decoder state: ADPCM predictor and step index, QOA LMS
+    // filter and samples left in the current frame
+    int32_t  adPred[2];
+    int8_t   adIndex[2];
+    int32_t  qoaHist[2][4];
+    int32_t  qoaWeights[2][4];
+    uint16_t qoaLeft;
 };
 
 #endif
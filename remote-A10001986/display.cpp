@@ -58,7 +58,8 @@
 #include <Arduino.h>
 #include <math.h>
 #include "display.h"
-#include <Wire.h>
+#include "remote_prof.h"
+#include "i2cbus.h"
 
 /* remLED class */
 
@@ -93,6 +94,9 @@ bool remLED::getState()
 
 /* remDisplay class */
 
+// Min ms between display updates on the bus
+#define DISP_MIN_INT 10
+
 // The segments' wiring to buffer bits
 // This reflects the actual hardware wiring
 
@@ -177,8 +181,10 @@ remDisplay::remDisplay(uint8_t address)
 bool remDisplay::begin()
 {
     // Check for display on i2c bus
-    Wire.beginTransmission(_address);
-    _haveDisp = !Wire.endTransmission(true);
+    _haveDisp = i2cBus.probe(_address);
+
+    // Coalesce updates in bursts (eg speed animations)
+    i2cBus.setMinInterval(_address, DISP_MIN_INT);
 
     _dispType = 0;
     _num_digs = displays[_dispType].num_digs;
@@ -284,15 +290,41 @@ uint8_t remDisplay::getBrightness()
 void remDisplay::show()
 {
     if(_haveDisp) {
-        Wire.beginTransmission(_address);
-        Wire.write(0x00);  // start address
-    
-        for(int i = 0; i <= _buf_max; i++) {
-            Wire.write(_displayBuffer[i] & 0xFF);
-            Wire.write(_displayBuffer[i] >> 8);
+        uint8_t buf[1 + 8*2];
+        int lo, hi, len = 0;
+        
+        PROF_BEGIN;
+
+        // Only send the range that changed since the last update
+        for(lo = 0; lo <= (int)_buf_max; lo++) {
+            if(_displayBuffer[lo] != _shadowBuffer[lo]) break;
         }
-    
-        Wire.endTransmission();
+        if(lo <= (int)_buf_max) {
+            for(hi = _buf_max; hi > lo; hi--) {
+                if(_displayBuffer[hi] != _shadowBuffer[hi]) break;
+            }
+
+            // If the previous update is still queued, this one replaces
+            // it; so it must cover that range, too.
+            if(i2cBus.isPending(_address, 0x00)) {
+                if(_lastLo < lo) lo = _lastLo;
+                if(_lastHi > hi) hi = _lastHi;
+            }
+            _lastLo = lo;
+            _lastHi = hi;
+            
+            buf[len++] = lo * 2;  // start address
+        
+            for(int i = lo; i <= hi; i++) {
+                buf[len++] = _displayBuffer[i] & 0xFF;
+                buf[len++] = _displayBuffer[i] >> 8;
+                _shadowBuffer[i] = _displayBuffer[i];
+            }
+        
+            i2cBus.post(_address, 0x00, buf, len);
+        }
+
+        PROF_END(PROF_DISPLAY);
     }
 }
 
@@ -395,23 +427,21 @@ uint16_t remDisplay::getLEDChar(uint8_t value)
 void remDisplay::clearDisplay()
 {
     if(_haveDisp) {
-        Wire.beginTransmission(_address);
-        Wire.write(0x00);  // start address
-    
-        for(int i = 0; i <= _buf_max; i++) {
-            Wire.write(0x00);
-            Wire.write(0x00);
-        }
+        uint8_t buf[1 + 8*2] = { 0 };   // start address 0, all 0
     
-        Wire.endTransmission();
+        i2cBus.post(_address, 0x00, buf, 1 + (_buf_max + 1) * 2);
+
+        memset((void *)_shadowBuffer, 0, sizeof(_shadowBuffer));
+        _lastLo = 0;
+        _lastHi = _buf_max;
     }
 }
 
 void remDisplay::directCmd(uint8_t val)
 {
+    // Command group (upper nibble) is the key: A newer
+    // command of the same group replaces a pending one
     if(_haveDisp) {
-        Wire.beginTransmission(_address);
-        Wire.write(val);
-        Wire.endTransmission();
+        i2cBus.post(_address, val & 0xf0, &val, 1);
     }
 }
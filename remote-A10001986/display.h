@@ -124,6 +124,9 @@ class remDisplay {
 
         uint8_t _address;
         uint16_t _displayBuffer[8];
+        uint16_t _shadowBuffer[8];              // What was last sent to the display
+        int      _lastLo = 0;                   // Range of last update
+        int      _lastHi = 7;
 
         int8_t _onCache = -1;                   // Cache for on/off
         uint8_t _briCache = 0xfe;               // Cache for brightness
@@ -0,0 +1,461 @@
+/*
+ * -------------------------------------------------------------------
+ * Remote Control
+ * (C) 2024-2026 Thomas Winischhofer (A10001986)
+ * https://github.com/realA10001986/Remote
+ * https://remote.out-a-ti.me
+ *
+ * I2C bus: Transaction helpers, async write queue, statistics
+ * 
+ * -------------------------------------------------------------------
+ * License: Modified MIT NON-AI
+ * 
+ * Permission is hereby granted, free of charge, to any person 
+ * obtaining a copy of this software and associated documentation 
+ * files (the "Software"), to deal in the Software without restriction, 
+ * including without limitation the rights to use, copy, modify, 
+ * merge, publish, distribute, sublicense, and/or sell copies of the 
+ * Software, and to permit persons to whom the Software is furnished to 
+ * do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ * 
+ * Links inside the Software pointing to the original source must not 
+ * be changed or removed.
+ *
+ * In addition, the following restrictions apply:
+ * 
+ * 1. The Software and any modifications made to it may not be used 
+ * for the purpose of training or improving machine learning algorithms, 
+ * including but not limited to artificial intelligence, natural 
+ * language processing, or data mining. This condition applies to any 
+ * derivatives, modifications, or updates based on the Software code. 
+ * Any usage of the Software in an AI-training dataset is considered a 
+ * breach of this License.
+ *
+ * 2. The Software may not be included in any dataset used for 
+ * training or improving machine learning algorithms, including but 
+ * not limited to artificial intelligence, natural language processing, 
+ * or data mining.
+ *
+ * 3. Any person or organization found to be in violation of these 
+ * restrictions will be subject to legal action and may be held liable 
+ * for any damages resulting from such use.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * -------------------------------------------------------------------
+ */
+
+#include "remote_global.h"
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#include "i2cbus.h"
+
+/*
+ * All i2c traffic goes through this class:
+ *
+ * - Transactions are serialized by a mutex, so the time measured
+ *   for each of them is actual bus time (and not time spent waiting
+ *   for another task's transaction to finish).
+ * - Writes posted through post() are queued and done by the bus task. 
+ *   A write replaces any pending one for the same address and key 
+ *   (eg display RAM, or a command group), so only the latest one 
+ *   goes out. All writes pending for a device are done in one batch, 
+ *   but not more often than that device's minimum interval. If the 
+ *   queue is full, the write is dropped (and counted); doing it 
+ *   right away would bypass the interval and overtake queued ones.
+ * - Slow periodic reads (eg battery monitor) are done by pollers 
+ *   in the bus task, not in the main loop.
+ *
+ * Without REMOTE_I2C_ASYNC, posted writes are done immediately,
+ * and pollers are not called.
+ */
+
+// Poller interval
+#define I2CB_POLL_INT 100
+
+remI2CBus i2cBus;
+
+bool remI2CBus::begin()
+{
+    if(!_mutex) {
+        _mutex = xSemaphoreCreateMutex();
+    }
+    _statStart = millis();
+
+    #ifdef REMOTE_I2C_ASYNC
+    // Same core as loop(), higher priority; mostly blocked
+    if(!_task) {
+        if(xTaskCreatePinnedToCore(busTask, "i2cbus", 4096, this, 2, &_task, 1) != pdPASS) {
+            _task = NULL;
+            #ifdef REMOTE_DBG
+            Serial.println("i2cbus: Failed to create bus task");
+            #endif
+        }
+    }
+    #endif
+
+    return !!_mutex;
+}
+
+bool remI2CBus::isAsync()
+{
+    return !!_task;
+}
+
+bool remI2CBus::lock()
+{
+    if(_mutex) {
+        return (xSemaphoreTake(_mutex, portMAX_DELAY) == pdTRUE);
+    }
+    return true;
+}
+
+void remI2CBus::unlock()
+{
+    if(_mutex) {
+        xSemaphoreGive(_mutex);
+    }
+}
+
+// Transactions --------------------------------------------------------
+
+bool remI2CBus::probe(uint8_t addr)
+{
+    int ret;
+    
+    lock();
+    uint32_t t0 = micros();
+    Wire.beginTransmission(addr);
+    ret = Wire.endTransmission(true);
+    account(addr, 0, micros() - t0, false);
+    unlock();
+    
+    return !ret;
+}
+
+// Returns result of endTransmission(); 0 = success
+int remI2CBus::write(uint8_t addr, const uint8_t *buf, int len)
+{
+    int ret;
+
+    lock();
+    uint32_t t0 = micros();
+    Wire.beginTransmission(addr);
+    Wire.write(buf, len);
+    ret = Wire.endTransmission();
+    account(addr, len, micros() - t0, !!ret);
+    unlock();
+
+    return ret;
+}
+
+// Returns number of bytes read
+int remI2CBus::read(uint8_t addr, uint8_t *buf, int len)
+{
+    int i2clen;
+
+    lock();
+    uint32_t t0 = micros();
+    i2clen = Wire.requestFrom(addr, (uint8_t)len);
+    for(int i = 0; i < i2clen; i++) {
+        buf[i] = Wire.read();
+    }
+    account(addr, len, micros() - t0, i2clen != len);
+    unlock();
+
+    return i2clen;
+}
+
+// Write (register address), then read
+// repStart: Read with repeated start; otherwise write and read are two
+// separate transactions (with optional delay between them).
+int remI2CBus::writeRead(uint8_t addr, const uint8_t *wbuf, int wlen, 
+                         uint8_t *rbuf, int rlen, bool repStart, int delayMs)
+{
+    int i2clen;
+
+    if(!repStart) {
+        write(addr, wbuf, wlen);
+        if(delayMs) delay(delayMs);
+        return read(addr, rbuf, rlen);
+    }
+
+    lock();
+    uint32_t t0 = micros();
+    Wire.beginTransmission(addr);
+    Wire.write(wbuf, wlen);
+    Wire.endTransmission(false);
+    i2clen = Wire.requestFrom(addr, (uint8_t)rlen);
+    for(int i = 0; i < i2clen; i++) {
+        rbuf[i] = Wire.read();
+    }
+    account(addr, wlen + rlen, micros() - t0, i2clen != rlen);
+    unlock();
+
+    return i2clen;
+}
+
+// Async writes --------------------------------------------------------
+
+/*
+ * Queue a write; the latest one for addr/key wins and is moved
+ * to the end of the queue.
+ */
+void remI2CBus::post(uint8_t addr, uint8_t key, const uint8_t *buf, int len)
+{
+    bool queued = false;
+    uint16_t merged = 0;
+    
+    if(!_task || len > I2CB_MAXDATA) {
+        write(addr, buf, len);
+        return;
+    }
+
+    portENTER_CRITICAL(&_mux);
+    for(int i = 0; i < _numJobs; i++) {
+        if(_jobs[i].addr == addr && _jobs[i].key == key) {
+            merged = _jobs[i].merged + 1;
+            _numJobs--;
+            memmove(&_jobs[i], &_jobs[i+1], (_numJobs - i) * sizeof(I2C_Job));
+            break;
+        }
+    }
+    if(_numJobs < I2CB_MAXJOBS) {
+        I2C_Job *j = &_jobs[_numJobs++];
+        j->addr = addr;
+        j->key = key;
+        j->len = len;
+        j->merged = merged;
+        memcpy(j->data, buf, len);
+        queued = true;
+    }
+    portEXIT_CRITICAL(&_mux);
+
+    if(!queued) {
+        lock();
+        I2C_Stat *s = findStat(addr);
+        if(s) s->dropped++;
+        unlock();
+    }
+    
+    xTaskNotifyGive(_task);
+}
+
+// Check if a write for addr/key is still queued
+bool remI2CBus::isPending(uint8_t addr, uint8_t key)
+{
+    bool ret = false;
+
+    portENTER_CRITICAL(&_mux);
+    for(int i = 0; i < _numJobs; i++) {
+        if(_jobs[i].addr == addr && _jobs[i].key == key) {
+            ret = true;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&_mux);
+
+    return ret;
+}
+
+// Minimum interval between batches of posted writes to addr
+void remI2CBus::setMinInterval(uint8_t addr, uint16_t ms)
+{
+    for(int i = 0; i < _numRL; i++) {
+        if(_rlAddr[i] == addr) {
+            _rlInt[i] = ms;
+            return;
+        }
+    }
+    if(_numRL < I2CB_MAXDEV) {
+        _rlAddr[_numRL] = addr;
+        _rlInt[_numRL] = ms;
+        _rlLast[_numRL] = millis() - ms;
+        _numRL++;
+    }
+}
+
+/*
+ * Do all pending writes for devices that are due.
+ * Returns ms until the next rate-limited device is due, 0 if 
+ * nothing is left.
+ */
+int remI2CBus::flush()
+{
+    I2C_Job batch[I2CB_MAXJOBS];
+    
+    for(;;) {
+        unsigned long now = millis();
+        int num = 0, rl = -1, wait = 0;
+        uint8_t addr = 0;
+
+        portENTER_CRITICAL(&_mux);
+        for(int i = 0; i < _numJobs && !num; i++) {
+            addr = _jobs[i].addr;
+            rl = -1;
+            for(int k = 0; k < _numRL; k++) {
+                if(_rlAddr[k] == addr) {
+                    rl = k;
+                    break;
+                }
+            }
+            if(rl >= 0 && now - _rlLast[rl] < _rlInt[rl]) {
+                int t = _rlInt[rl] - (now - _rlLast[rl]);
+                if(!wait || t < wait) wait = t;
+                continue;
+            }
+            // Take all writes for this device, keep their order
+            for(int k = i; k < _numJobs; ) {
+                if(_jobs[k].addr == addr) {
+                    batch[num++] = _jobs[k];
+                    _numJobs--;
+                    memmove(&_jobs[k], &_jobs[k+1], (_numJobs - k) * sizeof(I2C_Job));
+                } else {
+                    k++;
+                }
+            }
+        }
+        portEXIT_CRITICAL(&_mux);
+
+        if(!num) 
+            return wait;
+
+        for(int i = 0; i < num; i++) {
+            write(addr, batch[i].data, batch[i].len);
+        }
+
+        lock();
+        I2C_Stat *s = findStat(addr);
+        if(s) {
+            for(int i = 0; i < num; i++) {
+                s->merged += batch[i].merged;
+            }
+        }
+        unlock();
+
+        if(rl >= 0) {
+            _rlLast[rl] = millis();
+        }
+    }
+}
+
+bool remI2CBus::addPoller(void (*func)(void *), void *arg)
+{
+    if(_numPoll >= I2CB_MAXPOLL)
+        return false;
+        
+    _pollArg[_numPoll] = arg;
+    _pollFunc[_numPoll] = func;
+    _numPoll++;
+
+    return true;
+}
+
+void remI2CBus::runPollers()
+{
+    for(int i = 0; i < _numPoll; i++) {
+        _pollFunc[i](_pollArg[i]);
+    }
+}
+
+void remI2CBus::busTask(void *arg)
+{
+    remI2CBus *b = (remI2CBus *)arg;
+    unsigned long lastPoll = millis();
+    TickType_t t;
+    int wait = 0;
+
+    for(;;) {
+        t = pdMS_TO_TICKS(wait ? wait : I2CB_POLL_INT);
+        ulTaskNotifyTake(pdTRUE, t ? t : 1);
+        
+        wait = b->flush();
+        
+        if(millis() - lastPoll >= I2CB_POLL_INT) {
+            lastPoll = millis();
+            b->runPollers();
+            // Pollers might have taken a while
+            if(!wait) wait = b->flush();
+        }
+    }
+}
+
+// Statistics ----------------------------------------------------------
+
+// Call with bus locked
+I2C_Stat *remI2CBus::findStat(uint8_t addr)
+{
+    for(int i = 0; i < _numStat; i++) {
+        if(_stat[i].addr == addr) 
+            return &_stat[i];
+    }
+    if(_numStat < I2CB_MAXDEV) {
+        I2C_Stat *s = &_stat[_numStat++];
+        memset((void *)s, 0, sizeof(I2C_Stat));
+        s->addr = addr;
+        return s;
+    }
+    return NULL;
+}
+
+// Call with bus locked
+void remI2CBus::account(uint8_t addr, int bytes, uint32_t us, bool err)
+{
+    I2C_Stat *s = findStat(addr);
+
+    if(s) {
+        s->count++;
+        s->bytes += bytes;
+        s->busyUs += us;
+        if(err) s->errors++;
+    }
+}
+
+void remI2CBus::resetStats()
+{
+    lock();
+    for(int i = 0; i < _numStat; i++) {
+        uint8_t addr = _stat[i].addr;
+        memset((void *)&_stat[i], 0, sizeof(I2C_Stat));
+        _stat[i].addr = addr;
+    }
+    _statStart = millis();
+    unlock();
+}
+
+/*
+ * Format per-device statistics into buf
+ * Utilization is bus time in relation to time since start/reset
+ */
+int remI2CBus::getStats(char *buf, int bufSize)
+{
+    unsigned long elapsed = millis() - _statStart;
+    int len = 0;
+
+    *buf = 0;
+
+    if(!elapsed) elapsed = 1;
+
+    lock();
+    for(int i = 0; i < _numStat && len < bufSize; i++) {
+        I2C_Stat *s = &_stat[i];
+        // us per ms = permille
+        uint32_t pm = (uint32_t)(s->busyUs / elapsed);
+        len += snprintf(buf + len, bufSize - len, "i2c 0x%02x n=%u bytes=%u busy=%ums (%u.%u%%) merged=%u drop=%u err=%u\n",
+                            s->addr, s->count, s->bytes, (uint32_t)(s->busyUs / 1000),
+                            pm / 10, pm % 10, s->merged, s->dropped, s->errors);
+    }
+    unlock();
+
+    return (len < bufSize) ? len : bufSize - 1;
+}
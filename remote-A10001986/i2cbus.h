@@ -0,0 +1,142 @@
+/*
+ * -------------------------------------------------------------------
+ * Remote Control
+ * (C) 2024-2026 Thomas Winischhofer (A10001986)
+ * https://github.com/realA10001986/Remote
+ * https://remote.out-a-ti.me
+ *
+ * I2C bus: Transaction helpers, async write queue, statistics
+ * 
+ * -------------------------------------------------------------------
+ * License: Modified MIT NON-AI
+ * 
+ * Permission is hereby granted, free of charge, to any person 
+ * obtaining a copy of this software and associated documentation 
+ * files (the "Software"), to deal in the Software without restriction, 
+ * including without limitation the rights to use, copy, modify, 
+ * merge, publish, distribute, sublicense, and/or sell copies of the 
+ * Software, and to permit persons to whom the Software is furnished to 
+ * do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ * 
+ * Links inside the Software pointing to the original source must not 
+ * be changed or removed.
+ *
+ * In addition, the following restrictions apply:
+ * 
+ * 1. The Software and any modifications made to it may not be used 
+ * for the purpose of training or improving machine learning algorithms, 
+ * including but not limited to artificial intelligence, natural 
+ * language processing, or data mining. This condition applies to any 
+ * derivatives, modifications, or updates based on the Software code. 
+ * Any usage of the Software in an AI-training dataset is considered a 
+ * breach of this License.
+ *
+ * 2. The Software may not be included in any dataset used for 
+ * training or improving machine learning algorithms, including but 
+ * not limited to artificial intelligence, natural language processing, 
+ * or data mining.
+ *
+ * 3. Any person or organization found to be in violation of these 
+ * restrictions will be subject to legal action and may be held liable 
+ * for any damages resulting from such use.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * -------------------------------------------------------------------
+ */
+
+#ifndef _REMI2CBUS_H
+#define _REMI2CBUS_H
+
+#define I2CB_MAXDEV    8    // Devices with statistics
+#define I2CB_MAXJOBS   8    // Pending async writes
+#define I2CB_MAXDATA   18   // Max bytes per async write
+#define I2CB_MAXPOLL   4    // Background pollers
+
+typedef struct {
+    uint8_t  addr;
+    uint32_t count;
+    uint32_t bytes;
+    uint32_t merged;
+    uint32_t dropped;
+    uint32_t errors;
+    uint64_t busyUs;
+} I2C_Stat;
+
+typedef struct {
+    uint8_t  addr;
+    uint8_t  key;
+    uint8_t  len;
+    uint16_t merged;
+    uint8_t  data[I2CB_MAXDATA];
+} I2C_Job;
+
+/* remI2CBus Class */
+
+class remI2CBus {
+
+    public:
+
+        bool begin();
+
+        bool probe(uint8_t addr);
+        int  write(uint8_t addr, const uint8_t *buf, int len);
+        int  read(uint8_t addr, uint8_t *buf, int len);
+        int  writeRead(uint8_t addr, const uint8_t *wbuf, int wlen, 
+                       uint8_t *rbuf, int rlen, bool repStart = true, int delayMs = 0);
+
+        void post(uint8_t addr, uint8_t key, const uint8_t *buf, int len);
+        bool isPending(uint8_t addr, uint8_t key);
+        void setMinInterval(uint8_t addr, uint16_t ms);
+        bool addPoller(void (*func)(void *), void *arg);
+        bool isAsync();
+
+        int  getStats(char *buf, int bufSize);
+        void resetStats();
+
+    private:
+
+        // Host test: flush() and statistics without the bus task
+        friend class remI2CBusTest;
+
+        static void busTask(void *arg);
+        
+        bool lock();
+        void unlock();
+        void account(uint8_t addr, int bytes, uint32_t us, bool err);
+        I2C_Stat *findStat(uint8_t addr);
+        int  flush();
+        void runPollers();
+
+        SemaphoreHandle_t _mutex = NULL;
+        TaskHandle_t _task = NULL;
+        portMUX_TYPE _mux = portMUX_INITIALIZER_UNLOCKED;
+
+        I2C_Stat _stat[I2CB_MAXDEV];
+        int      _numStat = 0;
+        unsigned long _statStart = 0;
+
+        I2C_Job  _jobs[I2CB_MAXJOBS];
+        int      _numJobs = 0;
+
+        uint8_t  _rlAddr[I2CB_MAXDEV];
+        uint16_t _rlInt[I2CB_MAXDEV];
+        unsigned long _rlLast[I2CB_MAXDEV];
+        int      _numRL = 0;
+
+        void     (*_pollFunc[I2CB_MAXPOLL])(void *);
+        void     *_pollArg[I2CB_MAXPOLL];
+        int      _numPoll = 0;
+};
+
+extern remI2CBus i2cBus;
+
+#endif
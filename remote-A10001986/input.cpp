@@ -58,6 +58,7 @@
 #include <Arduino.h>
 
 #include "input.h"
+#include "i2cbus.h"
 #include "remote_audio.h"
 
 //#define REMOTE_DBG_ADC
@@ -195,8 +196,7 @@ bool REMRotEnc::begin(bool forSpeed, bool newBoard)
 
         _i2caddr = _addrArr[i];
 
-        Wire.beginTransmission(_i2caddr);
-        if(!Wire.endTransmission(true)) {
+        if(i2cBus.probe(_i2caddr)) {
 
             switch(_addrArr[i+1]) {
             case REM_RE_TYPE_ADA4991:
@@ -321,6 +321,9 @@ bool REMRotEnc::begin(bool forSpeed, bool newBoard)
         delay(10);
         _dynZeroPos = false;
         scaleThrottlePos = true; // make more tolerant for zero position
+        if(!_type) {
+            startSampler();
+        }
         break;
         
     default:
@@ -389,7 +392,9 @@ bool REMRotEnc::setMaxStepsDown(int32_t num)
 // Returns -100% - 100%
 int32_t REMRotEnc::updateThrottlePos(bool force)
 {
-    if(force || (millis() - lastUpd > HWUPD_DELAY)) {
+    // With the sampler, getEncPos() does no i2c traffic, so
+    // there is no need to rate-limit
+    if(force || _smpTask || (millis() - lastUpd > HWUPD_DELAY)) {
 
         lastUpd = millis();
 
@@ -506,6 +511,9 @@ int32_t REMRotEnc::getEncPos()
         break;
 
     case REM_RE_TYPE_ADS1X15:
+        if(_smpTask) {
+            return _smpFiltered;
+        }
         read(ADS_BASE, ADS_CONVERT, buf, 2);
         #ifdef REMOTE_DBG_ADC
         newRead = (int32_t)(((int16_t)((buf[0] << 8) | buf[1]))) / 16;
@@ -520,6 +528,88 @@ int32_t REMRotEnc::getEncPos()
     return 0;
 }
 
+/*
+ * ADS1X15 background sampler
+ *
+ * The ADS runs in continuous mode, so a sample is just a read of the
+ * conversion register. The pointer register is left there, so the
+ * sampler can do this in a single i2c transaction.
+ * Each sample goes into a ring buffer; the median of the latest
+ * REM_SMP_MEDIAN samples is then smoothed (EMA, alpha 1/4).
+ */
+
+void REMRotEnc::setSampleInterval(int ms)
+{
+    uint32_t t = pdMS_TO_TICKS(ms);
+    
+    _smpTicks = t ? t : 1;
+}
+
+int32_t REMRotEnc::readADS()
+{
+    uint8_t buf[2];
+    
+    if(i2cBus.read(_i2caddr, buf, 2) != 2) {
+        return INT32_MIN;
+    }
+    
+    return (int32_t)(((int16_t)((buf[0] << 8) | buf[1]))) / 16;
+}
+
+bool REMRotEnc::startSampler()
+{
+    uint8_t buf[2];
+
+    // Set pointer register, prime filter
+    read(ADS_BASE, ADS_CONVERT, buf, 2);
+    _smpFiltered = (int32_t)(((int16_t)((buf[0] << 8) | buf[1]))) / 16;
+    _smpEMA = _smpFiltered * 16;
+
+    setSampleInterval(REM_SMP_INTERVAL);
+    
+    // Same core as loop(), higher priority
+    if(xTaskCreatePinnedToCore(samplerTask, "thrsmp", 3072, this, 2, &_smpTask, 1) != pdPASS) {
+        _smpTask = NULL;
+        return false;
+    }
+
+    return true;
+}
+
+void REMRotEnc::samplerTask(void *arg)
+{
+    REMRotEnc *r = (REMRotEnc *)arg;
+    TickType_t lastWake = xTaskGetTickCount();
+    int32_t srt[REM_SMP_MEDIAN];
+
+    for(;;) {
+        int32_t v = r->readADS();
+
+        if(v != INT32_MIN) {
+            r->_smpBuf[r->_smpIdx] = v;
+            r->_smpIdx = (r->_smpIdx + 1) & (REM_SMP_BUFSIZE - 1);
+            if(r->_smpCnt < REM_SMP_MEDIAN) r->_smpCnt++;
+
+            // Insertion-sort the latest samples, take median
+            int n = r->_smpCnt;
+            for(int i = 0; i < n; i++) {
+                int32_t t = r->_smpBuf[(r->_smpIdx - 1 - i) & (REM_SMP_BUFSIZE - 1)];
+                int j = i;
+                while(j > 0 && srt[j-1] > t) {
+                    srt[j] = srt[j-1];
+                    j--;
+                }
+                srt[j] = t;
+            }
+
+            r->_smpEMA += (srt[n / 2] * 16 - r->_smpEMA) / 4;
+            r->_smpFiltered = (r->_smpEMA + 8) >> 4;
+        }
+
+        vTaskDelayUntil(&lastWake, r->_smpTicks);
+    }
+}
+
 bool REMRotEnc::zeroEnc()
 {
     uint8_t buf[4] = { 0 };
@@ -544,29 +634,26 @@ bool REMRotEnc::zeroEnc()
 
 int REMRotEnc::read(uint16_t base, uint8_t reg, uint8_t *buf, uint8_t num)
 {
-    int i2clen;
+    uint8_t wbuf[2];
+    int wlen = 0;
     
-    Wire.beginTransmission(_i2caddr);
-    if(base <= 0xff) Wire.write((uint8_t)base);
-    Wire.write(reg);
-    Wire.endTransmission(true);
-    delay(1);
-    i2clen = Wire.requestFrom(_i2caddr, (int)num);
-    for(int i = 0; i < i2clen; i++) {
-        buf[i] = Wire.read();
-    }
-    return i2clen;
+    if(base <= 0xff) wbuf[wlen++] = (uint8_t)base;
+    wbuf[wlen++] = reg;
+    
+    return i2cBus.writeRead(_i2caddr, wbuf, wlen, buf, num, false, 1);
 }
 
 void REMRotEnc::write(uint16_t base, uint8_t reg, uint8_t *buf, uint8_t num)
 {
-    Wire.beginTransmission(_i2caddr);
-    if(base <= 0xff) Wire.write((uint8_t)base);
-    Wire.write(reg);
-    for(int i = 0; i < num; i++) {
-        Wire.write(buf[i]);
+    uint8_t wbuf[2 + 8];
+    int wlen = 0;
+    
+    if(base <= 0xff) wbuf[wlen++] = (uint8_t)base;
+    wbuf[wlen++] = reg;
+    for(int i = 0; i < num && wlen < sizeof(wbuf); i++) {
+        wbuf[wlen++] = buf[i];
     }
-    Wire.endTransmission();
+    i2cBus.write(_i2caddr, wbuf, wlen);
 }
 
 /*
@@ -588,6 +675,15 @@ void RemButton::begin(const int pin, const bool activeLow, const bool pullupActi
     _buttonPressed = activeLow ? LOW : HIGH;
   
     pinMode(pin, pullupActive ? INPUT_PULLUP : (pulldownActive ? INPUT_PULLDOWN : INPUT));
+
+    #ifdef REMOTE_INPUT_IRQ
+    attachInterruptArg(digitalPinToInterrupt(pin), isr, this, CHANGE);
+
+    // No edge for a switch already closed at boot
+    if(digitalRead(pin) == _buttonPressed) {
+        addEvent(true);
+    }
+    #endif
 }
 
 
@@ -636,12 +732,53 @@ void RemButton::attachELongPressStop(void (*newFunction)(void))
     _elongPressStopFunc = newFunction;
 }
 
-// Check input of the pin and advance the state machine
+#ifdef REMOTE_INPUT_IRQ
+void IRAM_ATTR RemButton::isr(void *arg)
+{
+    RemButton *b = (RemButton *)arg;
+
+    b->addEvent(digitalRead(b->_pin) == b->_buttonPressed);
+}
+
+void IRAM_ATTR RemButton::addEvent(bool active)
+{
+    uint8_t ni = (_evIn + 1) & (REM_EVBUF_SIZE - 1);
+
+    // _curActive is always current, even if the buffer overflows
+    _curActive = active;
+    
+    if(ni != _evOut) {
+        _evBuf[_evIn].time = millis();
+        _evBuf[_evIn].active = active;
+        _evIn = ni;
+    }
+}
+#endif
+
+// Feed the state machine with the pin's edge events (or its current 
+// level if polling)
 void RemButton::scan()
 {
-    unsigned long now = millis();
+    #ifdef REMOTE_INPUT_IRQ
+    // Nothing happened, and no timer running
+    if(_evIn == _evOut && _state == REMBUS_IDLE)
+        return;
+
+    while(_evOut != _evIn) {
+        advance(_evBuf[_evOut].active, _evBuf[_evOut].time);
+        _evOut = (_evOut + 1) & (REM_EVBUF_SIZE - 1);
+    }
+
+    advance(_curActive, millis());
+    #else
+    advance((digitalRead(_pin) == _buttonPressed), millis());
+    #endif
+}
+
+// Advance the state machine
+void RemButton::advance(bool active, unsigned long now)
+{
     unsigned long waitTime = now - _startTime;
-    bool active = (digitalRead(_pin) == _buttonPressed);
     
     switch(_state) {
     case REMBUS_IDLE:
@@ -747,7 +884,12 @@ ButtonPack::ButtonPack(int numTypes, const uint8_t *addrArr)
     _addrArr = addrArr;
 }
 
-bool ButtonPack::begin()
+/*
+ * intPin: GPIO connected to the expander's INT output, or -1.
+ * With INT, the port is only read after a change (or once a 
+ * second, in case an edge was missed).
+ */
+bool ButtonPack::begin(int intPin)
 {
     bool foundSt = false;
 
@@ -755,8 +897,7 @@ bool ButtonPack::begin()
 
         _i2caddr = _addrArr[i];
 
-        Wire.beginTransmission(_i2caddr);
-        if(!Wire.endTransmission(true)) {
+        if(i2cBus.probe(_i2caddr)) {
 
             switch(_addrArr[i+1]) {
             case REM_BP_TYPE_PCA8574:
@@ -808,9 +949,20 @@ bool ButtonPack::begin()
         _longPressDur[i] = 2000;
     }
 
+    if(intPin >= 0) {
+        _intPin = intPin;
+        pinMode(intPin, INPUT_PULLUP);
+        attachInterruptArg(digitalPinToInterrupt(intPin), isr, this, FALLING);
+    }
+
     return true;
 }
 
+void IRAM_ATTR ButtonPack::isr(void *arg)
+{
+    ((ButtonPack *)arg)->_intFlag = true;
+}
+
 // scanInterval: ms
 void ButtonPack::setScanInterval(const unsigned long scanInterval)
 {
@@ -865,20 +1017,34 @@ void ButtonPack::scan()
     uint8_t  port;
     bool     active;
 
-    if(millis() - _lastScan < _scanInterval)
-        return;
-
-    _lastScan = millis();
-
-    switch(_st) {
-    case REM_BP_TYPE_PCA8574:
-    case REM_BP_TYPE_PCA9554:
-        if(port_read(&port) != 1) {
+    if(_intPin >= 0) {
+        if(_intFlag || (now - _lastRead >= 1000)) {
+            _intFlag = false;
+            if(port_read(&_port) != 1) {
+                return;
+            }
+            _lastRead = now;
+        } else if(now - _lastScan < _scanInterval) {
+            return;
+        }
+        _lastScan = now;
+        port = _port;
+    } else {
+        if(millis() - _lastScan < _scanInterval)
+            return;
+    
+        _lastScan = millis();
+    
+        switch(_st) {
+        case REM_BP_TYPE_PCA8574:
+        case REM_BP_TYPE_PCA9554:
+            if(port_read(&port) != 1) {
+                return;
+            }
+            break;
+        default:
             return;
         }
-        break;
-    default:
-        return;
     }
 
     for(int i = 0; i < _pack_size; i++) {
@@ -1005,37 +1171,29 @@ void ButtonPack::transitionTo(int idx, ButState nextState)
 
 void ButtonPack::port_write(uint8_t reg, uint8_t val)
 {
+    uint8_t buf[2] = { reg, val };
+    
     switch(_st) {
     case REM_BP_TYPE_PCA8574:
-        Wire.beginTransmission(_i2caddr);
-        Wire.write(val);
-        Wire.endTransmission();
+        i2cBus.write(_i2caddr, &buf[1], 1);
         break;
     case REM_BP_TYPE_PCA9554:
-        Wire.beginTransmission(_i2caddr);
-        Wire.write(reg);
-        Wire.write(val);
-        Wire.endTransmission(); 
+        i2cBus.write(_i2caddr, buf, 2);
         break;
     }  
 }
 
 int ButtonPack::port_read(uint8_t *buf)
 {
+    const uint8_t reg0 = 0;
     int i2clen = 0;
 
     switch(_st) {
     case REM_BP_TYPE_PCA8574:
-        i2clen = Wire.requestFrom(_i2caddr, (int)1);
-        buf[0] = Wire.read();
+        i2clen = i2cBus.read(_i2caddr, buf, 1);
         break;
     case REM_BP_TYPE_PCA9554:
-        Wire.beginTransmission(_i2caddr);
-        Wire.write(0);
-        Wire.endTransmission();
-        delay(1);
-        i2clen = Wire.requestFrom(_i2caddr, (int)1);
-        buf[0] = Wire.read();
+        i2clen = i2cBus.writeRead(_i2caddr, &reg0, 1, buf, 1, false, 1);
         break;
     }
     return i2clen;
@@ -68,6 +68,11 @@
 #define REM_RE_TYPE_CS         3     // CircuitSetup             <yet to be designed>
 #define REM_RE_TYPE_ADS1X15    4     // ADS1015                  ADC (not really a rotary encoder)
 
+// ADS1X15 throttle: Background sampler
+#define REM_SMP_INTERVAL  2          // ms between samples (default)
+#define REM_SMP_BUFSIZE   8          // Ring buffer size (power of 2)
+#define REM_SMP_MEDIAN    5          // Median over this many latest samples
+
 class REMRotEnc {
   
     public:
@@ -90,8 +95,13 @@ class REMRotEnc {
 
         int     updateVolume(int curVol, bool force = false);
 
+        void    setSampleInterval(int ms);
+
     private:
         int32_t getEncPos();
+        int32_t readADS();
+        bool    startSampler();
+        static void samplerTask(void *arg);
         int     read(uint16_t base, uint8_t reg, uint8_t *buf, uint8_t num);
         void    write(uint16_t base, uint8_t reg, uint8_t *buf, uint8_t num);
 
@@ -119,6 +129,15 @@ class REMRotEnc {
         int           dfroffslots;
 
         bool          scaleThrottlePos = false;
+
+        // Background sampler (ADS1X15 throttle only)
+        TaskHandle_t      _smpTask = NULL;
+        volatile uint32_t _smpTicks = 1;
+        int32_t           _smpBuf[REM_SMP_BUFSIZE];
+        uint8_t           _smpIdx = 0;
+        uint8_t           _smpCnt = 0;
+        int32_t           _smpEMA = 0;          // 1/16 units
+        volatile int32_t  _smpFiltered = 0;
 };
 
 
@@ -162,8 +181,14 @@ class RemButton {
 
     private:
 
+        void advance(bool active, unsigned long now);
         void transitionTo(ButState nextState);
 
+        #ifdef REMOTE_INPUT_IRQ
+        static void isr(void *arg);
+        void        addEvent(bool active);
+        #endif
+
         void (*_pressDownFunc)() = NULL;
         void (*_pressEndFunc)() = NULL;
         void (*_longPressStartFunc)() = NULL;
@@ -184,6 +209,18 @@ class RemButton {
       
         unsigned long _startTime = 0;
         bool    _wasPressed = false;
+
+        #ifdef REMOTE_INPUT_IRQ
+        // Edge events, written by ISR, read by scan()
+        #define REM_EVBUF_SIZE 8
+        struct {
+            unsigned long time;
+            bool          active;
+        } volatile _evBuf[REM_EVBUF_SIZE];
+        volatile uint8_t _evIn = 0;
+        volatile uint8_t _evOut = 0;
+        volatile bool    _curActive = false;
+        #endif
 };
 
 /*
@@ -204,7 +241,7 @@ class ButtonPack {
     public:
         ButtonPack(int numTypes, const uint8_t *addrArr);
 
-        bool begin();
+        bool begin(int intPin = -1);
 
         void setScanInterval(const unsigned long scanInterval);
         void setTiming(int idx, const int debounceTs, const int lPressTs);
@@ -226,6 +263,8 @@ class ButtonPack {
         void reset(int);
         void transitionTo(int, ButState nextState);
 
+        static void isr(void *arg);
+
         void port_write(uint8_t reg, uint8_t val);
         int  port_read(uint8_t *buf);
 
@@ -247,6 +286,11 @@ class ButtonPack {
 
         unsigned long _scanInterval = 20;
         unsigned long _lastScan = 0;
+
+        int           _intPin = -1;
+        volatile bool _intFlag = true;
+        uint8_t       _port = 0xff;
+        unsigned long _lastRead = 0;
       
         int _buttonPressed;
       
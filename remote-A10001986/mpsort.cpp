@@ -0,0 +1,314 @@
+/*
+ * -------------------------------------------------------------------
+ * Remote Control
+ * (C) 2024-2026 Thomas Winischhofer (A10001986)
+ * https://github.com/realA10001986/Remote
+ * https://remote.out-a-ti.me
+ *
+ * Music player: Sort for the auto-renamer
+ * 
+ * -------------------------------------------------------------------
+ * License: Modified MIT NON-AI
+ * 
+ * Permission is hereby granted, free of charge, to any person 
+ * obtaining a copy of this software and associated documentation 
+ * files (the "Software"), to deal in the Software without restriction, 
+ * including without limitation the rights to use, copy, modify, 
+ * merge, publish, distribute, sublicense, and/or sell copies of the 
+ * Software, and to permit persons to whom the Software is furnished to 
+ * do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ * 
+ * Links inside the Software pointing to the original source must not 
+ * be changed or removed.
+ *
+ * In addition, the following restrictions apply:
+ * 
+ * 1. The Software and any modifications made to it may not be used 
+ * for the purpose of training or improving machine learning algorithms, 
+ * including but not limited to artificial intelligence, natural 
+ * language processing, or data mining. This condition applies to any 
+ * derivatives, modifications, or updates based on the Software code. 
+ * Any usage of the Software in an AI-training dataset is considered a 
+ * breach of this License.
+ *
+ * 2. The Software may not be included in any dataset used for 
+ * training or improving machine learning algorithms, including but 
+ * not limited to artificial intelligence, natural language processing, 
+ * or data mining.
+ *
+ * 3. Any person or organization found to be in violation of these 
+ * restrictions will be subject to legal action and may be held liable 
+ * for any damages resulting from such use.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * -------------------------------------------------------------------
+ */
+
+#include "remote_global.h"
+
+#include <Arduino.h>
+#include <FS.h>
+
+#include "mpsort.h"
+
+static const unsigned long mprenBufSizes[MPREN_BUFS] = {
+    16384, 16384, 8192, 8192, 8192, 8192, 8192, 4096 
+};
+static const char *mprenRunName = "/RM_SORT%d.TMP";
+
+/*
+ * Sort for file names
+ *
+ * Names are sorted by a collation key, built once per name:
+ * Case-insensitive, and runs of digits compare by their numerical
+ * value, so "Track 2" comes before "Track 10". Key and name are 
+ * stored as one record ("key\0name\0") in the sort buffers.
+ * If the buffers are full, their content is sorted and written to 
+ * SD as a "run"; in the end, all runs and the buffers' content are
+ * merged while renaming.
+ */
+
+static unsigned char mpren_toUpper(char a)
+{
+    if(a >= 'a' && a <= 'z')
+        a &= ~0x20;
+
+    return (unsigned char)a;
+}
+
+static int mpren_makeKey(char *k, const char *fn)
+{
+    int len = 0;
+
+    while(*fn && len < 255) {
+        if(*fn >= '0' && *fn <= '9') {
+            const char *d;
+            int nd;
+            // Skip leading zeros, but keep one digit
+            while(*fn == '0' && fn[1] >= '0' && fn[1] <= '9') fn++;
+            d = fn;
+            while(*fn >= '0' && *fn <= '9') fn++;
+            nd = fn - d;
+            if(len + 2 + nd > 255) break;
+            // Marker, then number of digits, then digits:
+            // Shorter numbers are smaller
+            k[len++] = '0';
+            k[len++] = nd;
+            memcpy(k + len, d, nd);
+            len += nd;
+        } else {
+            k[len++] = mpren_toUpper(*fn++);
+        }
+    }
+    k[len] = 0;
+
+    return len;
+}
+
+static int mpren_recCmp(const char *a, const char *b)
+{
+    int r = strcmp(a, b);
+
+    // Same key: Sort by name to be deterministic
+    if(!r) r = strcmp(a + strlen(a) + 1, b + strlen(b) + 1);
+
+    return r;
+}
+
+static int mpren_qsortCmp(const void *a, const void *b)
+{
+    return mpren_recCmp(*(const char **)a, *(const char **)b);
+}
+
+bool mpren_init(MpRen_Ctx *x, fs::FS *fs, void (*idle)())
+{
+    x->fs = fs;
+    x->idle = idle;
+    x->n = x->runs = x->curBuf = 0;
+    x->numBufs = 1;
+    x->memIdx = 0;
+    x->refill = -1;
+    x->runRec = NULL;
+    for(int i = 0; i < MPREN_BUFS; i++) x->bufs[i] = NULL;
+
+    if(!(x->a = (char **)malloc(1000*sizeof(char *))))
+        return false;
+
+    if(!(x->bufs[0] = (char *)malloc(mprenBufSizes[0]))) {
+        free(x->a);
+        return false;
+    }
+
+    x->c = x->bufs[0];
+    x->bufSize = mprenBufSizes[0];
+
+    return true;
+}
+
+void mpren_free(MpRen_Ctx *x)
+{
+    char fnbuf[20];
+
+    for(int i = 0; i < x->runs; i++) {
+        if(x->runF[i]) x->runF[i].close();
+        sprintf(fnbuf, mprenRunName, i);
+        x->fs->remove(fnbuf);
+    }
+    for(int i = 0; i < x->numBufs; i++) {
+        if(x->bufs[i]) free(x->bufs[i]);
+    }
+    if(x->runRec) free(x->runRec);
+    free(x->a);
+}
+
+// Sort buffers' content and write it to SD
+static bool mpren_spill(MpRen_Ctx *x)
+{
+    char fnbuf[20];
+    bool ret = true;
+
+    if(x->runs >= MPREN_MAXRUNS)
+        return false;
+
+    qsort(x->a, x->n, sizeof(char *), mpren_qsortCmp);
+
+    sprintf(fnbuf, mprenRunName, x->runs);
+    File f = x->fs->open(fnbuf, FILE_WRITE);
+    if(!f) return false;
+    
+    for(int i = 0; i < x->n && ret; i++) {
+        const char *r = x->a[i];
+        size_t l = strlen(r) + 1;
+        l += strlen(r + l) + 1;
+        ret = (f.write((const uint8_t *)r, l) == l);
+        if(x->idle) x->idle();
+    }
+    f.close();
+
+    if(!ret) {
+        x->fs->remove(fnbuf);
+        return false;
+    }
+
+    #ifdef REMOTE_DBG
+    Serial.printf("MusicPlayer/Renamer: Wrote run %d (%d names)\n", x->runs, x->n);
+    #endif
+
+    x->runs++;
+    x->n = 0;
+    x->curBuf = 0;
+    x->c = x->bufs[0];
+    x->bufSize = mprenBufSizes[0];
+
+    return true;
+}
+
+bool mpren_add(MpRen_Ctx *x, const char *fn)
+{
+    char key[256];
+    int klen = mpren_makeKey(key, fn);
+    unsigned long sz = klen + 1 + strlen(fn) + 1;
+
+    while(sz > x->bufSize) {
+        if(x->curBuf < x->numBufs - 1) {
+            x->curBuf++;
+        } else if(x->numBufs < MPREN_BUFS &&
+                  (x->bufs[x->numBufs] = (char *)malloc(mprenBufSizes[x->numBufs]))) {
+            #ifdef REMOTE_DBG
+            Serial.println("MusicPlayer/Renamer: Allocated additional sort buffer");
+            #endif
+            x->curBuf = x->numBufs++;
+        } else if(x->n && mpren_spill(x)) {
+            continue;
+        } else {
+            return false;
+        }
+        x->c = x->bufs[x->curBuf];
+        x->bufSize = mprenBufSizes[x->curBuf];
+    }
+
+    x->a[x->n++] = x->c;
+    strcpy(x->c, key);
+    strcpy(x->c + klen + 1, fn);
+    x->c += sz;
+    x->bufSize -= sz;
+
+    return true;
+}
+
+static bool mpren_readRec(File &f, char *rec)
+{
+    int i = 0, z = 0;
+
+    while(z < 2 && i < MPREN_RECSIZE) {
+        int ch = f.read();
+        if(ch < 0) return false;
+        rec[i++] = ch;
+        if(!ch) z++;
+    }
+
+    return (z == 2);
+}
+
+void mpren_sort(MpRen_Ctx *x)
+{
+    char fnbuf[20];
+
+    qsort(x->a, x->n, sizeof(char *), mpren_qsortCmp);
+    
+    if(!x->runs)
+        return;
+
+    // Prepare merge: Read first record of each run
+    if(!(x->runRec = (char *)malloc(x->runs * MPREN_RECSIZE))) {
+        // Continue with what is in memory
+        Serial.println("MusicPlayer/Renamer: Failed to allocate merge buffer");
+    }
+    for(int i = 0; i < x->runs; i++) {
+        sprintf(fnbuf, mprenRunName, i);
+        x->runValid[i] = false;
+        if(x->runRec && (x->runF[i] = x->fs->open(fnbuf, FILE_READ))) {
+            x->runValid[i] = mpren_readRec(x->runF[i], x->runRec + i * MPREN_RECSIZE);
+        }
+    }
+}
+
+// Next file name in sort order; NULL if done
+const char *mpren_next(MpRen_Ctx *x)
+{
+    const char *best = NULL;
+    int bi = -1;
+
+    // Replace record returned last time
+    if(x->refill >= 0) {
+        x->runValid[x->refill] = mpren_readRec(x->runF[x->refill], x->runRec + x->refill * MPREN_RECSIZE);
+        x->refill = -1;
+    }
+
+    if(x->memIdx < x->n) {
+        best = x->a[x->memIdx];
+    }
+    for(int i = 0; i < x->runs; i++) {
+        const char *r = x->runRec + i * MPREN_RECSIZE;
+        if(x->runValid[i] && (!best || mpren_recCmp(r, best) < 0)) {
+            best = r;
+            bi = i;
+        }
+    }
+
+    if(!best) return NULL;
+
+    if(bi < 0) x->memIdx++;
+    else       x->refill = bi;
+
+    return best + strlen(best) + 1;
+}
@@ -0,0 +1,90 @@
+/*
+ * -------------------------------------------------------------------
+ * Remote Control
+ * (C) 2024-2026 Thomas Winischhofer (A10001986)
+ * https://github.com/realA10001986/Remote
+ * https://remote.out-a-ti.me
+ *
+ * Music player: Sort for the auto-renamer
+ * 
+ * -------------------------------------------------------------------
+ * License: Modified MIT NON-AI
+ * 
+ * Permission is hereby granted, free of charge, to any person 
+ * obtaining a copy of this software and associated documentation 
+ * files (the "Software"), to deal in the Software without restriction, 
+ * including without limitation the rights to use, copy, modify, 
+ * merge, publish, distribute, sublicense, and/or sell copies of the 
+ * Software, and to permit persons to whom the Software is furnished to 
+ * do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ * 
+ * Links inside the Software pointing to the original source must not 
+ * be changed or removed.
+ *
+ * In addition, the following restrictions apply:
+ * 
+ * 1. The Software and any modifications made to it may not be used 
+ * for the purpose of training or improving machine learning algorithms, 
+ * including but not limited to artificial intelligence, natural 
+ * language processing, or data mining. This condition applies to any 
+ * derivatives, modifications, or updates based on the Software code. 
+ * Any usage of the Software in an AI-training dataset is considered a 
+ * breach of this License.
+ *
+ * 2. The Software may not be included in any dataset used for 
+ * training or improving machine learning algorithms, including but 
+ * not limited to artificial intelligence, natural language processing, 
+ * or data mining.
+ *
+ * 3. Any person or organization found to be in violation of these 
+ * restrictions will be subject to legal action and may be held liable 
+ * for any damages resulting from such use.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * -------------------------------------------------------------------
+ */
+
+#ifndef _REMMPSORT_H
+#define _REMMPSORT_H
+
+#include <FS.h>
+
+// Buffers for names in memory; runs on SD if these are exhausted
+#define MPREN_BUFS     8
+#define MPREN_MAXRUNS  8
+#define MPREN_RECSIZE  (2 * 256)   // Key + name
+
+typedef struct {
+    fs::FS        *fs;                // For runs
+    void          (*idle)();          // Called while writing runs
+    char          **a;                // Records in memory
+    int           n;
+    char          *bufs[MPREN_BUFS];
+    int           numBufs;
+    int           curBuf;
+    char          *c;                 // Free space in current buffer
+    unsigned long bufSize;
+    int           runs;               // Runs written to SD
+    File          runF[MPREN_MAXRUNS];
+    char          *runRec;            // Current record of each run
+    bool          runValid[MPREN_MAXRUNS];
+    int           memIdx;             // Next record in memory
+    int           refill;             // Run to read next record from
+} MpRen_Ctx;
+
+bool        mpren_init(MpRen_Ctx *x, fs::FS *fs, void (*idle)());
+void        mpren_free(MpRen_Ctx *x);
+bool        mpren_add(MpRen_Ctx *x, const char *fn);
+void        mpren_sort(MpRen_Ctx *x);
+const char *mpren_next(MpRen_Ctx *x);
+
+#endif
@@ -66,7 +66,7 @@
 #include <Arduino.h>
 #include <math.h>
 #include "power.h"
-#include <Wire.h>
+#include "i2cbus.h"
 
 // SoC limits for "Low battery"
 // < _LOW = trigger warning
@@ -169,8 +169,7 @@ bool remPowMon::begin(bool doUse, int battProf, uint16_t battCap)
     pinMode(BALM_PIN, INPUT);
 
     // Check for IC on i2c bus
-    Wire.beginTransmission(_address);
-    if(!Wire.endTransmission(true)) {
+    if(i2cBus.probe(_address)) {
 
         // Shortcuts for CRC calculation
         _crcAW = _address << 1;
@@ -250,6 +249,11 @@ bool remPowMon::begin(bool doUse, int battProf, uint16_t battCap)
             _TTScanInt = SCANT_INT_BOOT;
 
             _usePwrMon = doUse;
+
+            // SOC/TTE are read by the i2c bus task if available
+            if(_usePwrMon) {
+                i2cBus.addPoller(pollTask, this);
+            }
         } else {
             #ifdef REMOTE_DBG
             Serial.println("Reading from BatMon IC failed");
@@ -272,33 +276,16 @@ bool remPowMon::havePM()
 int remPowMon::loop()
 {
     if(_usePwrMon) {
-        unsigned long now = millis();
         if(_useAlarm) {
+            unsigned long now = millis();
             if((now - _lastAScan > SCANA_INT)) {
                 _lastAScan = now;
                 _battWarn = digitalRead(BALM_PIN) ? 0 : 1;
             }
             return _battWarn;
-        } else if(now - _lastSScan > _SSScanInt) {
-            _lastSScan = now;
-            _SSScanInt = SCANS_INT;
-            if(readSOC()) {
-                _haveSOC = true;
-                if(!_lowSCond) {
-                    if(_soc < S_LIMIT_LOW) {
-                        _lowSCond = 1;
-                    }
-                } else if(_soc > S_LIMIT_HIGH) {
-                    _lowSCond = 0;
-                }
-            } else {
-                _haveSOC = false;
-                _lowSCond = -1;
-            }
-        } else if(now - _lastTScan > _TTScanInt) {
-            _lastTScan = now;
-            _TTScanInt = SCANT_INT;
-            _haveTTE = readTimeToEmpty();
+        } 
+        if(!i2cBus.isAsync()) {
+            poll();
         }
         _battWarn = 0;
         if(_lowSCond > 0) _battWarn |= 1;
@@ -308,6 +295,43 @@ int remPowMon::loop()
     }
 }
 
+void remPowMon::pollTask(void *arg)
+{
+    remPowMon *p = (remPowMon *)arg;
+    
+    if(!p->_useAlarm) {
+        p->poll();
+    }
+}
+
+// Periodic reading of SOC and TTE
+void remPowMon::poll()
+{
+    unsigned long now = millis();
+    
+    if(now - _lastSScan > _SSScanInt) {
+        _lastSScan = now;
+        _SSScanInt = SCANS_INT;
+        if(readSOC()) {
+            _haveSOC = true;
+            if(!_lowSCond) {
+                if(_soc < S_LIMIT_LOW) {
+                    _lowSCond = 1;
+                }
+            } else if(_soc > S_LIMIT_HIGH) {
+                _lowSCond = 0;
+            }
+        } else {
+            _haveSOC = false;
+            _lowSCond = -1;
+        }
+    } else if(now - _lastTScan > _TTScanInt) {
+        _lastTScan = now;
+        _TTScanInt = SCANT_INT;
+        _haveTTE = readTimeToEmpty();
+    }
+}
+
 bool remPowMon::readSOC()
 {
     if(_havePwrMon) {
@@ -367,16 +391,9 @@ bool remPowMon::read16(uint16_t regno, uint16_t& val)
     buf[1] = (uint8_t)regno;
     buf[2] = _crcAR;
 
-    Wire.beginTransmission(_address);
-    Wire.write(buf[1]);
-    Wire.endTransmission(false);
-
-    i2clen = Wire.requestFrom(_address, (uint8_t)3);
+    i2clen = i2cBus.writeRead(_address, &buf[1], 1, &buf[3], 3);
 
     if(i2clen == 3) {
-        buf[3] = Wire.read();
-        buf[4] = Wire.read();
-        buf[5] = Wire.read();
         if(crc8_atm(5, buf) == buf[5]) {
             val = buf[3] | (buf[4] << 8);
             return true;
@@ -394,12 +411,7 @@ void remPowMon::write16(uint16_t regno, uint16_t value)
     buf[2] = value & 0xff;
     buf[3] = value >> 8;
     buf[4] = crc8_atm(4, buf);
-    Wire.beginTransmission(_address);
-    Wire.write(buf[1]);
-    Wire.write(buf[2]);
-    Wire.write(buf[3]);
-    Wire.write(buf[4]);
-    Wire.endTransmission();
+    i2cBus.write(_address, &buf[1], 4);
 }
 
 #endif
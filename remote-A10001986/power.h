@@ -99,6 +99,9 @@ class remPowMon {
         int      _lowSCond = -1;
         
     private:
+        static void pollTask(void *arg);
+        void     poll();
+        
         bool     read16(uint16_t regno, uint16_t& val);
         void     write16(uint16_t regno, uint16_t value);
 
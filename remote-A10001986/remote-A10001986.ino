@@ -569,10 +569,12 @@
 #include <Wire.h>
 
 #include "display.h"
+#include "i2cbus.h"
 #include "remote_audio.h"
 #include "remote_settings.h"
 #include "remote_main.h"
 #include "remote_wifi.h"
+#include "remote_prof.h"
 
 void setup()
 {
@@ -583,6 +585,7 @@ void setup()
 
     // I2C init
     Wire.begin(-1, -1, 400000);
+    i2cBus.begin();
 
     main_boot();
     settings_setup();
@@ -594,12 +597,15 @@ void setup()
 
 void loop()
 {
-    audio_loop();
-    main_loop();
-    audio_loop();
-    wifi_loop();
-    audio_loop();
-    bttfn_loop();
+    PROF_CALL(PROF_AUDIO, audio_loop());
+    PROF_CALL(PROF_MAIN, main_loop());
+    PROF_CALL(PROF_AUDIO, audio_loop());
+    PROF_CALL(PROF_WIFI, wifi_loop());
+    PROF_CALL(PROF_AUDIO, audio_loop());
+    PROF_CALL(PROF_BTTFN, bttfn_loop());
+    #ifdef REMOTE_PROF
+    prof_loop();
+    #endif
 }
 
 #if defined(REMOTE_DBG) || defined(REMOTE_DBG_NET)
@@ -64,21 +64,27 @@
 #include "AudioGeneratorWAVLoop.h"
 #include "src/ESP8266Audio/AudioGeneratorMP3.h"
 #include "src/ESP8266Audio/AudioOutputI2S.h"
+#include "src/ESP8266Audio/AudioOutputMixer.h"
 
 #include "remote_main.h"
 #include "remote_settings.h"
 #include "remote_audio.h"
 #include "remote_wifi.h"
 #include "remote_click.h"
+#include "mpsort.h"
 
 static AudioGeneratorMP3 *mp3;
 static AudioGeneratorWAVLoop *wav;
+static AudioGeneratorWAVLoop *cmp;  // ADPCM/QOA in place of an mp3
 
-static AudioFileSourceFSLoop *myFS0L;
-static AudioFileSourceSDLoop *mySD0L;
+static AudioFileSourceFSLoop *myFS0L, *myFS1L;
+static AudioFileSourceSDLoop *mySD0L, *mySD1L;
 static AudioFileSourcePROGMEM *myPM;
 
 static AudioOutputI2S *out;
+static AudioOutputMixer *mixer;
+static AudioOutputMixerStub *mp3Out;
+static AudioOutputMixerStub *wavOut;
 
 bool audioInitDone = false;
 bool audioMute = false;
@@ -106,8 +112,6 @@ static const float volTable[VOL_LEVELS] = {
 static uint32_t g(uint32_t a, int o) { return a << (PA_MASKA - o); }
 
 static float    curVolFact = 1.0f;
-static bool     dynVol     = true;
-static int      sampleCnt = 0;
 
 static uint32_t playflags = 0;
 
@@ -115,6 +119,7 @@ static char     append_audio_file[256];
 static float    append_vol;
 static uint32_t append_flags;
 static bool     appendFile = false;
+static uint32_t appendSeq = 0;
 
 int8_t          mfstatus[10] = { 0 };
 
@@ -123,20 +128,1193 @@ static char     keylSnd[] = "/key3l.mp3"; // not const
 static uint32_t haveKeySnd = 0, haveKeyLSnd = 0;
 
 static const char *tcdrdone = "/TCD_DONE.TXT";   // leave "TCD", SD is interchangable this way
+
+// Music library index, one per music folder, written along with
+// tcdrdone. Layout: Header, entries, titles; all indexed by track
+// number.
+static const char *mpIdxName = "/RM_INDEX.BIN";
+#define MPIDX_MAGIC    0x58444d52   // "RMDX"
+#define MPIDX_VERSION  2
+#define MPIDX_NOSTART  0xffffffff   // audioStart: Not an mp3 (compact)
+#define MPIDX_TITLELEN 40
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t count;       // Number of entries (highest track number + 1)
+} MP_IdxHdr;
+typedef struct {
+    uint32_t size;        // File size; 0 if track does not exist
+    uint32_t audioStart;  // Offset of audio data (after ID3v2 tag)
+                          // where the engine starts the track
+    uint32_t duration;    // in ms
+} MP_IdxEnt;
+static MP_IdxEnt *mpIdx = NULL;
+static int       mpIdxCount = 0;
+#ifdef REMOTE_HAVEMQTT_MP
+static char      mpTitle[MPIDX_TITLELEN] = { 0 };
+static int       mpTitleNum = -1;
+#endif
+
 unsigned long   renNow1;
 unsigned long   renNow2;
 
-static float    getVolume();
+static float    getVolume();
+static float    getVolumeF(float fact);
+static void     play_click_int(bool mix);
+static int32_t  skipID3(char *buf);
+
+static int      mp_findMaxNum();
+static int      mp_peekNext();
+static bool     mp_checkForFile(int num);
+static bool     mp_haveTrack(int num);
+static bool     mp_loadIndex();
+static bool     mp_checkIndex();
+static bool     mp_buildIndex(bool isSetup);
+static void     mp_freeIndex();
+#ifdef REMOTE_HAVEMQTT_MP
+static void     mp_loadTitle(int num);
+#endif
+static void     mp_nextprev(bool forcePlay, bool next);
+static bool     mp_play_int(bool force);
+static void     mp_buildFileName(char *fnbuf, int num);
+static bool     mp_renameFilesInDir(bool isSetup);
+static uint8_t* mpren_renOrder(uint8_t *a, uint32_t s, int e);
+uint8_t*        m(uint8_t *a, uint32_t s, int e) { return mpren_renOrder(a, s, e/4); }
+static void     mpren_looper(bool isSetup, bool checking, int fileNum);
+static void     mpren_idle();
+
+/*
+ * Audio engine
+ *
+ * The engine owns generators, file sources and the output; nothing
+ * else touches them. The control functions below post commands to
+ * the engine, which runs either in its own task on the other core
+ * (REMOTE_AUDIO_TASK) or inline from audio_loop().
+ * The engine reports the end of a sound through aeDoneSeq; the
+ * control side compares this against the sequence number of the
+ * last sound it started.
+ */
+
+#define AE_PLAY     1
+#define AE_STOP     2
+#define AE_STOPMP3  3
+#define AE_CLICK    4
+#define AE_THRUP    5
+#define AE_NOLOOP   6
+#define AE_CLICKOVL 7
+#define AE_QUEUE    8
+#define AE_ACFLUSH  9
+
+#define AUD_NONE    0
+#define AUD_MP3     1
+#define AUD_WAV     2
+
+#define AE_FNLEN    64
+
+typedef struct {
+    uint8_t  cmd;
+    uint32_t flags;
+    uint32_t seq;
+    float    gain;
+    bool     cont;      // Follows the previous sound (gap stats)
+    int32_t  start;     // Offset of audio data from the index, or -1;
+    uint32_t size;      // valid if the file still has this size
+    char     fn[AE_FNLEN];
+} AE_Cmd;
+
+// Engine side
+static bool              aeDynVol = false;
+static bool              aeOvl = false;
+static volatile bool     aeOvlFailed = false;
+static int               aeSampleCnt = 0;
+static volatile uint32_t aeSeq = 0;
+static volatile uint32_t aeDoneSeq = 0;
+
+// Gapless continuation: The mp3 generator carries on with aeNextSrc
+// once the current file is exhausted
+static AudioFileSourceLoop *aeSrc = NULL;
+static AudioFileSourceLoop *aeNextSrc = NULL;
+static uint32_t          aeNextSeq = 0;
+static uint32_t          aeNextFlags = 0;
+static float             aeNextGain = 1.0f;
+
+// Gap statistics: Time from the end of a sound to the first output
+// of the one following it (appended file, next track)
+static unsigned long     aeEndT = 0, aeGapT = 0;
+static uint32_t          aeGapCnt = 0, aeGapless = 0, aeGapMax = 0;
+static uint64_t          aeGapSum = 0;
+
+// Control side
+static uint32_t          audSeqCnt = 0;
+static uint32_t          audSeq = 0;
+static uint8_t           audType = AUD_NONE;
+static bool              audCont = false;
+static int               audTrack = -1;       // Track being played
+static bool              audPrefetched = false;
+static uint32_t          audNextSeq = 0;
+static int               audNextTrack = -1;   // -1: appended file
+static uint32_t          audNextAppSeq = 0;
+
+#ifdef REMOTE_AUDIO_TASK
+// Single-producer/single-consumer queue; main loop only writes aeIn,
+// audio task only writes aeOut.
+#define AE_QUEUE_SIZE 16
+static AE_Cmd            aeQueue[AE_QUEUE_SIZE];
+static volatile uint8_t  aeIn = 0;
+static volatile uint8_t  aeOut = 0;
+static TaskHandle_t      aeTask = NULL;
+#else
+static AE_Cmd            aeCmd;
+#endif
+
+static unsigned long     aeStartT = 0;
+
+#ifdef REMOTE_SND_CACHE
+/*
+ * PCM cache for short sound effects
+ *
+ * When a listed effect is played from file, its decoded samples are
+ * captured on the way to the output. Later, it is played from RAM 
+ * through wav->beginQuick(). Least recently used entries are evicted
+ * when the budget is exhausted. Engine side only, apart from the
+ * statistics.
+ */
+
+#define AC_ENTRIES    12
+#define AC_BUDGET     (40*1024)     // bytes, internal RAM
+#define AC_BUDGET_PS  (1024*1024)   // bytes, PSRAM
+#define AC_STEP       (8*1024)      // bytes, first capture buffer, at most
+#define AC_MINSTEP    1024          //        and at least
+
+typedef struct {
+    char     fn[AE_FNLEN];
+    bool     allowSD;
+    int16_t  *pcm;                  // NULL: uncacheable, don't retry
+    uint32_t len;                   // bytes
+    uint32_t rate;
+    uint32_t lastUse;
+} AC_Entry;
+
+// Cacheable effects; '?' matches any character
+static const char *acList[] = {
+    "/brakeon.mp3", "/brakeoff.mp3", 
+    "/travelstart.mp3", "/travelstart2.mp3",
+    "/buttonl.mp3", "/buttonel.mp3", "/volchg.mp3",
+    "/key?.mp3", "/key?l.mp3",
+    NULL
+};
+
+static bool ac_grow(uint32_t frames);
+
+// Passes everything on to the real output, keeps a copy of what
+// the output accepted
+class AudioOutputCapture : public AudioOutput
+{
+  public:
+    void setSink(AudioOutput *s) { sink = s; }
+    void start(int16_t *b, uint32_t maxFrames) 
+    {
+        buf = b; size = maxFrames; frames = 0; overflow = false;
+    }
+    void resize(int16_t *b, uint32_t maxFrames) { buf = b; size = maxFrames; }
+    int  getRate() { return hertz; }
+    int  getChannels() { return channels; }
+    
+    virtual bool SetRate(int hz) override { hertz = hz; return sink->SetRate(hz); }
+    virtual bool SetBitsPerSample(int bits) override { bps = bits; return sink->SetBitsPerSample(bits); }
+    virtual bool SetChannels(int chan) override { channels = chan; return sink->SetChannels(chan); }
+    virtual bool SetGain(float f1, int mutechnls = 0) override { return sink->SetGain(f1, mutechnls); }
+    virtual bool begin() override { return sink->begin(); }
+    virtual size_t ConsumeSample(int16_t sL, int16_t sR) override
+    {
+        size_t r = sink->ConsumeSample(sL, sR);
+        if(r) store(&sL, 1, 0);
+        return r;
+    }
+    virtual size_t ConsumeSamples(const int16_t *samples, size_t n) override
+    {
+        n = sink->ConsumeSamples(samples, n);
+        store(samples, n, 2);
+        return n;
+    }
+    virtual bool stop() override { return sink->stop(); }
+    virtual void flush() override { sink->flush(); }
+    virtual bool loop() override { return sink->loop(); }
+
+    uint32_t frames = 0;
+    bool     overflow = false;
+    
+  private:
+    // Keep left channel only; cached effects are mono
+    void store(const int16_t *s, size_t n, int step)
+    {
+        if(overflow) return;
+        if(frames + n > size && !ac_grow(frames + n)) {
+            overflow = true;
+            return;
+        }
+        for(size_t i = 0; i < n; i++, s += step) {
+            buf[frames++] = *s;
+        }
+    }
+    
+    AudioOutput *sink = NULL;
+    int16_t  *buf = NULL;
+    uint32_t size = 0;
+};
+
+static AudioOutputCapture *acCap = NULL;
+static AC_Entry  acCache[AC_ENTRIES];
+static AC_Entry  *acCapEntry = NULL;
+static bool      acPSRAM = false;
+static uint32_t  acBudget = 0;
+static uint32_t  acUsed = 0;
+static uint32_t  acClock = 0;
+static bool      aeFromCache = false;
+static bool      acPlaying = false;     // Main sound is a cached effect
+static bool      acCapStale = false;    // Flushed while capturing
+
+// Statistics; start latency is from command to first block output
+static uint32_t  acHits = 0, acMisses = 0;
+static uint32_t  acLatCnt[2] = { 0, 0 };
+static uint64_t  acLatSum[2] = { 0, 0 };
+
+static bool ac_listed(const char *fn)
+{
+    for(int i = 0; acList[i]; i++) {
+        const char *a = acList[i], *b = fn;
+        while(*a && *b && (*a == *b || *a == '?')) {
+            a++; b++;
+        }
+        if(!*a && !*b) return true;
+    }
+    return false;
+}
+
+static AC_Entry *ac_find(const char *fn, bool allowSD)
+{
+    for(int i = 0; i < AC_ENTRIES; i++) {
+        AC_Entry *e = &acCache[i];
+        if(e->fn[0] && e->allowSD == allowSD && !strcmp(e->fn, fn)) 
+            return e;
+    }
+    return NULL;
+}
+
+static void ac_free(AC_Entry *e)
+{
+    if(e->pcm) {
+        free(e->pcm);
+        acUsed -= e->len;
+    }
+    e->pcm = NULL;
+    e->len = 0;
+    e->fn[0] = 0;
+}
+
+// Least recently used entry, other than the one being captured
+static AC_Entry *ac_lru()
+{
+    AC_Entry *lru = NULL;
+
+    for(int i = 0; i < AC_ENTRIES; i++) {
+        AC_Entry *e = &acCache[i];
+        if(e->fn[0] && e != acCapEntry && (!lru || e->lastUse < lru->lastUse)) {
+            lru = e;
+        }
+    }
+    return lru;
+}
+
+// Evict LRU entries until "len" more bytes fit
+static bool ac_evict(uint32_t len)
+{
+    AC_Entry *lru;
+
+    while(acUsed + len > acBudget) {
+        if(!(lru = ac_lru())) return false;
+        ac_free(lru);
+    }
+    return true;
+}
+
+// Find a free entry with room for "len" bytes, evict LRU entries
+// until there is one
+static AC_Entry *ac_getSlot(uint32_t len)
+{
+    AC_Entry *lru;
+
+    if(!ac_evict(len)) return NULL;
+    for(;;) {
+        for(int i = 0; i < AC_ENTRIES; i++) {
+            if(!acCache[i].fn[0]) return &acCache[i];
+        }
+        if(!(lru = ac_lru())) return NULL;
+        ac_free(lru);
+    }
+}
+
+// Returns the output to hand the generator. The capture buffer
+// starts with what is free and grows as needed (ac_grow()), so
+// capturing a short effect doesn't evict others.
+static AudioOutput *ac_beginCapture(const char *fn, bool allowSD)
+{
+    uint32_t len = (acUsed + AC_STEP <= acBudget) ? AC_STEP : acBudget - acUsed;
+    AC_Entry *e;
+    int16_t *b;
+
+    if(len < AC_MINSTEP) len = AC_MINSTEP;
+    if(!(e = ac_getSlot(len))) return mp3Out;
+
+    b = (int16_t *)(acPSRAM ? ps_malloc(len) : malloc(len));
+    if(!b) return mp3Out;
+
+    strcpy(e->fn, fn);
+    e->allowSD = allowSD;
+    e->pcm = b;
+    e->len = len;
+    e->lastUse = ++acClock;
+    acUsed += len;
+    acCapEntry = e;
+    acCapStale = false;
+
+    acCap->start(b, len / sizeof(int16_t));
+
+    return acCap;
+}
+
+// Make room for "frames" in the capture buffer: Double its size,
+// up to the largest size allowed for a single effect, or grow by
+// just what is needed if doubling would evict other entries
+static bool ac_grow(uint32_t frames)
+{
+    AC_Entry *e = acCapEntry;
+    uint32_t need = frames * sizeof(int16_t), len;
+    int16_t *b;
+
+    if(!e || need > acBudget / 2) return false;
+
+    for(len = e->len * 2; len < need; len *= 2) ;
+    if(len > acBudget / 2) len = acBudget / 2;
+    if(acUsed + len - e->len > acBudget) len = need;
+
+    if(!ac_evict(len - e->len)) return false;
+
+    b = (int16_t *)(acPSRAM ? ps_realloc(e->pcm, len) : realloc(e->pcm, len));
+    if(!b) return false;
+
+    acUsed += len - e->len;
+    e->pcm = b;
+    e->len = len;
+    acCap->resize(b, len / sizeof(int16_t));
+
+    return true;
+}
+
+// complete: Sound played to the end; otherwise discard
+static void ac_endCapture(bool complete)
+{
+    AC_Entry *e = acCapEntry;
+    int16_t *p;
+
+    if(!e) return;
+    acCapEntry = NULL;
+
+    if(!complete || acCapStale) {
+        ac_free(e);
+        return;
+    }
+
+    acUsed -= e->len;
+    
+    if(acCap->overflow || acCap->getChannels() != 1 || !acCap->frames) {
+        // Keep the entry as a marker so we don't try again
+        free(e->pcm);
+        e->pcm = NULL;
+        e->len = 0;
+        return;
+    }
+
+    e->len = acCap->frames * sizeof(int16_t);
+    if((p = (int16_t *)realloc(e->pcm, e->len))) {
+        e->pcm = p;
+    }
+    e->rate = acCap->getRate();
+    acUsed += e->len;
+
+    #ifdef REMOTE_DBG
+    Serial.printf("Audio: Cached %s, %d bytes\n", e->fn, e->len);
+    #endif
+}
+
+// Forget all cached effects. An effect playing from the cache is
+// stopped; one being captured is discarded when it ends.
+static void ac_flush()
+{
+    if(acPlaying && !aeOvl && wav->isRunning()) {
+        wav->stop();
+    }
+    acPlaying = false;
+    for(int i = 0; i < AC_ENTRIES; i++) {
+        if(&acCache[i] != acCapEntry) {
+            ac_free(&acCache[i]);
+        }
+    }
+    if(acCapEntry) {
+        acCapStale = true;
+    }
+}
+
+/*
+ * Statistics for profiler output
+ */
+int audio_cacheStats(char *buf, int bufSize)
+{
+    uint32_t total = acHits + acMisses;
+    int cnt = 0;
+    int len;
+
+    for(int i = 0; i < AC_ENTRIES; i++) {
+        if(acCache[i].pcm) cnt++;
+    }
+
+    len = snprintf(buf, bufSize, "sndcache %s: %d ent %u/%u bytes hit=%u miss=%u (%u%%) start=%u/%uus\n",
+              acPSRAM ? "psram" : "ram", cnt, acUsed, acBudget, acHits, acMisses,
+              total ? (acHits * 100) / total : 0,
+              acLatCnt[1] ? (uint32_t)(acLatSum[1] / acLatCnt[1]) : 0,
+              acLatCnt[0] ? (uint32_t)(acLatSum[0] / acLatCnt[0]) : 0);
+
+    return (len < bufSize) ? len : bufSize - 1;
+}
+
+void audio_cacheResetStats()
+{
+    acHits = acMisses = 0;
+    acLatCnt[0] = acLatCnt[1] = 0;
+    acLatSum[0] = acLatSum[1] = 0;
+}
+#endif  // REMOTE_SND_CACHE
+
+#ifdef REMOTE_SND_NEGCACHE
+/*
+ * Negative lookup cache
+ *
+ * Sound names (not music) that were looked up in vain on SD and/or 
+ * the flash FS, in a small hash table. A failed open on SD costs a
+ * full FAT directory scan; most effects are never on SD, but are
+ * allowed to be substituted from there, so without this, every
+ * play would pay for that scan.
+ * Used from both the engine and the control side; entries change
+ * under nlMux, file system access happens outside. The table is
+ * flushed whenever the contents of the SD card change.
+ */
+#define NL_SIZE   64            // Power of 2
+#define NL_FNLEN  24
+#define NL_NOTSD  0x01
+#define NL_NOTFS  0x02
+
+typedef struct {
+    uint32_t hash;
+    uint8_t  flags;             // NL_*; 0 = free
+    char     fn[NL_FNLEN];
+} NL_Entry;
+
+static NL_Entry     nlTab[NL_SIZE];
+static portMUX_TYPE nlMux = portMUX_INITIALIZER_UNLOCKED;
+
+static uint32_t nl_hash(const char *fn)
+{
+    uint32_t h = 2166136261UL;
+    while(*fn) {
+        h ^= (uint8_t)*fn++;
+        h *= 16777619UL;
+    }
+    return h;
+}
+
+// Returns slot for fn, or a free slot if not found, or -1 if full
+static int nl_slot(const char *fn, uint32_t h)
+{
+    for(int i = 0, j = h & (NL_SIZE - 1); i < NL_SIZE; i++, j = (j + 1) & (NL_SIZE - 1)) {
+        if(!nlTab[j].flags) 
+            return j;
+        if(nlTab[j].hash == h && !strcmp(nlTab[j].fn, fn))
+            return j;
+    }
+    return -1;
+}
+
+static uint8_t nl_get(const char *fn)
+{
+    uint32_t h = nl_hash(fn);
+    uint8_t ret = 0;
+    int i;
+
+    portENTER_CRITICAL(&nlMux);
+    if((i = nl_slot(fn, h)) >= 0) {
+        ret = nlTab[i].flags;
+    }
+    portEXIT_CRITICAL(&nlMux);
+
+    return ret;
+}
+
+static void nl_set(const char *fn, uint8_t flag)
+{
+    uint32_t h = nl_hash(fn);
+    int i;
+
+    if(strlen(fn) >= NL_FNLEN)
+        return;
+
+    portENTER_CRITICAL(&nlMux);
+    if((i = nl_slot(fn, h)) >= 0) {
+        if(!nlTab[i].flags) {
+            nlTab[i].hash = h;
+            strcpy(nlTab[i].fn, fn);
+        }
+        nlTab[i].flags |= flag;
+    }
+    portEXIT_CRITICAL(&nlMux);
+}
+#endif  // REMOTE_SND_NEGCACHE
+
+static void ae_unqueue();
+
+static void ae_stopAll()
+{
+    ae_unqueue();
+    if(mp3->isRunning()) {
+        mp3->stop();
+    }
+    if(cmp->isRunning()) {
+        cmp->stop();
+    }
+    if(wav->isRunning()) {
+        wav->stop();
+    }
+    aeOvl = false;
+    #ifdef REMOTE_SND_CACHE
+    ac_endCapture(false);
+    acPlaying = false;
+    #endif
+}
+
+static bool ae_isCompact(const char *buf)
+{
+    return (!memcmp(buf, "RIFF", 4) || !memcmp(buf, "qoaf", 4));
+}
+
+// Sound packs may contain IMA-ADPCM WAV or QOA data under the usual
+// ".mp3" names. These are decoded by a wav generator of their own,
+// at a fraction of the CPU time of an mp3, and otherwise treated 
+// like an mp3 (output, clicks mixed over, stop).
+static void ae_beginCompact(AudioFileSourceLoop *src, AudioOutput *o, uint32_t flags)
+{
+    src->seek(0, SEEK_SET);
+    if(cmp->begin(src, o) && (flags & PA_LOOP)) {
+        src->setStartPos(cmp->startPos);
+    }
+}
+
+// Gain of the main sound; an overlay keeps its own
+static void ae_setGain(float g)
+{
+    mp3Out->SetGain(g);
+    if(!aeOvl) wavOut->SetGain(g);
+}
+
+// Open a sound on SD (if allowed) or in flash, in this order; 
+// returns the source it was opened in, or NULL if not found
+static AudioFileSourceLoop *ae_open(AudioFileSourceLoop *sd, AudioFileSourceLoop *fs, const char *fn, uint32_t flags)
+{
+    bool allowSD = haveSD && ((flags & PA_ALLOWSD) || FlashROMode);
+    
+    #ifdef REMOTE_SND_NEGCACHE
+    uint8_t nl = (flags & PA_MUSIC) ? 0 : nl_get(fn);
+    
+    if(allowSD && !(nl & NL_NOTSD)) {
+        if(sd->open(fn)) return sd;
+        if(!(flags & PA_MUSIC)) nl_set(fn, NL_NOTSD);
+    }
+    if(haveFS && !(nl & NL_NOTFS)) {
+        if(fs->open(fn)) return fs;
+        if(!(flags & PA_MUSIC)) nl_set(fn, NL_NOTFS);
+    }
+    #else
+    if(allowSD && sd->open(fn)) return sd;
+    if(haveFS && fs->open(fn)) return fs;
+    #endif
+    
+    return NULL;
+}
+
+// Start of the audio data of an indexed track; -1 if the header
+// needs to be read
+static int32_t ae_indexedStart(AE_Cmd *c, AudioFileSourceLoop *src)
+{
+    return (c->start >= 0 && src->getSize() == c->size) ? c->start : -1;
+}
+
+static void ae_play(AE_Cmd *c)
+{
+    char buf[16];
+    int32_t curSeek = 0;
+    uint32_t flags = c->flags;
+    const char *audio_file = c->fn;
+    AudioOutput *o = mp3Out;
+    AudioFileSourceLoop *src;
+
+    // If something is currently on, kill it
+    ae_stopAll();
+
+    aeSeq = c->seq;
+    aeDynVol = !!(flags & PA_DYNVOL);
+    aeStartT = micros();
+    aeGapT = c->cont ? aeEndT : 0;
+    
+    ae_setGain(c->gain);
+
+    #ifdef REMOTE_SND_CACHE
+    aeFromCache = false;
+    if(!(flags & (PA_WAV|PA_LOOP)) && ac_listed(audio_file)) {
+        bool allowSD = haveSD && ((flags & PA_ALLOWSD) || FlashROMode);
+        AC_Entry *e = ac_find(audio_file, allowSD);
+        if(e) {
+            e->lastUse = ++acClock;
+            if(e->pcm) {
+                acHits++;
+                aeFromCache = true;
+                acPlaying = true;
+                myPM->open(e->pcm, e->len);
+                wav->beginQuick(myPM, wavOut, 1, 0, e->rate);
+                return;
+            }
+        } else {
+            o = ac_beginCapture(audio_file, allowSD);
+        }
+        acMisses++;
+    }
+    #endif
+
+    buf[0] = 0;
+
+    if((src = ae_open(mySD0L, myFS0L, audio_file, flags))) {
+        
+        src->setPlayLoop(!!(flags & PA_LOOP));
+
+        if(flags & PA_WAV) {
+            wav->begin(src, wavOut);
+            if(flags & PA_LOOP) src->setStartPos(wav->startPos);
+        } else {
+            if((curSeek = ae_indexedStart(c, src)) < 0) {
+                src->read((void *)buf, 10);
+                curSeek = ae_isCompact(buf) ? -1 : skipID3(buf);
+            }
+            if(curSeek < 0) {
+                ae_beginCompact(src, o, flags);
+            } else {
+                src->setStartPos(curSeek);
+                src->seek(curSeek, SEEK_SET);
+                mp3->begin(src, o);
+                aeSrc = src;
+            }
+        }
+        
+        #ifdef REMOTE_DBG
+        Serial.println((src == mySD0L) ? "Playing from SD" : "Playing from flash FS");
+        #endif
+    } else {
+        #ifdef REMOTE_DBG
+        Serial.println("Audio file not found");
+        #endif
+        #ifdef REMOTE_SND_CACHE
+        ac_endCapture(false);
+        #endif
+    }
+}
+
+static void ae_playQuick(AE_Cmd *c)
+{
+    ae_stopAll();
+
+    aeSeq = c->seq;
+    aeDynVol = false;
+    aeStartT = micros();
+    #ifdef REMOTE_SND_CACHE
+    aeFromCache = true;
+    #endif
+
+    ae_setGain(c->gain);
+
+    if(c->cmd == AE_CLICK) {
+        myPM->open(data_click_wav, data_click_wav_len);
+    } else {
+        myPM->open(data_throttleup_wav, data_throttleup_wav_len);
+    }
+    wav->beginQuick(myPM, wavOut, 1, 44);
+}
+
+// Mix a click over the running sound without touching the main
+// sound's sequence. If that's impossible (wav generator busy), the
+// control side plays it as the main sound.
+static void ae_overlay(AE_Cmd *c)
+{
+    if(wav->isRunning() && !aeOvl) {
+        aeOvlFailed = true;
+        return;
+    }
+
+    if(wav->isRunning()) {
+        wav->stop();
+    }
+
+    aeOvl = true;
+    wavOut->SetGain(c->gain);
+    myPM->open(data_click_wav, data_click_wav_len);
+    if(!wav->beginQuick(myPM, wavOut, 1, 44)) {
+        aeOvl = false;
+    }
+}
+
+// Open a file to follow the current one in the source objects
+// the generator isn't using. Returns NULL if not found.
+static AudioFileSourceLoop *ae_openNext(AE_Cmd *c)
+{
+    AudioFileSourceLoop *src = NULL;
+    char buf[16];
+    int32_t curSeek;
+
+    src = ae_open((aeSrc == mySD0L) ? mySD1L : mySD0L, 
+                  (aeSrc == myFS0L) ? myFS1L : myFS0L, c->fn, c->flags);
+
+    if(src) {
+        src->setPlayLoop(false);
+        if((curSeek = ae_indexedStart(c, src)) < 0) {
+            src->read((void *)buf, 10);
+            // Can't follow an mp3 in the same generator
+            if(ae_isCompact(buf)) {
+                src->close();
+                return NULL;
+            }
+            curSeek = skipID3(buf);
+        }
+        src->setStartPos(curSeek);
+        src->seek(curSeek, SEEK_SET);
+    }
+
+    return src;
+}
+
+// Check if the generator has moved on to the queued file
+static void ae_checkSwitch()
+{
+    uint32_t old;
+    
+    if(!aeNextSrc || !mp3->isRunning() || mp3->GetNextSource())
+        return;
+
+    aeSrc = aeNextSrc;
+    aeNextSrc = NULL;
+    aeDynVol = !!(aeNextFlags & PA_DYNVOL);
+    ae_setGain(aeNextGain);
+
+    aeGapCnt++;
+    aeGapless++;
+
+    // Control side reads aeDoneSeq first, then aeSeq
+    old = aeSeq;
+    aeSeq = aeNextSeq;
+    __sync_synchronize();
+    aeDoneSeq = old;
+}
+
+static void ae_unqueue()
+{
+    ae_checkSwitch();
+    if(aeNextSrc) {
+        mp3->SetNextSource(NULL);
+        aeNextSrc->close();
+        aeNextSrc = NULL;
+    }
+}
+
+// Prepare the file following the current one; if this is not
+// possible, the control side starts it after the current one ended.
+static void ae_queue(AE_Cmd *c)
+{
+    ae_unqueue();
+
+    // Only an MP3 can follow an MP3 without a gap
+    if(!mp3->isRunning() || (c->flags & (PA_WAV|PA_LOOP)))
+        return;
+
+    #ifdef REMOTE_SND_CACHE
+    // Would end up in the captured effect
+    if(acCapEntry)
+        return;
+    #endif
+
+    if(!(aeNextSrc = ae_openNext(c)))
+        return;
 
-static int      mp_findMaxNum();
-static bool     mp_checkForFile(int num);
-static void     mp_nextprev(bool forcePlay, bool next);
-static bool     mp_play_int(bool force);
-static void     mp_buildFileName(char *fnbuf, int num);
-static bool     mp_renameFilesInDir(bool isSetup);
-static uint8_t* mpren_renOrder(uint8_t *a, uint32_t s, int e);
-uint8_t*        m(uint8_t *a, uint32_t s, int e) { return mpren_renOrder(a, s, e/4); }
-static void     mpren_insertionSort(char **a, int n);
+    aeNextSeq = c->seq;
+    aeNextFlags = c->flags;
+    aeNextGain = c->gain;
+    mp3->SetNextSource(aeNextSrc);
+}
+
+static void ae_exec(AE_Cmd *c)
+{
+    switch(c->cmd) {
+    case AE_PLAY:
+        ae_play(c);
+        break;
+    case AE_STOP:
+        ae_stopAll();
+        break;
+    case AE_STOPMP3:
+        ae_unqueue();
+        if(mp3->isRunning()) {
+            mp3->stop();
+        }
+        if(cmp->isRunning()) {
+            cmp->stop();
+        }
+        #ifdef REMOTE_SND_CACHE
+        // Cached effects play on the wav generator
+        if(acPlaying && !aeOvl && wav->isRunning()) {
+            wav->stop();
+        }
+        acPlaying = false;
+        #endif
+        break;
+    #ifdef REMOTE_SND_CACHE
+    case AE_ACFLUSH:
+        ac_flush();
+        break;
+    #endif
+    case AE_CLICK:
+    case AE_THRUP:
+        ae_playQuick(c);
+        break;
+    case AE_CLICKOVL:
+        ae_overlay(c);
+        break;
+    case AE_QUEUE:
+        ae_queue(c);
+        break;
+    case AE_NOLOOP:
+        if(haveSD) {
+            mySD0L->setPlayLoop(false);
+        }
+        if(haveFS) {
+            myFS0L->setPlayLoop(false);
+        }
+        break;
+    }
+}
+
+// Run generators; returns false if no main sound is playing
+static bool ae_runGens()
+{
+    AudioGenerator *gen;
+
+    // The overlay isn't tracked through aeDoneSeq
+    if(aeOvl && !(wav->isRunning() && wav->loop())) {
+        if(wav->isRunning()) {
+            wav->stop();
+        }
+        aeOvl = false;
+    }
+
+    if(mp3->isRunning()) {
+        gen = mp3;
+    } else if(cmp->isRunning()) {
+        gen = cmp;
+    } else if(wav->isRunning() && !aeOvl) {
+        gen = wav;
+    } else {
+        // Covers failed starts and stopped sounds as well
+        ae_unqueue();
+        #ifdef REMOTE_SND_CACHE
+        ac_endCapture(false);
+        #endif
+        aeDoneSeq = aeSeq;
+        return false;
+    }
+
+    if(!gen->loop()) {
+        ae_unqueue();
+        gen->stop();
+        #ifdef REMOTE_SND_CACHE
+        ac_endCapture(true);
+        #endif
+        aeEndT = micros();
+        aeDoneSeq = aeSeq;
+        return false;
+    }
+
+    if(gen == mp3) {
+        ae_checkSwitch();
+    }
+
+    if(aeStartT) {
+        #ifdef REMOTE_SND_CACHE
+        acLatCnt[aeFromCache]++;
+        acLatSum[aeFromCache] += micros() - aeStartT;
+        #endif
+        aeStartT = 0;
+    }
+
+    if(aeGapT) {
+        uint32_t gap = micros() - aeGapT;
+        aeGapCnt++;
+        aeGapSum += gap;
+        if(gap > aeGapMax) aeGapMax = gap;
+        aeGapT = 0;
+    }
+
+    if(aeDynVol) {
+        aeSampleCnt++;
+        if(aeSampleCnt > 1) {
+            ae_setGain(getVolume());
+            aeSampleCnt = 0;
+        }
+    }
+
+    return true;
+}
+
+// Feed the output; returns false if there is nothing to do
+static bool ae_pump()
+{
+    bool playing;
+
+    // Generators only fill the mixer's buffer; repeat until the 
+    // output takes no more
+    do {
+        playing = ae_runGens();
+    } while(mixer->Pump());
+
+    return playing || aeOvl || mixer->isActive();
+}
+
+#ifdef REMOTE_AUDIO_TASK
+static void audioTask(void *parameter)
+{
+    for(;;) {
+        while(aeOut != aeIn) {
+            __sync_synchronize();
+            ae_exec(&aeQueue[aeOut]);
+            __sync_synchronize();
+            aeOut = (aeOut + 1) & (AE_QUEUE_SIZE - 1);
+        }
+        if(ae_pump()) {
+            // DMA buffers are full, they last for >40ms
+            vTaskDelay(1);
+        } else {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        }
+    }
+}
+#endif
+
+/*
+ * Control side: Post commands to engine
+ */
+
+static AE_Cmd *aud_newCmd(uint8_t cmd)
+{
+    AE_Cmd *c;
+
+    #ifdef REMOTE_AUDIO_TASK
+    // Queue full: Wait for audio task to catch up
+    while(((aeIn + 1) & (AE_QUEUE_SIZE - 1)) == aeOut) {
+        vTaskDelay(1);
+    }
+    c = &aeQueue[aeIn];
+    #else
+    c = &aeCmd;
+    #endif
+
+    c->cmd = cmd;
+    
+    return c;
+}
+
+static void aud_post()
+{
+    #ifdef REMOTE_AUDIO_TASK
+    __sync_synchronize();
+    aeIn = (aeIn + 1) & (AE_QUEUE_SIZE - 1);
+    xTaskNotifyGive(aeTask);
+    #else
+    ae_exec(&aeCmd);
+    #endif
+}
+
+// Wait until the engine has executed all posted commands
+static void aud_sync()
+{
+    #ifdef REMOTE_AUDIO_TASK
+    while(aeOut != aeIn) {
+        vTaskDelay(1);
+    }
+    #endif
+}
+
+// Tell the engine where the track's audio data starts, if the index
+// knows it
+static void aud_setStart(AE_Cmd *c, int num)
+{
+    c->start = -1;
+    if(mpIdx && num >= 0 && num < mpIdxCount && mpIdx[num].size &&
+       mpIdx[num].audioStart != MPIDX_NOSTART) {
+        c->start = mpIdx[num].audioStart;
+        c->size = mpIdx[num].size;
+    }
+}
+
+static void aud_play(uint8_t cmd, uint8_t type, uint32_t flags, const char *audio_file)
+{
+    AE_Cmd *c = aud_newCmd(cmd);
+
+    c->flags = flags;
+    c->seq = audSeq = ++audSeqCnt;
+    c->gain = getVolume();
+    c->cont = audCont;
+    aud_setStart(c, audTrack);
+    if(audio_file) {
+        strncpy(c->fn, audio_file, AE_FNLEN - 1);
+        c->fn[AE_FNLEN - 1] = 0;
+    }
+    audType = type;
+    audNextSeq = 0;
+    audPrefetched = false;
+
+    aud_post();
+}
+
+// Queue a file to follow the current one without a gap
+static void aud_queue(const char *audio_file, uint32_t flags, float volumeFactor, int track)
+{
+    AE_Cmd *c = aud_newCmd(AE_QUEUE);
+
+    c->flags = flags;
+    c->seq = audNextSeq = ++audSeqCnt;
+    c->gain = getVolumeF(volumeFactor);
+    strncpy(c->fn, audio_file, AE_FNLEN - 1);
+    c->fn[AE_FNLEN - 1] = 0;
+    aud_setStart(c, (track >= 0) ? playList[track] : -1);
+    audNextTrack = track;
+    audNextAppSeq = appendSeq;
+    audPrefetched = true;
+
+    aud_post();
+}
+
+static void aud_stop(uint8_t cmd)
+{
+    aud_newCmd(cmd);
+    aud_post();
+
+    audNextSeq = 0;
+
+    if(cmd == AE_STOP || audType == AUD_MP3) {
+        audType = AUD_NONE;
+    }
+}
+
+// Take over if the engine has switched to the queued file
+static void aud_update()
+{
+    if(!audNextSeq || aeSeq != audNextSeq)
+        return;
+
+    audSeq = audNextSeq;
+    audNextSeq = 0;
+    audPrefetched = false;
+
+    if(audNextTrack >= 0) {
+        mpCurrIdx = audNextTrack;
+        aud_state.curTrack = playList[mpCurrIdx];
+        curVolFact = 1.0f;
+        #ifdef REMOTE_HAVEMQTT_MP
+        mp_sendStatus();
+        #endif
+    } else {
+        curVolFact = append_vol;
+        playflags  = append_flags & (PA_KMASK | PA_THRUP | PA_NOINTR);
+        if(appendSeq == audNextAppSeq) {
+            appendFile = false;
+        }
+        if(mpActive && !(append_flags & PA_MUSIC)) {
+            mpActive = false;
+            #ifdef REMOTE_HAVEMQTT_MP
+            mp_sendStatus();
+            #endif
+        }
+    }
+}
+
+static bool aud_done()
+{
+    // Read aeDoneSeq before aeSeq, see ae_checkSwitch()
+    uint32_t done = aeDoneSeq;
+    
+    __sync_synchronize();
+    aud_update();
+    
+    return ((int32_t)(done - audSeq) >= 0);
+}
+
+// Queue what follows the current sound (appended file, next track)
+// so the engine can switch over without a gap
+static void aud_prefetch()
+{
+    char fnbuf[20];
+    int track;
+
+    if(audType != AUD_MP3 || audioMute)
+        return;
+
+    if(appendFile) {
+        // Queue again if a track or an older appended file is queued
+        if(audPrefetched && 
+           !(audNextSeq && (audNextTrack >= 0 || audNextAppSeq != appendSeq)))
+            return;
+        if(append_flags & (PA_WAV|PA_LOOP))
+            return;
+        // Cases play_file() refuses are left to it
+        if(mpActive && !(append_flags & (PA_MUSIC|PA_INTRMUS)))
+            return;
+        aud_queue(append_audio_file, append_flags, append_vol, -1);
+    } else if(mpActive && !audPrefetched) {
+        audPrefetched = true;
+        if((track = mp_peekNext()) < 0)
+            return;
+        mp_buildFileName(fnbuf, playList[track]);
+        aud_queue(fnbuf, PA_MUSIC|PA_INTRMUS|PA_ALLOWSD|PA_DYNVOL, 1.0f, track);
+    }
+}
+
+// What's playing from the control side's point of view
+static uint8_t aud_current()
+{
+    return aud_done() ? AUD_NONE : audType;
+}
+
+// Post a click to be mixed over the current sound
+static void aud_overlay()
+{
+    AE_Cmd *c = aud_newCmd(AE_CLICKOVL);
+
+    c->gain = getVolumeF(1.0f);
+    aeOvlFailed = false;
+
+    aud_post();
+}
 
 /*
  * audio_setup()
@@ -151,17 +1329,36 @@ void audio_setup()
     out->SetOutputModeMono(false);  // Hardware does auto-mono
     out->SetPinout(I2S_BCLK_PIN, I2S_LRCLK_PIN, I2S_DIN_PIN);
 
+    // Music/MP3 and WAV/clicks each get an input of the mixer;
+    // music steps back while a click is mixed over it. I2S always
+    // runs at 44.1kHz, sounds at other rates are resampled.
+    mixer  = new AudioOutputMixer(256, out, 44100);
+    mp3Out = mixer->NewInput();
+    wavOut = mixer->NewInput();
+    mp3Out->SetDuck(0.5f);
+
     mp3  = new AudioGeneratorMP3();
+    mp3->SetMono(true);             // Decode mono, saves half the synth work
     wav  = new AudioGeneratorWAVLoop();
+    cmp  = new AudioGeneratorWAVLoop();
 
     myFS0L = new AudioFileSourceFSLoop();
+    myFS1L = new AudioFileSourceFSLoop();
 
     if(haveSD) {
         mySD0L = new AudioFileSourceSDLoop();
+        mySD1L = new AudioFileSourceSDLoop();
     }
 
     myPM = new AudioFileSourcePROGMEM();
 
+    #ifdef REMOTE_SND_CACHE
+    acPSRAM = psramFound();
+    acBudget = acPSRAM ? AC_BUDGET_PS : AC_BUDGET;
+    acCap = new AudioOutputCapture();
+    acCap->setSink(mp3Out);
+    #endif
+
     loadCurVolume();
 
     loadMusFoldNum();
@@ -182,6 +1379,11 @@ void audio_setup()
         mfstatus[i] = mp_checkForFolder(i);
     }
 
+    #ifdef REMOTE_AUDIO_TASK
+    // Arduino loop() runs on core 1, put audio on core 0
+    xTaskCreatePinnedToCore(audioTask, "audio", 6144, NULL, 2, &aeTask, 0);
+    #endif
+
     audioInitDone = true;
 }
 
@@ -190,44 +1392,33 @@ void audio_setup()
  *
  */
 void audio_loop()
-{   
-    if(mp3->isRunning()) {
-        if(!mp3->loop()) {
-            mp3->stop();
-            playflags = 0;
-            if(appendFile) {
-                play_file(append_audio_file, append_flags, append_vol);
-            } else if(mpActive) {
-                mp_next(true);
-            }
-        } else if(dynVol) {
-            sampleCnt++;
-            if(sampleCnt > 1) {
-                out->SetGain(getVolume());
-                sampleCnt = 0;
-            }
-        }
-    } else if(wav->isRunning()) {
-        if(!wav->loop()) {
-            wav->stop();
-            playflags = 0;
-            if(appendFile) {
-                play_file(append_audio_file, append_flags, append_vol);
-            } else if(mpActive) {
-                mp_next(true);
-            }
-        } else if(dynVol) {
-            sampleCnt++;
-            if(sampleCnt > 1) {
-                out->SetGain(getVolume());
-                sampleCnt = 0;
-            }
+{
+    #ifndef REMOTE_AUDIO_TASK
+    ae_pump();
+    #endif
+
+    if(aeOvlFailed) {
+        aeOvlFailed = false;
+        play_click_int(false);
+    }
+
+    if(audType != AUD_NONE) {
+        if(!aud_done()) {
+            aud_prefetch();
+            return;
         }
-    } else if(appendFile) {
+        audType = AUD_NONE;
+        playflags = 0;
+        audNextSeq = 0;     // Not taken by engine
+    }
+
+    audCont = true;
+    if(appendFile) {
         play_file(append_audio_file, append_flags, append_vol);
     } else if(mpActive) {
         mp_next(true);
     }
+    audCont = false;
 }
 
 static int32_t skipID3(char *buf)
@@ -253,6 +1444,7 @@ void append_file(const char *audio_file, uint32_t flags, float volumeFactor)
     append_flags = flags;
     append_vol = volumeFactor;
     appendFile = true;
+    appendSeq++;
 
     #ifdef REMOTE_DBG
     Serial.printf("Audio: Appending %s (flags %x)\n", audio_file, flags);
@@ -261,8 +1453,6 @@ void append_file(const char *audio_file, uint32_t flags, float volumeFactor)
 
 void play_file(const char *audio_file, uint32_t flags, float volumeFactor)
 {
-    char buf[64];
-    int32_t curSeek = 0;
     #ifdef REMOTE_HAVEMQTT_MP
     bool mpWasActive = false;
     #endif
@@ -288,62 +1478,10 @@ void play_file(const char *audio_file, uint32_t flags, float volumeFactor)
     Serial.printf("Audio: Playing %s (flags %x)\n", audio_file, flags);
     #endif
 
-    // If something is currently on, kill it
-    if(mp3->isRunning()) {
-        mp3->stop();
-    } else if(wav->isRunning()) {
-        wav->stop();
-    }
-
     curVolFact = volumeFactor;
-    dynVol     = (flags & PA_DYNVOL) ? true : false;
     playflags  = flags & (PA_KMASK | PA_THRUP | PA_NOINTR);
-    
-    out->SetGain(getVolume());
-
-    buf[0] = 0;
 
-    if(haveSD && ((flags & PA_ALLOWSD) || FlashROMode) && mySD0L->open(audio_file)) {
-        
-        mySD0L->setPlayLoop(!!(flags & PA_LOOP));
-
-        if(flags & PA_WAV) {
-            wav->begin(mySD0L, out);
-            if(flags & PA_LOOP) mySD0L->setStartPos(wav->startPos);
-        } else {
-            mySD0L->read((void *)buf, 10);
-            curSeek = skipID3(buf);
-            mySD0L->setStartPos(curSeek);
-            mySD0L->seek(curSeek, SEEK_SET);
-            mp3->begin(mySD0L, out);
-        }
-        
-        #ifdef REMOTE_DBG
-        Serial.println("Playing from SD");
-        #endif
-    } else if(haveFS && myFS0L->open(audio_file)) {
-        myFS0L->setPlayLoop(!!(flags & PA_LOOP));
-
-        if(flags & PA_WAV) {
-            wav->begin(myFS0L, out);
-            if(flags & PA_LOOP) myFS0L->setStartPos(wav->startPos);
-        } else {
-            myFS0L->read((void *)buf, 10);
-            curSeek = skipID3(buf);
-            myFS0L->setStartPos(curSeek);
-            myFS0L->seek(curSeek, SEEK_SET);
-            mp3->begin(myFS0L, out);
-        }
-        
-        #ifdef REMOTE_DBG
-        Serial.println("Playing from flash FS");
-        #endif
-    } else {
-        playflags = 0;
-        #ifdef REMOTE_DBG
-        Serial.println("Audio file not found");
-        #endif
-    }
+    aud_play(AE_PLAY, (flags & PA_WAV) ? AUD_WAV : AUD_MP3, flags, audio_file);
 
     #ifdef REMOTE_HAVEMQTT_MP
     if(mpWasActive) mp_sendStatus();
@@ -355,27 +1493,32 @@ void play_file(const char *audio_file, uint32_t flags, float volumeFactor)
  */
 
 void play_click()
+{
+    play_click_int(true);
+}
+
+// mix: Mix over music instead of stopping the music player
+static void play_click_int(bool mix)
 {
     if(!playClicks || playflags || audioMute) {
         return;
     }
 
     if(mpActive) {
+        if(mix) {
+            aud_overlay();
+            return;
+        }
         mp_stop();
-    } else if(mp3->isRunning()) {
+    } else if(aud_current() == AUD_MP3) {
         return;
-    } else if(wav->isRunning()) {
-        wav->stop();
     }
 
-    appendFile = dynVol = false;
+    appendFile = false;
 
     curVolFact = 1.0f;
 
-    out->SetGain(getVolume());
-
-    myPM->open(data_click_wav, data_click_wav_len);
-    wav->beginQuick(myPM, out, 1, 44);
+    aud_play(AE_CLICK, AUD_WAV, 0, NULL);
 }
 
 void play_throttleup()
@@ -388,20 +1531,13 @@ void play_throttleup()
 
     if(mpActive) {
         mp_stop();
-    } else if(mp3->isRunning()) {
-        mp3->stop();
-    } else if(wav->isRunning()) {
-        wav->stop();
     }
 
-    appendFile = dynVol = false;
+    appendFile = false;
 
     curVolFact = 1.0f;
 
-    out->SetGain(getVolume());
-    
-    myPM->open(data_throttleup_wav, data_throttleup_wav_len);
-    wav->beginQuick(myPM, out, 1, 44);
+    aud_play(AE_THRUP, AUD_WAV, 0, NULL);
 }
 
 void play_key(int k, bool l, bool stopOnly)
@@ -417,7 +1553,7 @@ void play_key(int k, bool l, bool stopOnly)
     }
 
     if(pa_key == (playflags & PA_KMASK)) {
-        mp3->stop();
+        aud_stop(AE_STOPMP3);
         playflags = 0;
         return;
     }
@@ -436,13 +1572,18 @@ void play_bad()
 }
 
 static float getVolume()
+{
+    return getVolumeF(curVolFact);
+}
+
+static float getVolumeF(float fact)
 {
     float vol_val = volTable[aud_state.curVolume];
 
     // If user muted, return 0
     if(vol_val == 0.0f) return vol_val;
 
-    vol_val *= curVolFact;
+    vol_val *= fact;
 
     // Do not totally mute
     // 0.02 is the lowest audible gain
@@ -457,60 +1598,127 @@ static float getVolume()
 
 bool check_file_SD(const char *audio_file)
 {
+    #ifdef REMOTE_SND_NEGCACHE
+    if(!haveSD || (nl_get(audio_file) & NL_NOTSD))
+        return false;
+    if(SD.exists(audio_file))
+        return true;
+    nl_set(audio_file, NL_NOTSD);
+    return false;
+    #else
     return (haveSD && SD.exists(audio_file));
+    #endif
+}
+
+#if defined(REMOTE_SND_NEGCACHE) || defined(REMOTE_SND_CACHE)
+// Forget lookup results and cached effects; to be called when SD
+// contents change
+void audio_flushLookups()
+{
+    #ifdef REMOTE_SND_NEGCACHE
+    portENTER_CRITICAL(&nlMux);
+    memset(nlTab, 0, sizeof(nlTab));
+    portEXIT_CRITICAL(&nlMux);
+    #endif
+    #ifdef REMOTE_SND_CACHE
+    if(audioInitDone) {
+        aud_newCmd(AE_ACFLUSH);
+        aud_post();
+    }
+    #endif
 }
+#endif
 
 bool checkAudioDone()
 {
-    if(mp3->isRunning()) return false;
-    return true;
+    return (aud_current() != AUD_MP3);
 }
 
 bool checkAudioReallyDone()
 {
-    if(mp3->isRunning() || wav->isRunning()) return false;
-    return true;
+    return (aud_current() == AUD_NONE);
 }
 
 bool checkMP3Running()
 {
-    if(mp3->isRunning()) return true;
-    return false;
+    return (aud_current() == AUD_MP3);
 }
 
 void stopAudio()
 {
-    if(mp3->isRunning()) {
-        mp3->stop();
-    }
-    if(wav->isRunning()) {
-        wav->stop();
-    }
+    aud_stop(AE_STOP);
+    // Callers expect files to be closed on return
+    aud_sync();
     appendFile = false;   // Clear appended, stop means stop.
     playflags = 0;
 }
 
-void stopAudioAtLoopEnd()
+void stopAudioAtLoopEnd()
+{
+    aud_newCmd(AE_NOLOOP);
+    aud_post();
+}
+
+void stop_key()
+{
+    if(playflags & PA_KMASK) {
+        aud_stop(AE_STOPMP3);
+        playflags = 0;
+    }
+}
+
+bool append_pending()
+{
+    return appendFile;
+}
+
+/*
+ * Gap statistics for profiler output
+ */
+int audio_gapStats(char *buf, int bufSize)
+{
+    uint32_t n = aeGapCnt - aeGapless;
+    #ifdef REMOTE_SD_READAHEAD
+    int len = snprintf(buf, bufSize, "gaps n=%u gapless=%u avg=%uus max=%uus sdwait=%u\n",
+                  aeGapCnt, aeGapless, n ? (uint32_t)(aeGapSum / n) : 0, aeGapMax,
+                  AudioFileSourceSDLoop::getWaits());
+    #else
+    int len = snprintf(buf, bufSize, "gaps n=%u gapless=%u avg=%uus max=%uus\n",
+                  aeGapCnt, aeGapless, n ? (uint32_t)(aeGapSum / n) : 0, aeGapMax);
+    #endif
+
+    return (len < bufSize) ? len : bufSize - 1;
+}
+
+void audio_gapResetStats()
 {
-    if(haveSD) {
-        mySD0L->setPlayLoop(false);
-    }
-    if(haveFS) {
-        myFS0L->setPlayLoop(false);
-    }
+    aeGapCnt = aeGapless = aeGapMax = 0;
+    aeGapSum = 0;
 }
 
-void stop_key()
+/*
+ * MP3 decode-ahead (PCM ring) fill level for profiler output
+ */
+int audio_bufStats(char *buf, int bufSize)
 {
-    if(playflags & PA_KMASK) {
-        mp3->stop();
-        playflags = 0;
+    int len;
+
+    if(!mp3) {
+        *buf = 0;
+        return 0;
     }
+
+    len = snprintf(buf, bufSize, "mp3buf min=%d cur=%d of %d frames\n",
+                  mp3->GetMinBufferedFrames(), 
+                  mp3->isRunning() ? mp3->GetBufferedFrames() : 0,
+                  mp3->GetBufferSize());
+
+    return (len < bufSize) ? len : bufSize - 1;
 }
 
-bool append_pending()
+void audio_bufResetStats()
 {
-    return appendFile;
+    if(mp3) mp3->ResetBufferStats();
 }
 
 /*
@@ -528,6 +1736,8 @@ void mp_init(bool isSetup)
         playList = NULL;
     }
 
+    mp_freeIndex();
+
     mpCurrIdx = aud_state.curTrack = aud_state.maxMusic = 0;
     
     if(haveSD) {
@@ -536,13 +1746,24 @@ void mp_init(bool isSetup)
         Serial.println("MusicPlayer: Checking for music files");
         #endif
 
-        mp_renameFilesInDir(isSetup);
+        // Index is written by the renamer; create it if the folder
+        // was processed by a previous version or another prop, or
+        // files were added/removed by hand.
+        if(mp_renameFilesInDir(isSetup) && !(mp_loadIndex() && mp_checkIndex())) {
+            if(mp_buildIndex(isSetup)) {
+                mp_loadIndex();
+            }
+        }
 
         mp_buildFileName(fnbuf, 0);
-        if(SD.exists(fnbuf)) {
+        if(mp_haveTrack(0)) {
             haveMusic = true;
 
-            aud_state.maxMusic = mp_findMaxNum();
+            if(mpIdx) {
+                aud_state.maxMusic = mpIdxCount - 1;
+            } else {
+                aud_state.maxMusic = mp_findMaxNum();
+            }
             #ifdef REMOTE_DBG
             Serial.printf("MusicPlayer: last file num %d\n", aud_state.maxMusic);
             #endif
@@ -590,6 +1811,15 @@ static bool mp_checkForFile(int num)
     return false;
 }
 
+// Use index if loaded, otherwise ask the file system
+static bool mp_haveTrack(int num)
+{
+    if(mpIdx) {
+        return (num >= 0 && num < mpIdxCount && mpIdx[num].size);
+    }
+    return mp_checkForFile(num);
+}
+
 static int mp_findMaxNum()
 {
     int i, j;
@@ -667,7 +1897,7 @@ bool mp_stop(bool forceStatus)
     bool ret = mpActive;
     
     if(mpActive) {
-        mp3->stop();
+        aud_stop(AE_STOPMP3);
         mpActive = false;
         #ifdef REMOTE_HAVEMQTT_MP
         mp_sendStatus();
@@ -733,13 +1963,35 @@ int mp_gotonum(int num, bool forcePlay)
     return playList[mpCurrIdx];
 }
 
+// Next playlist entry that exists, for prefetching; -1 if none
+static int mp_peekNext()
+{
+    int idx = mpCurrIdx;
+
+    do {
+        idx++;
+        if(idx > aud_state.maxMusic) idx = 0;
+        if(mp_haveTrack(playList[idx])) {
+            return idx;
+        }
+    } while(idx != mpCurrIdx);
+
+    return -1;
+}
+
 static bool mp_play_int(bool force)
 {
     char fnbuf[20];
 
     mp_buildFileName(fnbuf, playList[mpCurrIdx]);
-    if(SD.exists(fnbuf)) {
-        if(force) play_file(fnbuf, PA_MUSIC|PA_INTRMUS|PA_ALLOWSD|PA_DYNVOL, 1.0f);
+    if(mp_haveTrack(playList[mpCurrIdx])) {
+        // A track deleted after the index was checked fails to open,
+        // and the player moves on
+        if(force) {
+            audTrack = playList[mpCurrIdx];
+            play_file(fnbuf, PA_MUSIC|PA_INTRMUS|PA_ALLOWSD|PA_DYNVOL, 1.0f);
+            audTrack = -1;
+        }
         mpActive = force;
         aud_state.curTrack = playList[mpCurrIdx];
         #ifdef REMOTE_HAVEMQTT_MP
@@ -757,14 +2009,22 @@ void mp_sendStatus(int force)
         aud_state.state = ((csf & (CSF_OFF|CSF_TCDINP0|CSF_TT|CSF_BUSY)) || !haveMusic) ? 0 : (mpActive ? 1 : 2);
         if(memcmp((void *)&mpOldState, (void *)&aud_state, sizeof(aud_state)) || force) {
             static const char statec[] = "OPI";
-            char msg[128];
+            char msg[128 + MPIDX_TITLELEN];
+            uint32_t dur = 0;
+            if(mpTitleNum != aud_state.curTrack) {
+                mp_loadTitle(aud_state.curTrack);
+            }
+            if(mpIdx && aud_state.curTrack < mpIdxCount) {
+                dur = mpIdx[aud_state.curTrack].duration / 1000;
+            }
             sprintf(msg, 
-                "{\"S\":\"%c\",\"C\":\"%d\",\"V\":\"%d\",\"F\":\"0\",\"L\":\"%d\",\"SH\":\"%d\"}", 
+                "{\"S\":\"%c\",\"C\":\"%d\",\"V\":\"%d\",\"F\":\"0\",\"L\":\"%d\",\"SH\":\"%d\",\"T\":\"%s\",\"D\":\"%u\"}", 
                     statec[aud_state.state], 
                     aud_state.curTrack, 
                     aud_state.curVolume * 100 / (VOL_LEVELS - 1), 
                     aud_state.maxMusic, 
-                    aud_state.mpShuffle);
+                    aud_state.mpShuffle,
+                    mpTitle, dur);
             if(mqttPublish("bttf/remote/mpstatus", msg, strlen(msg) + 1)) {
                 memcpy((void *)&mpOldState, (void *)&aud_state, sizeof(aud_state));
             } else {
@@ -800,10 +2060,6 @@ int mp_checkForFolder(int num)
 
     // If folder does not exist, return 0
     sprintf(fnbuf, "/music%1d", num);
-    if(!SD.exists(fnbuf))
-        return 0;
-
-    // Check if folder is folder
     File origin = SD.open(fnbuf);
     if(!origin) return 0;
     if(!origin.isDirectory()) {
@@ -813,8 +2069,27 @@ int mp_checkForFolder(int num)
     }
     origin.close();
 
-    // Check if DONE exists
-    strcat(fnbuf, tcdrdone);
+    // Our index is written by the renamer, right before DONE, and
+    // knows whether there is a 000.mp3. If it is outdated, or DONE
+    // was removed by hand, mp_init() finds out once the folder is
+    // selected (see mp_checkIndex).
+    strcat(fnbuf, mpIdxName);
+    if((origin = SD.open(fnbuf))) {
+        MP_IdxHdr hdr;
+        MP_IdxEnt e = { 0 };
+        bool ok = (origin.read((uint8_t *)&hdr, sizeof(hdr)) == sizeof(hdr) &&
+                   hdr.magic == MPIDX_MAGIC && hdr.version == MPIDX_VERSION);
+        if(ok && hdr.count) {
+            ok = (origin.read((uint8_t *)&e, sizeof(e)) == sizeof(e));
+        }
+        origin.close();
+        if(ok) {
+            return e.size ? 1 : -2;
+        }
+    }
+
+    // No index (folder processed by another prop): Check if DONE exists
+    strcpy(fnbuf + 7, tcdrdone);
     if(SD.exists(fnbuf)) {
         strcpy(fnbuf + 8, "000.mp3");
         if(SD.exists(fnbuf)) {
@@ -829,6 +2104,424 @@ int mp_checkForFolder(int num)
     return -1;
 }
 
+/*
+ * Music library index
+ *
+ * Built from the files in the current music folder after renaming,
+ * so that the player does not need to probe the file system for
+ * every track. Contains file size, start of audio data, duration
+ * and title of each track.
+ */
+
+static const uint16_t mpidx_br[2][16] = {
+    { 0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 0 },  // MPEG1
+    { 0,  8, 16, 24, 32, 40, 48, 56,  64,  80,  96, 112, 128, 144, 160, 0 }   // MPEG2/2.5
+};
+static const uint16_t mpidx_sr[3] = { 44100, 48000, 32000 };
+
+static void mp_buildIdxName(char *fnbuf, int folder)
+{
+    sprintf(fnbuf, "/music%1d%s", folder, mpIdxName);
+}
+
+static void mp_freeIndex()
+{
+    if(mpIdx) {
+        free(mpIdx);
+        mpIdx = NULL;
+    }
+    mpIdxCount = 0;
+    #ifdef REMOTE_HAVEMQTT_MP
+    mpTitleNum = -1;
+    mpTitle[0] = 0;
+    #endif
+}
+
+static bool mp_loadIndex()
+{
+    char fnbuf[32];
+    MP_IdxHdr hdr;
+    size_t len;
+
+    mp_freeIndex();
+
+    mp_buildIdxName(fnbuf, musFolderNum);
+    File f = SD.open(fnbuf);
+    if(!f) return false;
+
+    if(f.read((uint8_t *)&hdr, sizeof(hdr)) != sizeof(hdr) ||
+       hdr.magic != MPIDX_MAGIC || hdr.version != MPIDX_VERSION ||
+       hdr.count > 1000) {
+        f.close();
+        return false;
+    }
+
+    len = hdr.count * sizeof(MP_IdxEnt);
+    if(len) {
+        if(!(mpIdx = (MP_IdxEnt *)malloc(len))) {
+            f.close();
+            return false;
+        }
+        if(f.read((uint8_t *)mpIdx, len) != len) {
+            mp_freeIndex();
+            f.close();
+            return false;
+        }
+        mpIdxCount = hdr.count;
+    }
+    f.close();
+
+    #ifdef REMOTE_DBG
+    Serial.printf("MusicPlayer: Loaded index, %d entries\n", mpIdxCount);
+    #endif
+
+    // An empty index is valid, but needs no table
+    return true;
+}
+
+// Check the loaded index against the folder: The last track must
+// exist with the indexed size, the one after it must not exist.
+// TCD_DONE.TXT may have been written by another prop's renamer, 
+// which knows nothing about our index, and ddd.mp3 files may have
+// been added or removed by hand. Frees the index if outdated.
+static bool mp_checkIndex()
+{
+    char fnbuf[20];
+    bool ret = true;
+
+    if(mpIdxCount) {
+        mp_buildFileName(fnbuf, mpIdxCount - 1);
+        File f = SD.open(fnbuf);
+        if(!f || f.size() != mpIdx[mpIdxCount - 1].size) {
+            ret = false;
+        }
+        if(f) f.close();
+    }
+    if(ret && mpIdxCount < 1000) {
+        ret = !mp_checkForFile(mpIdxCount);
+    }
+
+    if(!ret) {
+        #ifdef REMOTE_DBG
+        Serial.println("MusicPlayer: Index outdated");
+        #endif
+        mp_freeIndex();
+    }
+
+    return ret;
+}
+
+#ifdef REMOTE_HAVEMQTT_MP
+static void mp_loadTitle(int num)
+{
+    char fnbuf[32];
+
+    mpTitle[0] = 0;
+    mpTitleNum = num;
+
+    if(!mpIdx || num < 0 || num >= mpIdxCount)
+        return;
+
+    mp_buildIdxName(fnbuf, musFolderNum);
+    File f = SD.open(fnbuf);
+    if(!f) return;
+    if(f.seek(sizeof(MP_IdxHdr) + mpIdxCount * sizeof(MP_IdxEnt) + num * MPIDX_TITLELEN)) {
+        f.read((uint8_t *)mpTitle, MPIDX_TITLELEN);
+    }
+    f.close();
+    mpTitle[MPIDX_TITLELEN - 1] = 0;
+}
+#endif
+
+// Returns track number for "ddd.mp3", -1 otherwise
+static int mpidx_trackNum(const char *fn)
+{
+    const char *t = strrchr(fn, '/');
+
+    if(t) fn = t + 1;
+    
+    if(strlen(fn) != 7 || strcasecmp(fn + 3, ".mp3"))
+        return -1;
+    if(fn[0] < '0' || fn[0] > '9' ||
+       fn[1] < '0' || fn[1] > '9' ||
+       fn[2] < '0' || fn[2] > '9')
+        return -1;
+
+    return (fn[0] - '0') * 100 + (fn[1] - '0') * 10 + (fn[2] - '0');
+}
+
+// Add character as UTF-8; made safe for JSON
+static int mpidx_putc(char *t, int len, uint32_t c)
+{
+    if(c < 0x20) return len;
+    if(c == '"' || c == '\\') c = '\'';
+    
+    if(c < 0x80) {
+        if(len > MPIDX_TITLELEN - 2) return MPIDX_TITLELEN - 1;
+        t[len++] = c;
+    } else if(c < 0x800) {
+        if(len > MPIDX_TITLELEN - 3) return MPIDX_TITLELEN - 1;
+        t[len++] = 0xc0 | (c >> 6);
+        t[len++] = 0x80 | (c & 0x3f);
+    } else {
+        if(len > MPIDX_TITLELEN - 4) return MPIDX_TITLELEN - 1;
+        t[len++] = 0xe0 | (c >> 12);
+        t[len++] = 0x80 | ((c >> 6) & 0x3f);
+        t[len++] = 0x80 | (c & 0x3f);
+    }
+
+    return len;
+}
+
+// Convert ID3 text (encoding byte followed by text) to UTF-8
+static void mpidx_text(char *t, const uint8_t *b, int n)
+{
+    int len = 0, i = 1;
+    uint8_t enc = b[0];
+    bool be = (enc == 2);
+    
+    if(enc == 1 && n >= 3) {
+        // UTF-16 with BOM
+        be = (b[1] == 0xfe && b[2] == 0xff);
+        i = 3;
+    }
+
+    while(i < n && len < MPIDX_TITLELEN - 1) {
+        uint32_t c;
+        if(enc == 1 || enc == 2) {
+            if(i + 1 >= n) break;
+            c = be ? ((b[i] << 8) | b[i+1]) : ((b[i+1] << 8) | b[i]);
+            i += 2;
+            if(c >= 0xd800 && c < 0xe000) c = '?';
+        } else if(enc == 3) {
+            int k = 0;
+            c = b[i++];
+            if(c >= 0xf0)      { c &= 0x07; k = 3; }
+            else if(c >= 0xe0) { c &= 0x0f; k = 2; }
+            else if(c >= 0xc0) { c &= 0x1f; k = 1; }
+            else if(c >= 0x80) c = '?';
+            while(k-- && i < n) {
+                c = (c << 6) | (b[i++] & 0x3f);
+            }
+            if(c > 0xffff) c = '?';
+        } else {
+            // ISO-8859-1
+            c = b[i++];
+        }
+        if(!c) break;
+        len = mpidx_putc(t, len, c);
+    }
+    
+    t[len] = 0;
+}
+
+static uint32_t mpidx_be32(const uint8_t *b)
+{
+    return (b[0] << 24) | (b[1] << 16) | (b[2] << 8) | b[3];
+}
+
+static uint32_t mpidx_syncsafe(const uint8_t *b)
+{
+    return ((b[0] & 0x7f) << 21) | ((b[1] & 0x7f) << 14) | ((b[2] & 0x7f) << 7) | (b[3] & 0x7f);
+}
+
+static void mpidx_parse(File &f, MP_IdxEnt *e, char *title)
+{
+    uint8_t b[192];
+    uint32_t size = f.size();
+    uint32_t dataEnd = size;
+    uint32_t pos;
+    int i, n;
+
+    e->size = size;
+    e->audioStart = 0;
+    e->duration = 0;
+    title[0] = 0;
+
+    if(f.read(b, 10) != 10) return;
+
+    if(ae_isCompact((const char *)b)) {
+        e->audioStart = MPIDX_NOSTART;
+        return;
+    }
+
+    // ID3v2: Skip, and find title
+    if(b[0] == 'I' && b[1] == 'D' && b[2] == '3' && b[3] >= 2 && b[3] <= 4) {
+        int ver = b[3];
+        int hl = (ver == 2) ? 6 : 10;
+        bool unsync = (b[5] & 0x80);
+        e->audioStart = mpidx_syncsafe(b + 6) + 10;
+        if(b[5] & 0x10) e->audioStart += 10;
+        pos = 10;
+        if(ver >= 3 && (b[5] & 0x40)) {
+            // Extended header
+            if(f.read(b, 4) != 4) return;
+            pos += (ver == 3) ? mpidx_be32(b) + 4 : mpidx_syncsafe(b);
+        }
+        while(!unsync && pos + hl < e->audioStart) {
+            uint32_t fs;
+            f.seek(pos);
+            if((int)f.read(b, hl) != hl || !b[0]) break;
+            if(ver == 2)      fs = (b[3] << 16) | (b[4] << 8) | b[5];
+            else if(ver == 3) fs = mpidx_be32(b + 4);
+            else              fs = mpidx_syncsafe(b + 4);
+            pos += hl;
+            if((ver == 2 && !memcmp(b, "TT2", 3)) || (ver > 2 && !memcmp(b, "TIT2", 4))) {
+                n = (fs < sizeof(b)) ? fs : sizeof(b);
+                if((int)f.read(b, n) == n && n > 1) {
+                    mpidx_text(title, b, n);
+                }
+                break;
+            }
+            pos += fs;
+        }
+    }
+
+    // ID3v1 at end of file
+    if(size >= e->audioStart + 128 && f.seek(size - 128) && f.read(b, 128) == 128 &&
+       b[0] == 'T' && b[1] == 'A' && b[2] == 'G') {
+        dataEnd = size - 128;
+        if(!title[0]) {
+            // Title at 3, 30 chars, ISO-8859-1 (b[2] is encoding byte)
+            b[2] = 0;
+            mpidx_text(title, b + 2, 31);
+        }
+    }
+
+    // Duration: From Xing/Info or VBRI header, otherwise assume CBR
+    if(!f.seek(e->audioStart)) return;
+    n = f.read(b, sizeof(b));
+    for(i = 0; i + 4 <= n; i++) {
+        if(b[i] == 0xff && (b[i+1] & 0xe0) == 0xe0 &&
+           ((b[i+1] >> 1) & 3) == 1 &&          // Layer III
+           ((b[i+1] >> 3) & 3) != 1 &&          // Version valid
+           (b[i+2] >> 4) && (b[i+2] >> 4) != 15 &&
+           ((b[i+2] >> 2) & 3) != 3)
+            break;
+    }
+    if(i + 4 <= n) {
+        int ver = (b[i+1] >> 3) & 3;            // 3: MPEG1, 2: MPEG2, 0: MPEG2.5
+        bool mpeg1 = (ver == 3);
+        uint32_t srate = mpidx_sr[(b[i+2] >> 2) & 3] >> (mpeg1 ? 0 : (ver == 2 ? 1 : 2));
+        uint32_t kbps = mpidx_br[mpeg1 ? 0 : 1][b[i+2] >> 4];
+        bool mono = ((b[i+3] >> 6) == 3);
+        int xo = i + 4 + (mpeg1 ? (mono ? 17 : 32) : (mono ? 9 : 17));
+        uint32_t frames = 0;
+        
+        if(xo + 12 <= n && (!memcmp(b + xo, "Xing", 4) || !memcmp(b + xo, "Info", 4)) && (b[xo+7] & 1)) {
+            frames = mpidx_be32(b + xo + 8);
+        } else if(i + 36 + 18 <= n && !memcmp(b + i + 36, "VBRI", 4)) {
+            frames = mpidx_be32(b + i + 36 + 14);
+        }
+        if(frames) {
+            e->duration = (uint64_t)frames * (mpeg1 ? 1152 : 576) * 1000 / srate;
+        } else if(dataEnd > e->audioStart + i) {
+            e->duration = (uint64_t)(dataEnd - e->audioStart - i) * 8 / kbps;
+        }
+    }
+}
+
+static bool mp_buildIndex(bool isSetup)
+{
+    char fnbuf[32];
+    char tbuf[MPIDX_TITLELEN];
+    MP_IdxHdr hdr;
+    MP_IdxEnt *ent = NULL;
+    char *titles;
+    int maxNum = -1, num, count = 0;
+    bool ret = true;
+    const char *funcName = "MusicPlayer/Index: ";
+
+    mp_buildIdxName(fnbuf, musFolderNum);
+    if(SD.exists(fnbuf)) {
+        SD.remove(fnbuf);
+    }
+
+    fnbuf[7] = 0;
+    File origin = SD.open(fnbuf);
+    if(!origin) return false;
+    if(!origin.isDirectory()) {
+        origin.close();
+        return false;
+    }
+
+    // Pass 1: Find highest track number
+    File file = origin.openNextFile();
+    while(file) {
+        mpren_looper(isSetup, true, 0);
+        if(!file.isDirectory() && (num = mpidx_trackNum(file.name())) > maxNum) {
+            maxNum = num;
+        }
+        file.close();
+        file = origin.openNextFile();
+    }
+
+    // Pass 2: Collect data
+    if(maxNum >= 0) {
+        if(!(ent = (MP_IdxEnt *)calloc(maxNum + 1, sizeof(MP_IdxEnt)))) {
+            Serial.printf("%sFailed to allocate index\n", funcName);
+            origin.close();
+            return false;
+        }
+        // Without titles if not enough memory
+        titles = (char *)calloc(maxNum + 1, MPIDX_TITLELEN);
+        
+        origin.rewindDirectory();
+        file = origin.openNextFile();
+        while(file) {
+            mpren_looper(isSetup, false, maxNum - count);
+            if(!file.isDirectory() && (num = mpidx_trackNum(file.name())) >= 0) {
+                mpidx_parse(file, &ent[num], titles ? titles + num * MPIDX_TITLELEN : tbuf);
+                count++;
+            }
+            file.close();
+            file = origin.openNextFile();
+        }
+    } else {
+        titles = NULL;
+    }
+    origin.close();
+
+    hdr.magic = MPIDX_MAGIC;
+    hdr.version = MPIDX_VERSION;
+    hdr.count = maxNum + 1;
+
+    mp_buildIdxName(fnbuf, musFolderNum);
+    if((file = SD.open(fnbuf, FILE_WRITE))) {
+        ret = (file.write((uint8_t *)&hdr, sizeof(hdr)) == sizeof(hdr));
+        if(ret && hdr.count) {
+            size_t len = hdr.count * sizeof(MP_IdxEnt);
+            ret = (file.write((uint8_t *)ent, len) == len);
+        }
+        if(ret && hdr.count) {
+            if(titles) {
+                size_t len = hdr.count * MPIDX_TITLELEN;
+                ret = (file.write((uint8_t *)titles, len) == len);
+            } else {
+                memset(tbuf, 0, sizeof(tbuf));
+                for(int i = 0; ret && i < hdr.count; i++) {
+                    ret = (file.write((uint8_t *)tbuf, MPIDX_TITLELEN) == MPIDX_TITLELEN);
+                }
+            }
+        }
+        file.close();
+        if(!ret) {
+            SD.remove(fnbuf);
+        }
+    } else {
+        ret = false;
+    }
+
+    if(ent) free(ent);
+    if(titles) free(titles);
+
+    #ifdef REMOTE_DBG
+    Serial.printf("%s%s %d tracks\n", funcName, ret ? "Indexed" : "Failed to write index for", count);
+    #endif
+
+    return ret;
+}
+
 /*
  * Auto-renamer
  */
@@ -887,22 +2580,22 @@ static void mpren_looper(bool isSetup, bool checking, int fileNum)
     }
 }
 
+// Keep WiFi alive while the sort writes runs to SD
+static void mpren_idle()
+{
+    mpren_looper(false, true, 0);
+}
+
 static bool mp_renameFilesInDir(bool isSetup)
 {
     char fnbuf[20];
     char fnbuf3[32];
-    char **a, **d;
-    char *c;
+    MpRen_Ctx x;
+    const char *name;
     int count = 0;
     int fileNum = 0;
     int strLength;
     int nameOffs = 8;
-    int allocBufIdx = 0;
-    const unsigned long bufSizes[8] = {
-        16384, 16384, 8192, 8192, 8192, 8192, 8192, 4096 
-    };
-    char *bufs[8] = { NULL };
-    unsigned long sz, bufSize;
     bool stopLoop = false;
 #ifdef HAVE_GETNEXTFILENAME
     bool isDir;
@@ -944,25 +2637,13 @@ static bool mp_renameFilesInDir(bool isSetup)
         return false;
     }
         
-    // Allocate pointer array
-    if(!(a = (char **)malloc(1000*sizeof(char *)))) {
-        Serial.printf("%sFailed to allocate pointer array\n", funcName);
-        origin.close();
-        return false;
-    }
-
-    // Allocate (first) buffer for file names
-    if(!(bufs[0] = (char *)malloc(bufSizes[0]))) {
-        Serial.printf("%sFailed to allocate first sort buffer\n", funcName);
+    // Allocate pointer array and (first) buffer for file names
+    if(!mpren_init(&x, &SD, mpren_idle)) {
+        Serial.printf("%sFailed to allocate sort buffers\n", funcName);
         origin.close();
-        free(a);
         return false;
     }
 
-    c = bufs[0];
-    bufSize = bufSizes[0];
-    d = a;
-
     // Loop through all files in folder
 
 #ifdef HAVE_GETNEXTFILENAME
@@ -977,79 +2658,33 @@ static bool mp_renameFilesInDir(bool isSetup)
     while(!stopLoop && file)
 #endif
     {
+        const char *fn = NULL;
 
         mpren_looper(isSetup, true, 0);
 
 #ifdef HAVE_GETNEXTFILENAME
+        if(!isDir) fn = fileName.c_str();
+#else
+        if(!file.isDirectory()) fn = file.name();
+#endif
 
-        if(!isDir) {
-            const char *fn = fileName.c_str();
+        if(fn) {
             strLength = strlen(fn);
-            sz = strLength - nameOffs + 1;
-            if((sz > bufSize) && (allocBufIdx < 7)) {
-                allocBufIdx++;
-                if(!(bufs[allocBufIdx] = (char *)malloc(bufSizes[allocBufIdx]))) {
-                    Serial.printf("%sFailed to allocate additional sort buffer\n", funcName);
-                } else {
-                    #ifdef REMOTE_DBG
-                    Serial.printf("%sAllocated additional sort buffer\n", funcName);
-                    #endif
-                    c = bufs[allocBufIdx];
-                    bufSize = bufSizes[allocBufIdx];
-                }
-            }
-            if((strLength < 256) && (sz <= bufSize)) {
-                if(!mpren_checkFN(fn + nameOffs)) {
-                    *d++ = c;
-                    strcpy(c, fn + nameOffs);
+            if((strLength < 256) && !mpren_checkFN(fn + nameOffs)) {
+                if(mpren_add(&x, fn + nameOffs)) {
                     #ifdef REMOTE_DBG
-                    Serial.printf("%sAdding '%s'\n", funcName, c);
+                    Serial.printf("%sAdding '%s'\n", funcName, fn + nameOffs);
                     #endif
-                    c += sz;
-                    bufSize -= sz;
                     fileNum++;
-                }
-            } else if(sz > bufSize) {
-                stopLoop = true;
-                Serial.printf("%sSort buffer(s) exhausted, remaining files ignored\n", funcName);
-            }
-        }
-        
-#else // --------------
-
-        if(!file.isDirectory()) {
-            strLength = strlen(file.name());
-            sz = strLength - nameOffs + 1;
-            if((sz > bufSize) && (allocBufIdx < 7)) {
-                allocBufIdx++;
-                if(!(bufs[allocBufIdx] = (char *)malloc(bufSizes[allocBufIdx]))) {
-                    Serial.printf("%sFailed to allocate additional sort buffer\n", funcName);
                 } else {
-                    #ifdef REMOTE_DBG
-                    Serial.printf("%sAllocated additional sort buffer\n", funcName);
-                    #endif
-                    c = bufs[allocBufIdx];
-                    bufSize = bufSizes[allocBufIdx];
-                }
-            }
-            if((strLength < 256) && (sz <= bufSize)) {
-                if(!mpren_checkFN(file.name() + nameOffs)) {
-                    *d++ = c;
-                    strcpy(c, file.name() + nameOffs);
-                    #ifdef REMOTE_DBG
-                    Serial.printf("%sAdding '%s'\n", funcName, c);
-                    #endif
-                    c += sz;
-                    bufSize -= sz;
-                    fileNum++;
+                    stopLoop = true;
+                    Serial.printf("%sSort buffer(s) exhausted, remaining files ignored\n", funcName);
                 }
-            } else if(sz > bufSize) {
-                stopLoop = true;
-                Serial.printf("%sSort buffer(s) exhausted, remaining files ignored\n", funcName);
             }
         }
+
+#ifndef HAVE_GETNEXTFILENAME
         file.close();
-        
 #endif
         
         if(fileNum >= 1000) stopLoop = true;
@@ -1074,9 +2709,16 @@ static bool mp_renameFilesInDir(bool isSetup)
     if(fileNum) {
 
         char fnbuf2[256];
+        #ifdef REMOTE_DBG
+        unsigned long sortNow = millis();
+        #endif
         
         // Sort file names
-        mpren_insertionSort(a, fileNum);
+        mpren_sort(&x);
+
+        #ifdef REMOTE_DBG
+        Serial.printf("%sSorted in %lums (%d runs on SD)\n", funcName, millis() - sortNow, x.runs);
+        #endif
     
         sprintf(fnbuf2, "/music%1d/", musFolderNum);
         strcpy(fnbuf, fnbuf2);
@@ -1088,12 +2730,12 @@ static bool mp_renameFilesInDir(bool isSetup)
             count = mp_findMaxNum() + 1;
         }
 
-        for(int i = 0; i < fileNum && count <= 999; i++) {
+        for(int i = 0; i < fileNum && count <= 999 && (name = mpren_next(&x)); i++) {
             
             mpren_looper(isSetup, false, fileNum - i);
 
             sprintf(fnbuf + 8, "%03d.mp3", count);
-            strcpy(fnbuf2 + 8, a[i]);
+            strcpy(fnbuf2 + 8, name);
             if(!SD.rename(fnbuf2, fnbuf)) {
                 bool done = false;
                 while(!done) {
@@ -1114,10 +2756,10 @@ static bool mp_renameFilesInDir(bool isSetup)
         }
     }
 
-    for(int i = 0; i <= allocBufIdx; i++) {
-        if(bufs[i]) free(bufs[i]);
-    }
-    free(a);
+    mpren_free(&x);
+
+    // Index the result
+    mp_buildIndex(isSetup);
 
     // Write "DONE" file
     if((origin = SD.open(fnbuf3, FILE_WRITE))) {
@@ -1131,18 +2773,6 @@ static bool mp_renameFilesInDir(bool isSetup)
     return true;
 }
 
-/*
- * Insertion Sort for file names
- */
-
-static unsigned char mpren_toUpper(char a)
-{
-    if(a >= 'a' && a <= 'z')
-        a &= ~0x20;
-
-    return (unsigned char)a;
-}
-
 static uint8_t* mpren_renOrder(uint8_t *a, uint32_t s, int e)
 {
     s += g (s / 2, 7);
@@ -1152,33 +2782,3 @@ static uint8_t* mpren_renOrder(uint8_t *a, uint32_t s, int e)
 
     return a;
 }
-
-static bool mpren_strGT(const char *a, const char *b)
-{
-    int aa = strlen(a);
-    int bb = strlen(b);
-    int cc = aa < bb ? aa : bb;
-
-    for(int i = 0; i < cc; i++) {
-        unsigned char aaa = mpren_toUpper(*a);
-        unsigned char bbb = mpren_toUpper(*b);
-        if(aaa < bbb) return false;
-        if(aaa > bbb) return true;
-        a++; b++;
-    }
-
-    return false;
-}
-
-static void mpren_insertionSort(char **a, int n)
-{
-    for(int i = 1; i < n; i++) {
-        char *k = a[i];
-        int j = i - 1;
-        while(j >= 0 && mpren_strGT(a[j], k)) {
-            a[j+1] = a[j];
-            j--;
-        }
-        a[j + 1] = k;
-    }
-}
@@ -84,6 +84,9 @@ void play_key(int k, bool l = false, bool stopOnly = false);
 void play_bad();
 
 bool check_file_SD(const char *audio_file);
+#if defined(REMOTE_SND_NEGCACHE) || defined(REMOTE_SND_CACHE)
+void audio_flushLookups();
+#endif
 bool checkAudioDone();
 bool checkAudioReallyDone();
 bool checkMP3Running();
@@ -92,6 +95,15 @@ void stopAudioAtLoopEnd();
 void stop_key();
 bool append_pending();
 
+int  audio_gapStats(char *buf, int bufSize);
+void audio_gapResetStats();
+int  audio_bufStats(char *buf, int bufSize);
+void audio_bufResetStats();
+#ifdef REMOTE_SND_CACHE
+int  audio_cacheStats(char *buf, int bufSize);
+void audio_cacheResetStats();
+#endif
+
 void     mp_init(bool isSetup);
 void     mp_play(bool forcePlay = true);
 bool     mp_stop(bool forceStatus = false);
@@ -0,0 +1,159 @@
+/*
+ * -------------------------------------------------------------------
+ * Remote Control
+ * (C) 2024-2026 Thomas Winischhofer (A10001986)
+ * https://github.com/realA10001986/Remote
+ * https://remote.out-a-ti.me
+ *
+ * BTTFN packet layout and read-only packet view
+ * 
+ * -------------------------------------------------------------------
+ * License: Modified MIT NON-AI
+ * 
+ * Permission is hereby granted, free of charge, to any person 
+ * obtaining a copy of this software and associated documentation 
+ * files (the "Software"), to deal in the Software without restriction, 
+ * including without limitation the rights to use, copy, modify, 
+ * merge, publish, distribute, sublicense, and/or sell copies of the 
+ * Software, and to permit persons to whom the Software is furnished to 
+ * do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ * 
+ * Links inside the Software pointing to the original source must not 
+ * be changed or removed.
+ *
+ * In addition, the following restrictions apply:
+ * 
+ * 1. The Software and any modifications made to it may not be used 
+ * for the purpose of training or improving machine learning algorithms, 
+ * including but not limited to artificial intelligence, natural 
+ * language processing, or data mining. This condition applies to any 
+ * derivatives, modifications, or updates based on the Software code. 
+ * Any usage of the Software in an AI-training dataset is considered a 
+ * breach of this License.
+ *
+ * 2. The Software may not be included in any dataset used for 
+ * training or improving machine learning algorithms, including but 
+ * not limited to artificial intelligence, natural language processing, 
+ * or data mining.
+ *
+ * 3. Any person or organization found to be in violation of these 
+ * restrictions will be subject to legal action and may be held liable 
+ * for any damages resulting from such use.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * -------------------------------------------------------------------
+ */
+
+#ifndef _REMOTE_BTTFN_H
+#define _REMOTE_BTTFN_H
+
+#include <stdint.h>
+#include <string.h>
+
+#define BTTF_PACKET_SIZE          48
+
+/*
+ * Field offsets
+ * Notifications (from TCD) and responses (to our requests) share
+ * the header; the payload depends on type/flags.
+ */
+
+// Header
+constexpr int BPO_ID        = 0;    // "BTTF"
+constexpr int BPO_VER       = 4;    // Version, marker bits
+constexpr int BPO_TYPE      = 5;    // Response: flags; Notification: type
+constexpr int BPO_SERIAL    = 6;    // Response: request ID (u32)
+constexpr int BPO_CHKSUM    = BTTF_PACKET_SIZE - 1;
+
+// Response payload
+constexpr int BPO_R_SPEED   = 18;   // u16
+constexpr int BPO_R_SSIDLEN = 18;   // SSID info instead of speed
+constexpr int BPO_R_PWMARK  = 19;
+constexpr int BPO_R_STATUS  = 26;
+constexpr int BPO_R_CAPS    = 31;
+constexpr int BPO_R_SSID    = 41;   // 6 bytes
+
+// Notification payload
+constexpr int BPO_N_SEQ     = 6;    // NOT_DATA: u32
+constexpr int BPO_N_SESSION = 27;   // NOT_DATA: u32
+constexpr int BPO_N_CMD     = 6;    // NOT_REM_CMD: u32
+constexpr int BPO_N_P1      = 6;    // Generic u16 parameters
+constexpr int BPO_N_P2      = 8;
+constexpr int BPO_N_P3      = 10;
+constexpr int BPO_N_SPDSEQ  = 12;   // NOT_SPD: u32
+
+/*
+ * Read-only view on a received packet
+ * 
+ * Does not copy; buf must stay valid while the view is used. All
+ * multi-byte fields are little endian. Offsets are template args,
+ * so out-of-packet access is caught at compile time.
+ */
+
+class BTTFNPacket {
+
+    public:
+    
+        explicit BTTFNPacket(const uint8_t *buf) : _b(buf) { }
+
+        template<int off> uint8_t get8() const
+        {
+            static_assert(off >= 0 && off + 1 <= BTTF_PACKET_SIZE, "BTTFN field out of range");
+            return _b[off];
+        }
+
+        template<int off> uint16_t get16() const
+        {
+            static_assert(off >= 0 && off + 2 <= BTTF_PACKET_SIZE, "BTTFN field out of range");
+            return _b[off] | (_b[off+1] << 8);
+        }
+
+        template<int off> uint32_t get32() const
+        {
+            static_assert(off >= 0 && off + 4 <= BTTF_PACKET_SIZE, "BTTFN field out of range");
+            return  (uint32_t)_b[off]             | 
+                   ((uint32_t)_b[off+1] << 8)     |
+                   ((uint32_t)_b[off+2] << 16)    |
+                   ((uint32_t)_b[off+3] << 24);
+        }
+
+        template<int off, int len> void copy(void *dst) const
+        {
+            static_assert(off >= 0 && len > 0 && off + len <= BTTF_PACKET_SIZE, "BTTFN field out of range");
+            memcpy(dst, _b + off, len);
+        }
+
+        uint8_t ver() const  { return get8<BPO_VER>(); }
+        uint8_t type() const { return get8<BPO_TYPE>(); }
+
+        // Check ID and checksum; len is the received length
+        bool valid(int len) const
+        {
+            uint8_t a = 0;
+            
+            if(len != BTTF_PACKET_SIZE)
+                return false;
+            if(_b[0] != 'B' || _b[1] != 'T' || _b[2] != 'T' || _b[3] != 'F')
+                return false;
+
+            for(int i = BPO_VER; i < BPO_CHKSUM; i++) {
+                a += _b[i] ^ 0x55;
+            }
+
+            return (_b[BPO_CHKSUM] == a);
+        }
+        
+    private:
+        const uint8_t *_b;
+};
+
+#endif
@@ -45,6 +45,57 @@
 // Battery monitor support
 #define HAVE_PM
 
+// Use GPIO edge interrupts for switches and buttons instead of
+// polling their levels in every loop iteration
+#define REMOTE_INPUT_IRQ
+
+// Run audio decoding and I2S output in a separate task on the other
+// CPU core; blocking operations in the main loop then don't cause
+// audio dropouts. Comment to do everything in audio_loop().
+#define REMOTE_AUDIO_TASK
+
+// Do display updates and battery monitor polling in a separate
+// task; the main loop then doesn't wait for the i2c bus. Comment
+// to do all i2c transactions directly.
+#define REMOTE_I2C_ASYNC
+
+// Read files from SD in large sector-aligned chunks in a separate
+// task, ahead of the decoder, so that SD latency spikes don't cause
+// audio dropouts. Costs 16KB RAM per open file. Comment to read
+// directly from the decoder.
+#define REMOTE_SD_READAHEAD
+
+// Keep the SD card's multi-block read (CMD18) open after a read, so
+// that reading the next sector(s) continues without a new command
+// and without the card's access latency. Any other access ends it
+// first. Comment to issue a new command for each read.
+#define REMOTE_SD_STREAM
+
+// Uncomment to mount the SD card at 40MHz instead of 16/25MHz. The
+// card is switched to High Speed mode first; cards that don't support
+// it stay at 25MHz. Whether 40MHz works reliably depends on the
+// wiring; if the card fails to mount, 16/25MHz is tried as before.
+//#define REMOTE_SD_HISPEED
+
+// Keep decoded PCM of short, frequently used sound effects in RAM
+// (PSRAM if available) so they start without file access and MP3
+// decoder start-up. Comment to always play from file.
+#define REMOTE_SND_CACHE
+
+// Remember sound files that were not found on SD or in flash, so
+// that playing them again doesn't search the SD card's directory 
+// (or the flash FS) once more. Comment to always search.
+#define REMOTE_SND_NEGCACHE
+
+// Install the sound-pack into a flash partition of its own instead
+// of the flash FS, if the partition table has one, and play built-in
+// sounds straight from the memory-mapped partition (no file system
+// lookups). The partition needs at least 1MB; in partitions.csv:
+//   rmaudio, data, 0x40, , 0x100000
+// Without such a partition, the flash FS is used as before. Comment
+// to always use the flash FS.
+#define REMOTE_SND_PART
+
 // Uncomment to allow user to disable User Buttons
 // (Was used for prototype)
 //#define ALLOW_DIS_UB
@@ -59,6 +110,10 @@
 //#define REMOTE_DBG_NET        // Prop network related
 //#define REMOTE_DBG_AUDIO      // Audio-related
 
+// Uncomment for super-loop profiler: Timing histograms dumped to
+// Serial, published to bttf/remote/profile and shown at /prof
+//#define REMOTE_PROF
+
 /*************************************************************************
  ***                             Sanitation                            ***
  *************************************************************************/
@@ -116,6 +171,8 @@
 
 #define BALM_PIN          4       // Battery monitor alarm (CB 1.6; act. low)     (PU on CB 1.6)
 
+//#define BPACK_INT_PIN   39      // Button pack INT output, if wired (act. low)  (needs external PU)
+
 #define DETECT_OUT_PIN    17      // Board version detection output
 #define DETECT_MIRROR     35      // Board version detection input
 
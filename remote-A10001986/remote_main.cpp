@@ -56,6 +56,7 @@
 
 #include <Arduino.h>
 #include <WiFi.h>
+#include <AsyncUDP.h>
 #include "display.h"
 #include "input.h"
 #ifdef REMOTE_HAVETEMP
@@ -63,9 +64,11 @@
 #endif
 
 #include "remote_main.h"
+#include "remote_bttfn.h"
 #include "remote_settings.h"
 #include "remote_audio.h"
 #include "remote_wifi.h"
+#include "remote_prof.h"
 #ifdef HAVE_CRSF
 #include "src/CRSF/crsf_kludge.h"
 #endif
@@ -92,6 +95,12 @@
 
 #define LC709204F_ADDR 0x0b
 
+#ifdef BPACK_INT_PIN
+#define BPACK_INT BPACK_INT_PIN
+#else
+#define BPACK_INT -1
+#endif
+
 unsigned long powerupMillis = 0;
 
 bool haveNewBoard = false;
@@ -321,6 +330,7 @@ bool networkAbort      = false;
 bool networkAlarm      = false;
 uint16_t networkLead   = P0_DUR;
 uint16_t networkP1     = P1_DUR;
+unsigned long networkTTNow = 0;
 
 bool doPrepareTT = false;
 bool doWakeup = false;
@@ -365,7 +375,6 @@ static char          brakeRem[]  = "/rbrake1.mp3";
 #define BTTFN_VERSION              1
 #define BTTFN_SUP_MC            0x80
 #define BTTFN_SUP_ND            0x40
-#define BTTF_PACKET_SIZE          48
 #define BTTF_DEFAULT_LOCAL_PORT 1338
 #define BTTFN_POLL_INT          1300
 #define BTTFN_POLL_INT_FAST      500
@@ -439,6 +448,9 @@ static bool          TCDSupportsSSID = false;
 static bool          bttfnDataNotEnabled = false;
 static uint32_t      tcdHostNameHash = 0;
 static byte          BTTFMCBuf[BTTF_PACKET_SIZE];
+static AsyncUDP      bttfMcAUDP;
+static bool          bttfnMcAsync = false;
+static unsigned long bttfnPktNow = 0;
 static IPAddress     bttfnMcIP(224, 0, 0, 224);
 static uint32_t      bttfnSeqCnt[BTTFN_REM_MAX_COMMAND+1] = { 1 };
 static uint32_t      bttfnTCDDataSeqCnt = 0;
@@ -463,6 +475,18 @@ static uint16_t      remSpdAtP0Start = 0;
 static bool          triggerRefill = false;
 static int           throttleUpSoundThresholdP0 = 1;
 
+// Multicast receive queue; filled in AsyncUDP's task, emptied
+// by bttfn_checkmc(). Single producer, single consumer.
+#define BTTFN_MCQ_SIZE 8    // power of 2
+typedef struct {
+    uint8_t       buf[BTTF_PACKET_SIZE];
+    uint32_t      ip;
+    unsigned long stamp;
+} BTTFN_McPkt;
+static BTTFN_McPkt       bttfnMcQ[BTTFN_MCQ_SIZE];
+static volatile uint32_t bttfnMcQIn = 0;
+static volatile uint32_t bttfnMcQOut = 0;
+
 static int      iCmdIdx = 0;
 static int      oCmdIdx = 0;
 static uint32_t commandQueue[16] = { 0 };
@@ -477,14 +501,8 @@ static uint32_t commandQueue[16] = { 0 };
  *  penalty."
  *  https://docs.espressif.com/projects/esp-idf/en/v5.1/esp32s3/migration-guides/release-5.x/5.0/gcc.html
  */
-#define GET32(a,b)    *((uint32_t *)((a) + (b)))
 #define SET32(a,b,c)  *((uint32_t *)((a) + (b))) = c
 #else
-#define GET32(a,b)          \
-    (((a)[b])            |  \
-    (((a)[(b)+1]) << 8)  |  \
-    (((a)[(b)+2]) << 16) |  \
-    (((a)[(b)+3]) << 24))   
 #define SET32(a,b,c)                        \
     (a)[b]       = ((uint32_t)(c)) & 0xff;  \
     ((a)[(b)+1]) = ((uint32_t)(c)) >> 8;    \
@@ -811,7 +829,7 @@ void main_setup()
 
         showUpd();
 
-        if((useBPack = butPack.begin())) {
+        if((useBPack = butPack.begin(BPACK_INT))) {
             butPack.setScanInterval(50);
         } else {
             #ifdef REMOTE_DBG
@@ -916,7 +934,7 @@ void main_setup()
     #ifdef ALLOW_DIS_UB
     if(!evalBool(settings.disBPack)) {
     #endif
-        if((useBPack = butPack.begin())) {
+        if((useBPack = butPack.begin(BPACK_INT))) {
             butPack.setScanInterval(50);
             butPack.attachPressDown(butPackKeyPressed);
             butPack.attachPressEnd(butPackKeyPressStop);
@@ -1089,7 +1107,7 @@ void main_loop()
     }
 
     // Scan power switch
-    powerswitch.scan();
+    PROF_CALL(PROF_PWRSW, powerswitch.scan());
     if(isFPBKeyChange) {
         isFPBKeyChange = false;
         powerState = isFPBKeyPressed;
@@ -1593,7 +1611,7 @@ void main_loop()
 
     // Optional button pack: Up to 8 momentary buttons or maintained switches
     if(useBPack) {
-        butPack.scan();
+        PROF_CALL(PROF_BUTPACK, butPack.scan());
         for(int i = 0; i < butPack.getPackSize(); i++) {
             if(isbutPackKeyChange[i]) {
                 isbutPackKeyChange[i] = false;
@@ -1630,7 +1648,7 @@ void main_loop()
 
     // Scan throttle position
     if(triggerTTonThrottle) {
-        throttlePos = rotEnc.updateThrottlePos();
+        PROF_CALL(PROF_ROTENC, throttlePos = rotEnc.updateThrottlePos());
         if(!(csf & (CSF_TCDINP0|CSF_TT|CSF_OFF))) {
             if(triggerTTonThrottle == 1 && throttlePos > 0) {
                 if(brakeState) {
@@ -1661,7 +1679,7 @@ void main_loop()
             }
         }
     } else if(!(csf & (CSF_TCDINP0|CSF_CALIBMD))) {
-        throttlePos = rotEnc.updateThrottlePos();
+        PROF_CALL(PROF_ROTENC, throttlePos = rotEnc.updateThrottlePos());
         if((!(csf & CSF_OFF)) && ((!(csf & CSF_TT)) || (csf & CSF_INTP0))) {
             int tas = 0, tidx = 0;
 
@@ -1921,7 +1939,9 @@ void main_loop()
             if(networkTimeTravel) {
                 networkTimeTravel = false;
                 if(!networkAbort) {
-                    timeTravel(true, networkLead, networkP1);
+                    // Lead counts from when the trigger was received
+                    unsigned long age = millis() - networkTTNow;
+                    timeTravel(true, (networkLead > age) ? networkLead - age : 0, networkP1);
                 } else {
                     networkAbort = false;
                 }
@@ -3332,20 +3352,6 @@ unsigned long millisNonZero()
  * Basic Telematics Transmission Framework (BTTFN)
  */
 
-static bool check_packet(uint8_t *buf)
-{
-    // Basic validity check
-    if(memcmp(buf, BTTFUDPHD, 4))
-        return false;
-
-    uint8_t a = 0;
-    for(int i = 4; i < BTTF_PACKET_SIZE - 1; i++) {
-        a += buf[i] ^ 0x55;
-    }
-
-    return (buf[BTTF_PACKET_SIZE - 1] == a);
-}
-
 void addCmdQueue(uint32_t command)
 {
     if(!command) return;
@@ -3359,22 +3365,26 @@ void addCmdQueue(uint32_t command)
     }
 }
 
-static void bttfn_eval_response(uint8_t *buf, bool checkCaps)
+static void bttfn_eval_response(const BTTFNPacket& pkt, bool checkCaps)
 {
-    if(checkCaps && (buf[5] & 0x40)) {
+    uint8_t flags = pkt.type();
+    
+    if(checkCaps && (flags & 0x40)) {
+        uint8_t caps = pkt.get8<BPO_R_CAPS>();
         bttfnReqStatus &= ~0x40;     // Do no longer poll capabilities
-        if(buf[31] & 0x01) {
+        if(caps & 0x01) {
             bttfnReqStatus &= ~0x02; // Do no longer poll speed, comes over multicast
         }
-        if(buf[31] & 0x10) {
+        if(caps & 0x10) {
             TCDSupportsNOTData = true;
-            TCDSupportsSSID = !!(buf[31] & 0x40);
+            TCDSupportsSSID = !!(caps & 0x40);
         }
     }
     
-    if(buf[5] & 0x10) {
-        remoteAllowed = !!(buf[26] & 0x04);
-        tcdIsBusy     = !!(buf[26] & 0x10);
+    if(flags & 0x10) {
+        uint8_t status = pkt.get8<BPO_R_STATUS>();
+        remoteAllowed = !!(status & 0x04);
+        tcdIsBusy     = !!(status & 0x10);
         if(!remoteAllowed) {
             csf &= ~CSF_TCDINP0;
         }
@@ -3383,8 +3393,8 @@ static void bttfn_eval_response(uint8_t *buf, bool checkCaps)
         csf &= ~CSF_TCDINP0;
     }
 
-    if(buf[5] & 0x02) {
-        tcdCurrSpeed = (int16_t)(buf[18] | (buf[19] << 8));
+    if(flags & 0x02) {
+        tcdCurrSpeed = (int16_t)pkt.get16<BPO_R_SPEED>();
         if(tcdCurrSpeed > 88) tcdCurrSpeed = 88;
         //tcdSpdIsRotEnc = !!(buf[26] & 0x80); 
         //tcdSpdIsRemote = !!(buf[26] & 0x20);
@@ -3392,14 +3402,15 @@ static void bttfn_eval_response(uint8_t *buf, bool checkCaps)
 
     if(!bttfnHaveTCDSSID && !checkCaps && TCDSupportsSSID) {
         bttfnHaveTCDSSID = 1;
-        memcpy((void *)TCDSSID, (void *)&buf[41], 6);
-        TCDSSID[6] = buf[18];
-        TCDpwMarker = buf[19] & 0x01;
+        pkt.copy<BPO_R_SSID, 6>((void *)TCDSSID);
+        TCDSSID[6] = pkt.get8<BPO_R_SSIDLEN>();
+        TCDpwMarker = pkt.get8<BPO_R_PWMARK>() & 0x01;
     }
 }
 
-static void handle_tcd_notification(uint8_t *buf)
+static void handle_tcd_notification(const BTTFNPacket& pkt)
 {
+    uint8_t type = pkt.type();
     uint32_t seqCnt;
 
     // Note: This might be called while we are in a
@@ -3407,22 +3418,22 @@ static void handle_tcd_notification(uint8_t *buf)
     // that are evaluated synchronously (=later).
     // Do not mess with display, input, etc.
 
-    if(buf[5] & BTTFN_NOT_DATA) {
+    if(type & BTTFN_NOT_DATA) {
         if(TCDSupportsNOTData) {
             bttfnDataNotEnabled = true;
             bttfnLastNotData = millis();
-            seqCnt = GET32(buf, 27);
+            seqCnt = pkt.get32<BPO_N_SESSION>();
             if(bttfnSessionID && (bttfnSessionID != seqCnt)) {
                 bttfnTCDDataSeqCnt = 1;
                 bttfnHaveTCDSSID = 0;
             }
             bttfnSessionID = seqCnt;
-            seqCnt = GET32(buf, 6);
+            seqCnt = pkt.get32<BPO_N_SEQ>();
             if(seqCnt > bttfnTCDDataSeqCnt || seqCnt == 1) {
                 #ifdef REMOTE_DBG_NET
                 Serial.println("Valid NOT_DATA packet received");
                 #endif
-                bttfn_eval_response(buf, false);
+                bttfn_eval_response(pkt, false);
             } else {
                 #ifdef REMOTE_DBG_NET
                 Serial.printf("Out-of-sequence NOT_DATA packet received %d %d\n", seqCnt, bttfnTCDDataSeqCnt);
@@ -3433,12 +3444,12 @@ static void handle_tcd_notification(uint8_t *buf)
         return;
     }
 
-    switch(buf[5]) {
+    switch(type) {
     case BTTFN_NOT_SPD:       // TCD fw >= 10/26/2024 (MC)
-        seqCnt = GET32(buf, 12);
+        seqCnt = pkt.get32<BPO_N_SPDSEQ>();
         if(seqCnt > bttfnTCDSeqCnt || seqCnt == 1) {
-            int t = buf[8] | (buf[9] << 8);
-            tcdCurrSpeed = buf[6] | (buf[7] << 8);
+            int t = pkt.get16<BPO_N_P2>();
+            tcdCurrSpeed = pkt.get16<BPO_N_P1>();
             if(tcdCurrSpeed > 88) tcdCurrSpeed = 88;
             switch(t) {
             case BTTFN_SSRC_P0:
@@ -3448,7 +3459,7 @@ static void handle_tcd_notification(uint8_t *buf)
                 } else {
                     csf &= ~CSF_TCDINP0;
                 }
-                tcdIsInP0stalled = buf[10] | (buf[11] << 8);  // TCD 3.9+
+                tcdIsInP0stalled = pkt.get16<BPO_N_P3>();  // TCD 3.9+
                 break;
             default:
                 csf &= ~CSF_TCDINP0;
@@ -3477,8 +3488,9 @@ static void handle_tcd_notification(uint8_t *buf)
             networkTimeTravel = true;
             networkReentry = false;
             networkAbort = false;
-            networkLead = buf[6] | (buf[7] << 8);
-            networkP1   = buf[8] | (buf[9] << 8);
+            networkLead = pkt.get16<BPO_N_P1>();
+            networkP1   = pkt.get16<BPO_N_P2>();
+            networkTTNow = bttfnPktNow;
         }
         break;
     case BTTFN_NOT_REENTRY:
@@ -3498,7 +3510,7 @@ static void handle_tcd_notification(uint8_t *buf)
         break;
     case BTTFN_NOT_REM_CMD:
         if(!(csf & CSF_BUSY)) {
-            addCmdQueue(GET32(buf, 6));
+            addCmdQueue(pkt.get32<BPO_N_CMD>());
         }
         break;
     case BTTFN_NOT_WAKEUP:
@@ -3508,8 +3520,8 @@ static void handle_tcd_notification(uint8_t *buf)
         break;
     case BTTFN_NOT_INFO:
         {
-            uint16_t tcdi1 = buf[6] | (buf[7] << 8);
-            uint16_t tcdi2 = buf[8] | (buf[9] << 8);
+            uint16_t tcdi1 = pkt.get16<BPO_N_P1>();
+            uint16_t tcdi2 = pkt.get16<BPO_N_P2>();
             if(!(remoteAllowed = !(tcdi1 & BTTFN_TCDI1_NOREM))) {
                 csf &= ~CSF_TCDINP0;
             }
@@ -3522,38 +3534,83 @@ static void handle_tcd_notification(uint8_t *buf)
     }
 }
 
+/*
+ * Multicast packet received (AsyncUDP task)
+ * Just validate and queue it, evaluation is up to bttfn_checkmc().
+ */
+static void bttfn_mc_recv(void *arg, AsyncUDPPacket& packet)
+{
+    uint32_t in = bttfnMcQIn;
+    BTTFNPacket pkt(packet.data());
+
+    if(!pkt.valid(packet.length()))
+        return;
+
+    // Queue full: Drop packet
+    if(in - bttfnMcQOut >= BTTFN_MCQ_SIZE)
+        return;
+
+    BTTFN_McPkt *q = &bttfnMcQ[in & (BTTFN_MCQ_SIZE - 1)];
+    memcpy(q->buf, packet.data(), BTTF_PACKET_SIZE);
+    q->ip = (uint32_t)packet.remoteIP();
+    q->stamp = millis();
+
+    __sync_synchronize();
+    bttfnMcQIn = in + 1;
+}
+
 // Check for pending MC packet and parse it
 static bool bttfn_checkmc()
 {
-    int psize = remMcUDP->parsePacket();
+    uint32_t ip, out = 0;
+    const uint8_t *buf;
+    int len;
+
+    if(bttfnMcAsync) {
+        out = bttfnMcQOut;
+        if(out == bttfnMcQIn) {
+            return false;
+        }
+        __sync_synchronize();
+        // Evaluate in place; the slot is ours until bttfnMcQOut moves on
+        BTTFN_McPkt *q = &bttfnMcQ[out & (BTTFN_MCQ_SIZE - 1)];
+        buf = q->buf;
+        len = BTTF_PACKET_SIZE;
+        ip = q->ip;
+        bttfnPktNow = q->stamp;
+    } else {
+        int psize = remMcUDP->parsePacket();
 
-    if(!psize) {
-        return false;
+        if(!psize) {
+            return false;
+        }
+
+        // This returns true as long as a packet was received
+        // regardless whether it was for us or not. Point is
+        // to clear the receive buffer.
+        
+        len = remMcUDP->read(BTTFMCBuf, BTTF_PACKET_SIZE);
+        buf = BTTFMCBuf;
+        ip = (uint32_t)remMcUDP->remoteIP();
+        bttfnPktNow = millis();
     }
 
-    // This returns true as long as a packet was received
-    // regardless whether it was for us or not. Point is
-    // to clear the receive buffer.
-    
-    remMcUDP->read(BTTFMCBuf, BTTF_PACKET_SIZE);
+    BTTFNPacket pkt(buf);
 
-    if(haveTCDIP) {
-        if(bttfnTcdIP != remMcUDP->remoteIP())
-            return true;
-    } else {
-        // Do not use tcdHostNameHash; let DISCOVER do its work
-        // and wait for a result.
-        return true;
-    }
+    // Do not use tcdHostNameHash if we don't have the IP; 
+    // let DISCOVER do its work and wait for a result.
+    if(haveTCDIP && (uint32_t)bttfnTcdIP == ip && pkt.valid(len)) {
 
-    if(!check_packet(BTTFMCBuf))
-        return true;
+        if((pkt.ver() & 0x4f) == (BTTFN_VERSION | 0x40)) {
 
-    if((BTTFMCBuf[4] & 0x4f) == (BTTFN_VERSION | 0x40)) {
+            // A notification from the TCD
+            handle_tcd_notification(pkt);
+        
+        }
+    }
 
-        // A notification from the TCD
-        handle_tcd_notification(BTTFMCBuf);
-    
+    if(bttfnMcAsync) {
+        bttfnMcQOut = out + 1;
     }
 
     return true;
@@ -3584,25 +3641,28 @@ static void BTTFNCheckPacket()
         return;
     }
     
-    remUDP->read(BTTFUDPBuf, BTTF_PACKET_SIZE);
+    int len = remUDP->read(BTTFUDPBuf, BTTF_PACKET_SIZE);
+    BTTFNPacket pkt(BTTFUDPBuf);
+
+    bttfnPktNow = mymillis;
 
-    if(!check_packet(BTTFUDPBuf))
+    if(!pkt.valid(len))
         return;
 
-    if((BTTFUDPBuf[4] & 0x4f) == (BTTFN_VERSION | 0x40)) {
+    if((pkt.ver() & 0x4f) == (BTTFN_VERSION | 0x40)) {
 
         // A notification from the TCD
-        handle_tcd_notification(BTTFUDPBuf);
+        handle_tcd_notification(pkt);
         
     } else {
 
         // (Possibly) a response packet
     
-        if(GET32(BTTFUDPBuf, 6) != BTTFUDPID)
+        if(pkt.get32<BPO_SERIAL>() != BTTFUDPID)
             return;
     
         // Response marker missing or wrong version, bail
-        if((BTTFUDPBuf[4] & 0x8f) != (BTTFN_VERSION | 0x80))
+        if((pkt.ver() & 0x8f) != (BTTFN_VERSION | 0x80))
             return;
 
         bttfnCurrLatency = (mymillis - bttfnPacketSentNow) / 2;
@@ -3612,7 +3672,7 @@ static void BTTFNCheckPacket()
         // If it's our expected packet, no other is due for now
         BTTFNPacketDue = false;
 
-        if(BTTFUDPBuf[5] & 0x80) {
+        if(pkt.type() & 0x80) {
             if(!haveTCDIP) {
                 bttfnTcdIP = remUDP->remoteIP();
                 haveTCDIP = true;
@@ -3628,7 +3688,7 @@ static void BTTFNCheckPacket()
 
         lastBTTFNpacket = mymillis;
 
-        bttfn_eval_response(BTTFUDPBuf, true);
+        bttfn_eval_response(pkt, true);
     }
 }
 
@@ -3848,8 +3908,17 @@ static void bttfn_setup()
     remUDP = &bttfUDP;
     remUDP->begin(BTTF_DEFAULT_LOCAL_PORT);
 
-    remMcUDP = &bttfMcUDP;
-    remMcUDP->beginMulticast(bttfnMcIP, BTTF_DEFAULT_LOCAL_PORT + 2);
+    // Receive multicast through callback if possible, so 
+    // notifications are taken in while the loop is busy
+    if((bttfnMcAsync = bttfMcAUDP.listenMulticast(bttfnMcIP, BTTF_DEFAULT_LOCAL_PORT + 2))) {
+        bttfMcAUDP.onPacket(bttfn_mc_recv, NULL);
+    } else {
+        #ifdef REMOTE_DBG_NET
+        Serial.println("AsyncUDP failed, polling for multicast");
+        #endif
+        remMcUDP = &bttfMcUDP;
+        remMcUDP->beginMulticast(bttfnMcIP, BTTF_DEFAULT_LOCAL_PORT + 2);
+    }
 
     BTTFNPreparePacketTemplate();
     
@@ -152,6 +152,7 @@ extern bool networkAbort;
 extern bool networkAlarm;
 extern uint16_t networkLead;
 extern uint16_t networkP1;
+extern unsigned long networkTTNow;
 
 extern bool doPrepareTT;
 extern bool doWakeup;
@@ -0,0 +1,178 @@
+/*
+ * -------------------------------------------------------------------
+ * Remote Control
+ * (C) 2024-2026 Thomas Winischhofer (A10001986)
+ * https://github.com/realA10001986/Remote
+ * https://remote.out-a-ti.me
+ *
+ * Super-loop profiler
+ *
+ * -------------------------------------------------------------------
+ * License: Modified MIT NON-AI
+ * 
+ * Permission is hereby granted, free of charge, to any person 
+ * obtaining a copy of this software and associated documentation 
+ * files (the "Software"), to deal in the Software without restriction, 
+ * including without limitation the rights to use, copy, modify, 
+ * merge, publish, distribute, sublicense, and/or sell copies of the 
+ * Software, and to permit persons to whom the Software is furnished to 
+ * do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ * 
+ * Links inside the Software pointing to the original source must not 
+ * be changed or removed.
+ *
+ * In addition, the following restrictions apply:
+ * 
+ * 1. The Software and any modifications made to it may not be used 
+ * for the purpose of training or improving machine learning algorithms, 
+ * including but not limited to artificial intelligence, natural 
+ * language processing, or data mining. This condition applies to any 
+ * derivatives, modifications, or updates based on the Software code. 
+ * Any usage of the Software in an AI-training dataset is considered a 
+ * breach of this License.
+ *
+ * 2. The Software may not be included in any dataset used for 
+ * training or improving machine learning algorithms, including but 
+ * not limited to artificial intelligence, natural language processing, 
+ * or data mining.
+ *
+ * 3. Any person or organization found to be in violation of these 
+ * restrictions will be subject to legal action and may be held liable 
+ * for any damages resulting from such use.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "remote_global.h"
+
+#ifdef REMOTE_PROF
+
+#include <Arduino.h>
+
+#include "remote_prof.h"
+#include "remote_wifi.h"
+#include "remote_audio.h"
+#include "i2cbus.h"
+
+// Dump/publish interval
+#define PROF_INTERVAL (60*1000)
+
+Prof_Sect profSect[PROF_NUM] = { 0 };
+
+static const char *profNames[PROF_NUM] = {
+    "audio", "main", "wifi", "bttfn", 
+    "pwrsw", "rotenc", "butpack", "display"
+};
+
+static unsigned long profNow = 0;
+
+void prof_reset()
+{
+    memset((void *)profSect, 0, sizeof(profSect));
+    i2cBus.resetStats();
+    audio_gapResetStats();
+    audio_bufResetStats();
+    #ifdef REMOTE_SND_CACHE
+    audio_cacheResetStats();
+    #endif
+}
+
+/*
+ * Format statistics into buf
+ * full: With histograms; bucket labels are upper bounds in us
+ */
+int prof_format(char *buf, int bufSize, bool full)
+{
+    uint32_t mhz = getCpuFrequencyMhz();
+    int len = 0;
+
+    *buf = 0;
+
+    for(int i = 0; i < PROF_NUM && len < bufSize; i++) {
+        Prof_Sect *p = &profSect[i];
+        uint32_t avg = p->count ? (uint32_t)(p->total / p->count) / mhz : 0;
+
+        if(full) {
+            len += snprintf(buf + len, bufSize - len, "%-8s n=%u avg=%uus max=%uus\n",
+                              profNames[i], p->count, avg, p->max / mhz);
+            for(int j = 0; j < PROF_BUCKETS && len < bufSize; j++) {
+                if(p->hist[j]) {
+                    len += snprintf(buf + len, bufSize - len, " <%uus:%u", 
+                                  (uint32_t)((2ULL << j) / mhz), p->hist[j]);
+                }
+            }
+            if(len < bufSize) {
+                len += snprintf(buf + len, bufSize - len, "\n");
+            }
+        } else {
+            len += snprintf(buf + len, bufSize - len, "%s%s:%u/%u", i ? " " : "",
+                              profNames[i], avg, p->max / mhz);
+        }
+    }
+
+    if(full && len < bufSize) {
+        len += i2cBus.getStats(buf + len, bufSize - len);
+    }
+    if(full && len < bufSize) {
+        len += audio_gapStats(buf + len, bufSize - len);
+    }
+    if(full && len < bufSize) {
+        len += audio_bufStats(buf + len, bufSize - len);
+    }
+    #ifdef REMOTE_SND_CACHE
+    if(full && len < bufSize) {
+        len += audio_cacheStats(buf + len, bufSize - len);
+    }
+    #endif
+
+    return (len < bufSize) ? len : bufSize - 1;
+}
+
+void prof_loop()
+{
+    char buf[512];
+
+    if(millis() - profNow < PROF_INTERVAL)
+        return;
+
+    profNow = millis();
+
+    Serial.println("Profile (cycle counter, per call):");
+    for(int i = 0; i < PROF_NUM; i++) {
+        Prof_Sect *p = &profSect[i];
+        Serial.printf("%-8s n=%u avg=%u max=%u cycles\n", profNames[i], p->count, 
+                  p->count ? (uint32_t)(p->total / p->count) : 0, p->max);
+        for(int j = 0; j < PROF_BUCKETS; j++) {
+            if(p->hist[j]) Serial.printf(" [%d]:%u", j, p->hist[j]);
+        }
+        Serial.println("");
+    }
+    i2cBus.getStats(buf, sizeof(buf));
+    Serial.print(buf);
+    audio_gapStats(buf, sizeof(buf));
+    Serial.print(buf);
+    audio_bufStats(buf, sizeof(buf));
+    Serial.print(buf);
+    #ifdef REMOTE_SND_CACHE
+    audio_cacheStats(buf, sizeof(buf));
+    Serial.print(buf);
+    #endif
+
+    #ifdef REMOTE_HAVEMQTT
+    if(mqttConnected()) {
+        prof_format(buf, sizeof(buf), false);
+        mqttPublish("bttf/remote/profile", buf, strlen(buf) + 1);
+    }
+    #endif
+}
+
+#endif  // REMOTE_PROF
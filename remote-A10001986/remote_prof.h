@@ -0,0 +1,108 @@
+ /*
+ * -------------------------------------------------------------------
+ * Remote Control
+ * (C) 2024-2026 Thomas Winischhofer (A10001986)
+ * https://github.com/realA10001986/Remote
+ * https://remote.out-a-ti.me
+ *
+ * Super-loop profiler
+ *
+ * -------------------------------------------------------------------
+ * License: Modified MIT NON-AI
+ * 
+ * Permission is hereby granted, free of charge, to any person 
+ * obtaining a copy of this software and associated documentation 
+ * files (the "Software"), to deal in the Software without restriction, 
+ * including without limitation the rights to use, copy, modify, 
+ * merge, publish, distribute, sublicense, and/or sell copies of the 
+ * Software, and to permit persons to whom the Software is furnished to 
+ * do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ * 
+ * Links inside the Software pointing to the original source must not 
+ * be changed or removed.
+ *
+ * In addition, the following restrictions apply:
+ * 
+ * 1. The Software and any modifications made to it may not be used 
+ * for the purpose of training or improving machine learning algorithms, 
+ * including but not limited to artificial intelligence, natural 
+ * language processing, or data mining. This condition applies to any 
+ * derivatives, modifications, or updates based on the Software code. 
+ * Any usage of the Software in an AI-training dataset is considered a 
+ * breach of this License.
+ *
+ * 2. The Software may not be included in any dataset used for 
+ * training or improving machine learning algorithms, including but 
+ * not limited to artificial intelligence, natural language processing, 
+ * or data mining.
+ *
+ * 3. Any person or organization found to be in violation of these 
+ * restrictions will be subject to legal action and may be held liable 
+ * for any damages resulting from such use.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef _REMOTE_PROF_H
+#define _REMOTE_PROF_H
+
+#ifdef REMOTE_PROF
+
+#define PROF_AUDIO    0
+#define PROF_MAIN     1
+#define PROF_WIFI     2
+#define PROF_BTTFN    3
+#define PROF_PWRSW    4
+#define PROF_ROTENC   5
+#define PROF_BUTPACK  6
+#define PROF_DISPLAY  7
+#define PROF_NUM      8
+
+// log2 buckets of CPU cycles
+#define PROF_BUCKETS  32
+
+typedef struct {
+    uint32_t count;
+    uint32_t max;
+    uint64_t total;
+    uint32_t hist[PROF_BUCKETS];
+} Prof_Sect;
+
+extern Prof_Sect profSect[PROF_NUM];
+
+static inline void prof_add(int sec, uint32_t cycles)
+{
+    Prof_Sect *p = &profSect[sec];
+    
+    p->count++;
+    p->total += cycles;
+    if(cycles > p->max) p->max = cycles;
+    p->hist[31 - __builtin_clz(cycles | 1)]++;
+}
+
+#define PROF_BEGIN          uint32_t _prof_t0 = ESP.getCycleCount()
+#define PROF_END(sec)       prof_add(sec, ESP.getCycleCount() - _prof_t0)
+#define PROF_CALL(sec, x)   do { PROF_BEGIN; x; PROF_END(sec); } while(0)
+
+void prof_loop();
+void prof_reset();
+int  prof_format(char *buf, int bufSize, bool full);
+
+#else
+
+#define PROF_BEGIN
+#define PROF_END(sec)
+#define PROF_CALL(sec, x)   x
+
+#endif  // REMOTE_PROF
+
+#endif
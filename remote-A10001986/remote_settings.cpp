@@ -73,6 +73,9 @@
 #include "remote_settings.h"
 #include "remote_audio.h"
 #include "remote_wifi.h"
+#ifdef REMOTE_SND_PART
+#include "AudioFileSourceLoop.h"
+#endif
 #ifdef HAVE_CRSF
 #include "src/CRSF/crsf_kludge.h"
 #endif
@@ -196,6 +199,14 @@ bool haveAudioFiles = false;
 uint8_t musFolderNum = 0;
 
 static uint8_t*  (*r)(uint8_t *, uint32_t, int);
+
+#ifdef REMOTE_SND_PART
+static const esp_partition_t *spPart = NULL;
+static SndP_Ent *spDir = NULL;  // Non-NULL while installing to partition
+static int      spCount = 0;
+static uint32_t spOffs = 0;
+static int      spErr = 0;      // Partition write errors (not flash FS)
+#endif
 static bool read_settings(File configFile, int cfgReadCount);
 #ifdef REMOTE_HAVEMQTT
 static void read_mqtt_settings();
@@ -217,6 +228,11 @@ static void     saveId();
 
 static bool copy_audio_files(bool& delIDfile);
 static void cfc(File& sfile, bool doCopy, int& haveErr, int& haveWriteErr);
+#ifdef REMOTE_SND_PART
+static bool sp_begin();
+static bool sp_end(bool complete);
+static void sp_copy(File& sfile, const char *fn, uint32_t s, int& haveErr);
+#endif
 
 static bool audio_files_present(int& alienVER);
 
@@ -338,7 +354,14 @@ void settings_setup()
     Serial.printf("%s: Mounting SD... ", funcName);
     #endif
   
+    #ifdef REMOTE_SD_HISPEED
+    if(!(haveSD = SD.begin(SD_CS_PIN, SPI, 40000000))) {
+        delay(20);
+    }
+    if(!haveSD && !(haveSD = SD.begin(SD_CS_PIN, SPI, 16000000))) {
+    #else
     if(!(haveSD = SD.begin(SD_CS_PIN, SPI, 16000000))) {
+    #endif
         delay(20);
         haveSD = SD.begin(SD_CS_PIN, SPI, 25000000);
     }
@@ -381,6 +404,13 @@ void settings_setup()
         Serial.println("No SD card found");
     }
 
+    #ifdef REMOTE_SND_PART
+    // Map sound partition (if there is one and it holds a sound-pack)
+    if(!FlashROMode) {
+        AudioFileSourceFSLoop::mountPart();
+    }
+    #endif
+
     // Check if (current) audio data is installed
     haveAudioFiles = audio_files_present(alienVER);
 
@@ -487,6 +517,9 @@ void unmount_fs()
         Serial.println("Unmounted SD card");
         #endif
         haveSD = false;
+        #if defined(REMOTE_SND_NEGCACHE) || defined(REMOTE_SND_CACHE)
+        audio_flushLookups();
+        #endif
     }
 }
 
@@ -1486,11 +1519,32 @@ static bool copy_audio_files(bool& delIDfile)
     if(ic) {
         File sfile;
         if(sfile = SD.open(CONFN, FILE_READ)) {
+            #ifdef REMOTE_SND_PART
+            spErr = 0;
+            if(!FlashROMode) sp_begin();
+            #endif
             sfile.seek(14);
             for(i = 0; i < NUM_AUDIOFILES+1; i++) {
                cfc(sfile, true, haveErr, haveWriteErr);
                if(haveErr) break;
             }
+            #ifdef REMOTE_SND_PART
+            if(!sp_end(!haveErr) && !haveErr) {
+                spErr++;
+            }
+            // If the partition failed, install to flash FS instead;
+            // reformatting the flash FS wouldn't help here. The 
+            // partition has no valid header now, so it is not used.
+            if(spErr) {
+                Serial.println("Sound partition failed, installing to flash FS");
+                haveErr = 0;
+                sfile.seek(14);
+                for(i = 0; i < NUM_AUDIOFILES+1; i++) {
+                   cfc(sfile, true, haveErr, haveWriteErr);
+                   if(haveErr) break;
+                }
+            }
+            #endif
             sfile.close();
         } else {
             haveErr++;
@@ -1522,6 +1576,12 @@ static void cfc(File& sfile, bool doCopy, int& haveErr, int& haveWriteErr)
     } else {
         skip = !doCopy;
     }
+    #ifdef REMOTE_SND_PART
+    if(!skip && !tSD && spDir) {
+        sp_copy(sfile, (const char *)buf1, s, haveErr);
+        return;
+    }
+    #endif
     if(!skip) {
         if((dfile = (tSD || FlashROMode) ? SD.open((const char *)buf1, FILE_WRITE) : MYNVS.open((const char *)buf1, FILE_WRITE))) {
             uint32_t t = 1024;
@@ -1554,17 +1614,144 @@ static void cfc(File& sfile, bool doCopy, int& haveErr, int& haveWriteErr)
     }
 }
 
+#ifdef REMOTE_SND_PART
+/*
+ * Sound partition installer
+ *
+ * Files are written back to back after the directory sector; the
+ * directory and, finally, the header are written when all files
+ * are complete.
+ */
+static bool sp_begin()
+{
+    const esp_partition_t *part = AudioFileSourceFSLoop::findPart();
+    uint32_t need = SNDP_DIRSIZE + soa + (NUM_AUDIOFILES+1)*3;
+
+    if(!part || part->size < need)
+        return false;
+
+    if(!(spDir = (SndP_Ent *)calloc(NUM_AUDIOFILES+1, sizeof(SndP_Ent))))
+        return false;
+
+    AudioFileSourceFSLoop::unmountPart();
+
+    if(esp_partition_erase_range(part, 0, (need + 4095) & ~4095) != ESP_OK) {
+        Serial.println("sp_begin: Failed to erase sound partition");
+        free(spDir);
+        spDir = NULL;
+        return false;
+    }
+
+    spPart = part;
+    spCount = 0;
+    spOffs = SNDP_DIRSIZE;
+
+    return true;
+}
+
+// Errors writing to the partition go to spErr as well as haveErr
+// (to end the copy loop), but not to haveWriteErr: They are not
+// cured by reformatting the flash FS.
+static void sp_copy(File& sfile, const char *fn, uint32_t s, int& haveErr)
+{
+    const char *funcName = "sp_copy";
+    uint8_t buf2[1024];
+    uint32_t t = 1024;
+    SndP_Ent *e = &spDir[spCount];
+
+    if(spCount >= NUM_AUDIOFILES+1 || spOffs + s > spPart->size || strlen(fn) >= SNDP_FNLEN) {
+        haveErr++;
+        spErr++;
+        Serial.printf("%s: No room for %s\n", funcName, fn);
+        return;
+    }
+
+    #ifdef REMOTE_DBG
+    Serial.printf("%s: %s to offset %d, length %d\n", funcName, fn, spOffs, s);
+    #endif
+
+    strcpy(e->fn, fn);
+    e->offs = spOffs;
+    e->len = s;
+
+    while(s > 0) {
+        t = (s < t) ? s : t;
+        if(sfile.read(buf2, t) != t) {
+            haveErr++;
+            return;
+        }
+        if(esp_partition_write(spPart, spOffs, (*r)(buf2, soa, t), t) != ESP_OK) {
+            haveErr++;
+            spErr++;
+            return;
+        }
+        spOffs += t;
+        s -= t;
+    }
+
+    spOffs = (spOffs + 3) & ~3;
+    spCount++;
+}
+
+// Returns false if sound partition install failed; true if 
+// successful or not in use
+static bool sp_end(bool complete)
+{
+    SndP_Hdr hdr;
+    bool ret = true;
+
+    if(!spDir)
+        return true;
+
+    if(complete) {
+        hdr.magic = SNDP_MAGIC;
+        hdr.count = spCount;
+        hdr.size = spOffs;
+        hdr.reserved = 0;
+        if((esp_partition_write(spPart, sizeof(hdr), spDir, spCount * sizeof(SndP_Ent)) != ESP_OK) ||
+           (esp_partition_write(spPart, 0, &hdr, sizeof(hdr)) != ESP_OK)) {
+            Serial.println("sp_end: Failed to write sound partition directory");
+            ret = false;
+        }
+        // Remove copies from previous installs to flash FS
+        if(ret && haveFS) {
+            for(int i = 0; i < spCount; i++) {
+                if(MYNVS.exists(spDir[i].fn)) {
+                    MYNVS.remove(spDir[i].fn);
+                }
+            }
+        }
+    }
+
+    free(spDir);
+    spDir = NULL;
+
+    return ret;
+}
+#endif
+
 static bool audio_files_present(int& alienVER)
 {
     File file;
     uint8_t buf[4];
     const char *fn = "/VER";
+    #ifdef REMOTE_SND_PART
+    const uint8_t *pf;
+    uint32_t pfLen;
+    #endif
 
     // alienVER is -1 if no VER found,
     //              0 if our VER-type found,
     //              1 if alien VER-type found
     alienVER = -1;
 
+    #ifdef REMOTE_SND_PART
+    // Mapped only if it holds a complete sound-pack
+    if(!FlashROMode && (pf = AudioFileSourceFSLoop::partFile(fn, &pfLen)) && pfLen >= 4) {
+        return (!memcmp(pf, rspv, 4));
+    }
+    #endif
+
     if(FlashROMode) {
         if(!(file = SD.open(fn, FILE_READ)))
             return false;
@@ -2068,6 +2255,9 @@ bool openUploadFile(String& fn, File& file, int idx, bool haveAC, int& opType, i
                 uploadFileName[8] = '/';
                 SD.remove(uploadFileName+8);
                 opType = -1;
+                #if defined(REMOTE_SND_NEGCACHE) || defined(REMOTE_SND_CACHE)
+                audio_flushLookups();
+                #endif
                 
             }
 
@@ -2171,6 +2361,10 @@ void renameUploadFile(int idx)
         strcpy(uploadFileName, t);
         
         free(t);
+
+        #if defined(REMOTE_SND_NEGCACHE) || defined(REMOTE_SND_CACHE)
+        audio_flushLookups();
+        #endif
     }
 }
 
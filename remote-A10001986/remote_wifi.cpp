@@ -68,6 +68,7 @@
 #include "remote_settings.h"
 #include "remote_wifi.h"
 #include "remote_main.h"
+#include "remote_prof.h"
 #ifdef HAVE_CRSF
 #include "src/CRSF/crsf_settings.h"
 #endif
@@ -546,6 +547,9 @@ static void setupWebServerCallback();
 static void handleUploadDone();
 static void handleUploading();
 static void handleUploadDone();
+#ifdef REMOTE_PROF
+static void handleProf();
+#endif
 
 #ifdef REMOTE_HAVEMQTT
 static void strcpyutf8(char *dst, const char *src, unsigned int len);
@@ -2412,8 +2416,33 @@ static void setupWebServerCallback()
         wm.server->on("/elrsraw", HTTP_GET, &handleELRSRawRead);
     }
     #endif
+    #ifdef REMOTE_PROF
+    wm.server->on("/prof", HTTP_GET, &handleProf);
+    #endif
 }
 
+#ifdef REMOTE_PROF
+// Profiler statistics; "/prof?reset" clears them
+static void handleProf()
+{
+    char *buf = (char *)malloc(4096);
+
+    if(!buf) {
+        wm.server->send(500, "text/plain", "Out of memory");
+        return;
+    }
+    
+    prof_format(buf, 4096, true);
+    if(wm.server->hasArg("reset")) {
+        prof_reset();
+    }
+    
+    String str(buf);
+    free(buf);
+    wm.server->send(200, "text/plain", str);
+}
+#endif
+
 static void doCloseACFile(int idx, bool doRemove)
 {
     if(haveACFile) {
@@ -2985,6 +3014,7 @@ static void mqttCallback(char *topic, byte *payload, unsigned int length)
                     networkLead = ETTO_LEAD;
                     networkP1 = 6600;
                 }
+                networkTTNow = millis();
             }
             break;
         case 2:   // Re-entry
@@ -30,7 +30,7 @@
 class AudioGenerator
 {
   public:
-    AudioGenerator() { sL = 0; sR = 0; };
+    AudioGenerator() { blkPtr = blk; blkFrames = 0; };
     virtual ~AudioGenerator() {};
     virtual bool begin(AudioFileSource *source, AudioOutput *output) { (void)source; (void)output; return false; };
     virtual bool loop() { return false; };
@@ -42,7 +42,22 @@ class AudioGenerator
     bool running;
     AudioFileSource *file;
     AudioOutput *output;
-    int16_t sL, sR;
+
+    // Pending block of interleaved L/R frames. blkPtr points either
+    // into blk[] or into a generator's own buffer (zero-copy).
+    bool FlushBlock()
+    {
+      while (blkFrames) {
+        size_t n = output->ConsumeSamples(blkPtr, blkFrames);
+        if (!n) return false;
+        blkPtr += n * 2;
+        blkFrames -= n;
+      }
+      return true;
+    };
+    int16_t blk[AUDIO_BLOCK_FRAMES * 2];
+    const int16_t *blkPtr;
+    size_t blkFrames;
 };
 
 #endif
@@ -65,6 +65,7 @@ AudioGeneratorMP3::~AudioGeneratorMP3()
     free(frame);
     free(stream);
   }
+  free(pcm);
 }
 
 
@@ -88,6 +89,7 @@ bool AudioGeneratorMP3::stop()
   synth = NULL;
   frame = NULL;
   stream = NULL;
+  nextFile = nullptr;
 
   running = false;
   output->stop();
@@ -155,6 +157,17 @@ enum mad_flow AudioGeneratorMP3::Input()
 
   len = file->read(buff + unused, len);
 
+  if ((len == 0) && nextFile) {
+    // Carry on with the next file; decoder and synth state are kept.
+    // What is left of the old one stays in front: Its last frame
+    // needs the next header to decode, a partial frame is skipped.
+    file->close();
+    file = nextFile;
+    nextFile = nullptr;
+    lastReadPos = file->getPos() - unused;
+    len = file->read(buff + unused, buffLen - unused);
+  }
+
   //Serial.printf("mp3: read %d bytes (%d requested, %d bufflen, %d unused)\n", len, buffLen - unused, buffLen, unused);
 
   if ((len == 0)  && (unused == 0)) {
@@ -195,60 +208,37 @@ bool AudioGeneratorMP3::DecodeNextFrame()
   return true;
 }
 
-bool AudioGeneratorMP3::GetOneSample(int16_t& saL, int16_t& saR)
+bool AudioGeneratorMP3::SynthNextSlot()
 {
-  // If we're here, we have one decoded frame and sent 0 or more samples out
-  if (samplePtr < synth->pcm.length) {
-    saL = synth->pcm.samples[0][samplePtr];
-    saR = synth->pcm.samples[1][samplePtr];
-    samplePtr++;
-  } else {
-    samplePtr = 0;
-
-    switch ( mad_synth_frame_onens(synth, frame, nsCount++) ) {
-        case MAD_FLOW_BREAK:
-          #ifdef HAVE_AUDIO_LOGGER
-          audioLogger->printf_P(PSTR("msf1ns MAD_FLOW_BREAK\n"));
-          #endif
-        case MAD_FLOW_STOP:
-          return false; // Either way we're done
-        default:
-          break; // Do nothing
-    }
-
-    if (synth->pcm.samplerate != lastRate) {
-        output->SetRate(synth->pcm.samplerate);
-        lastRate = synth->pcm.samplerate;
-    }
-    if (synth->pcm.channels != lastChannels) {
-        output->SetChannels(synth->pcm.channels);
-        lastChannels = synth->pcm.channels;
-    }
-
-    // for IGNORE and CONTINUE, just play what we have now
-    saL = synth->pcm.samples[0][samplePtr];
-    saR = synth->pcm.samples[1][samplePtr];
-    samplePtr++;
+  switch ( mad_synth_frame_onens(synth, frame, nsCount++) ) {
+      case MAD_FLOW_BREAK:
+        #ifdef HAVE_AUDIO_LOGGER
+        audioLogger->printf_P(PSTR("msf1ns MAD_FLOW_BREAK\n"));
+        #endif
+      case MAD_FLOW_STOP:
+        return false; // Either way we're done
+      default:
+        break; // Do nothing
   }
+
+  // for IGNORE and CONTINUE, just play what we have now
   return true;
 }
 
-
-bool AudioGeneratorMP3::loop()
+// Decode and synthesize whole frames into the PCM ring as long as
+// there is room for one. A frame with a different rate or channel
+// count waits until the ring is drained. Returns false on decoder 
+// failure; sets inputEOF if the stream ended.
+bool AudioGeneratorMP3::FillRing()
 {
-  if (!running) goto done; // Nothing to do here!
+  while (!inputEOF) {
 
-  // First, try and push in the stored sample.  If we can't, then punt and try later
-  if (!output->ConsumeSample(sL, sR)) goto done; // Can't send, but no error detected
-
-  // Try and stuff the buffer one sample at a time
-  do
-  {
-    // Decode next frame if we're beyond the existing generated data
-    if ( (samplePtr >= synth->pcm.length) && (nsCount >= nsCountMax) ) {
+    if (!framePending) {
+      if (pcmFrames - (int)(pcmWr - pcmRd) < 1152) break;
 retry:
       if (Input() == MAD_FLOW_STOP) {
-        return false;
+        inputEOF = true;
+        break;
       }
 
       if (!DecodeNextFrame()) {
@@ -261,25 +251,97 @@ retry:
             #endif
             unrecoverable = 0;
             stop();
-            return running;
+            return false;
           }
         } else {
           unrecoverable = 0;
         }
         goto retry;
       }
-      samplePtr = 9999;
-      nsCount = 0;
+      framePending = true;
     }
 
-    if (!GetOneSample(sL, sR)) {
-      #ifdef HAVE_AUDIO_LOGGER
-      audioLogger->printf_P(PSTR("G1S failed\n"));
-      #endif
-      running = false;
-      goto done;
+    unsigned int rate = frame->header.samplerate;
+    int channels = mono ? 1 : MAD_NCHANNELS(&frame->header);
+    if (rate != pcmRate || channels != pcmChannels) {
+      if (pcmWr != pcmRd) break;
+      pcmRate = rate;
+      pcmChannels = channels;
+    }
+
+    for (nsCount = 0; nsCount < nsCountMax; ) {
+      if (!SynthNextSlot()) {
+        #ifdef HAVE_AUDIO_LOGGER
+        audioLogger->printf_P(PSTR("G1S failed\n"));
+        #endif
+        running = false;
+        return false;
+      }
+      const int16_t *l = synth->pcm.samples[0];
+      const int16_t *r = synth->pcm.samples[(synth->pcm.channels > 1) ? 1 : 0];
+      for (int i = 0; i < synth->pcm.length; i++) {
+        int16_t *d = &pcm[(pcmWr++ & (pcmFrames - 1)) * 2];
+        d[0] = *l++;
+        d[1] = *r++;
+      }
+    }
+    framePending = false;
+  }
+
+  return true;
+}
+
+// Hand out the next contiguous run of the PCM ring (zero-copy); the
+// output drains it in bulk. Only called once the previous block is 
+// consumed, so FillRing() can't overwrite it.
+bool AudioGeneratorMP3::FillBlock()
+{
+  if (!FillRing()) return false;
+
+  blkFrames = 0;
+
+  uint32_t avail = pcmWr - pcmRd;
+  if (!avail) return true;
+
+  if (pcmRate != lastRate) {
+      output->SetRate(pcmRate);
+      lastRate = pcmRate;
+  }
+  if (pcmChannels != lastChannels) {
+      output->SetChannels(pcmChannels);
+      lastChannels = pcmChannels;
+  }
+
+  uint32_t idx = pcmRd & (pcmFrames - 1);
+  uint32_t n = pcmFrames - idx;
+  if (n > avail) n = avail;
+
+  blkPtr = &pcm[idx * 2];
+  blkFrames = n;
+  pcmRd += n;
+
+  return true;
+}
+
+bool AudioGeneratorMP3::loop()
+{
+  if (!running) goto done; // Nothing to do here!
+
+  // Low-water mark of what is decoded ahead of the output
+  if (pcmWr && !inputEOF && !framePending) {
+    int n = GetBufferedFrames();
+    if (pcmMin < 0 || n < pcmMin) pcmMin = n;
+  }
+
+  // First, try and push out the pending block. If we can't, then punt
+  // and try later. Then decode and send blocks until the output is full.
+  while (FlushBlock()) {
+    if (!FillBlock()) goto done;
+    if (!blkFrames) {
+      if (inputEOF) return false;   // All played
+      break;
     }
-  } while (running && output->ConsumeSample(sL, sR));
+  }
 
 done:
   file->loop();
@@ -309,16 +371,20 @@ bool AudioGeneratorMP3::begin(AudioFileSource *source, AudioOutput *output)
 
   if (!output->begin()) return false;
 
-  // Where we are in generating one frame's data, set to invalid so we will run loop on first getsample()
-  samplePtr = 9999;
-  nsCount = 9999;
+  // Start with an empty PCM ring, no frame decoded yet
+  nsCount = 0;
+  pcmRd = pcmWr = 0;
+  pcmRate = 0;
+  pcmChannels = 0;
+  framePending = false;
   lastRate = 0;
   lastChannels = 0;
   //lastReadPos = 0;
   lastBuffLen = 0;
 
-  // loop starts by pushing out samples, clear them here
-  sL = sR = 0;
+  // loop starts by pushing out the pending block, clear it here
+  blkFrames = 0;
+  inputEOF = false;
 
   // Allocate all large memory chunks
   if (preallocateStreamSize + preallocateFrameSize + preallocateSynthSize) {
@@ -374,11 +440,32 @@ bool AudioGeneratorMP3::begin(AudioFileSource *source, AudioOutput *output)
     }
   }
 
+  // PCM ring is kept across files, not part of preallocation
+  if (!pcm) {
+    pcm = reinterpret_cast<int16_t *>(malloc(pcmFrames * 2 * sizeof(int16_t)));
+    if (!pcm) {
+      #ifdef HAVE_AUDIO_LOGGER
+      audioLogger->printf_P(PSTR("OOM error in MP3: PCM ring\n"));
+      #endif
+      if (!preallocateSpace) {
+        free(buff);
+        free(stream);
+        free(frame);
+        free(synth);
+      }
+      buff = NULL;
+      stream = NULL;
+      frame = NULL;
+      synth = NULL;
+      return false;
+    }
+  }
+
   mad_stream_init(stream);
   mad_frame_init(frame);
   mad_synth_init(synth);
   synth->pcm.length = 0;
-  mad_stream_options(stream, 0); // TODO - add options support
+  mad_stream_options(stream, mono ? MAD_OPTION_SINGLECHANNEL : 0);
   madInitted = true;
 
   running = true;
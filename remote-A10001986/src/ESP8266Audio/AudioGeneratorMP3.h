@@ -40,6 +40,25 @@ class AudioGeneratorMP3 : public AudioGenerator
     virtual bool isRunning() override;
     virtual void desync () override;
 
+    // Decode to one channel (L+R)/2; about halves IMDCT and synth work
+    void SetMono(bool m) { mono = m; }
+
+    // Decoded frames waiting for output, of GetBufferSize()
+    int GetBufferedFrames() { return (int)(pcmWr - pcmRd) + (int)blkFrames; }
+    int GetBufferSize() { return pcmFrames; }
+    // Fewest decoded frames waiting when loop() was called, since
+    // ResetBufferStats(); -1 if none yet. Not counted: Start, end of
+    // input, and a format change, where the ring runs empty.
+    int GetMinBufferedFrames() { return pcmMin; }
+    void ResetBufferStats() { pcmMin = -1; }
+
+    // Continue with this source when the current one is exhausted,
+    // without a gap. The generator takes over the source once it
+    // switches (NULL is then returned by GetNextSource()); until
+    // then, the caller owns it. stop() drops it without closing.
+    void SetNextSource(AudioFileSource *source) { nextFile = source; }
+    AudioFileSource *GetNextSource() { return nextFile; }
+
     static constexpr int preAllocSize () { return preAllocBuffSize() + preAllocStreamSize() + preAllocFrameSize() + preAllocSynthSize(); }
     static constexpr int preAllocBuffSize () { return ((buffLen + 7) & ~7); }
     static constexpr int preAllocStreamSize () { return ((sizeof(struct mad_stream) + 7) & ~7); }
@@ -58,25 +77,38 @@ class AudioGeneratorMP3 : public AudioGenerator
 
     static constexpr int buffLen = 0x600; // Slightly larger than largest MP3 frame
     unsigned char *buff;
+    AudioFileSource *nextFile = nullptr;
     int lastReadPos;
     int lastBuffLen;
     unsigned int lastRate;
     int lastChannels;
+    bool mono = false;
 
     // Decoding bits
     bool madInitted;
     struct mad_stream *stream;
     struct mad_frame *frame;
     struct mad_synth *synth;
-    int samplePtr;
     int nsCount;
     int nsCountMax;
 
+    // PCM ring (interleaved L/R), filled a whole frame at a time
+    static constexpr int pcmFrames = 2048;  // power of 2, > 1152
+    int16_t *pcm = nullptr;
+    uint32_t pcmRd, pcmWr;
+    unsigned int pcmRate;
+    int pcmChannels;
+    bool framePending;
+    int pcmMin = -1;
+
     // The internal helpers
     enum mad_flow ErrorToFlow();
     enum mad_flow Input();
     bool DecodeNextFrame();
-    bool GetOneSample(int16_t& sL, int16_t& sR);
+    bool SynthNextSlot();
+    bool FillRing();
+    bool FillBlock();
+    bool inputEOF;
 
   private:
     int unrecoverable = 0;
@@ -27,6 +27,10 @@
 #include "AudioLogger.h"
 #include "AudioOutputLocal.h"
 
+// TW: Number of stereo frames generators hand to the output at once
+// (Matches the I2S DMA buffer length)
+#define AUDIO_BLOCK_FRAMES 64
+
 class AudioOutput
 {
   public:
@@ -62,16 +66,17 @@ class AudioOutput
     #else
     virtual bool ConsumeSample(int16_t sL, int16_t sR) { (void)sL;(void)sR; return false; }
     #endif
-    /*
-    virtual uint16_t ConsumeSamples(int16_t *samples, uint16_t count)
+    // TW: Block interface. "samples" holds "frames" interleaved L/R pairs
+    // (also for mono, where R is ignored). Returns the number of frames
+    // consumed; less than "frames" means the output is full.
+    virtual size_t ConsumeSamples(const int16_t *samples, size_t frames)
     {
-      for (uint16_t i=0; i<count; i++) {
-        if (!ConsumeSample(samples)) return i;
-        samples += 2;
+      size_t i;
+      for (i = 0; i < frames; i++, samples += 2) {
+        if (!ConsumeSample(samples[0], samples[1])) break;
       }
-      return count;
+      return i;
     }
-    */
     virtual bool stop() { return false; }
     virtual void flush() { return; }
     virtual bool loop() { return true; }
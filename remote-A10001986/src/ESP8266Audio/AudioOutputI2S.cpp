@@ -329,6 +329,48 @@ size_t AudioOutputI2S::ConsumeSample(int16_t msL, int16_t msR)
     i2s_write((i2s_port_t)portNo, (const char*)&s32, sizeof(uint32_t), &i2s_bytes_written, 0);
     return i2s_bytes_written;
 }
+
+// Convert up to AUDIO_BLOCK_FRAMES frames and hand them to the
+// DMA in one go, instead of one i2s_write() per sample.
+size_t AudioOutputI2S::ConsumeSamples(const int16_t *samples, size_t frames)
+{
+    uint32_t s32[AUDIO_BLOCK_FRAMES];
+
+    if(!i2sOn)
+        return 0;
+
+    if(frames > AUDIO_BLOCK_FRAMES) frames = AUDIO_BLOCK_FRAMES;
+
+    for(size_t i = 0; i < frames; i++, samples += 2) {
+        int16_t msL = samples[0];
+        int16_t msR = samples[1];
+
+        if(channels == 1) msR = msL;
+        #ifndef AUTO_MONO
+        else {
+          #ifndef FORCE_MONO
+          if(this->mono) {
+            int32_t ttl = msL + msR;
+            msL = msR = ttl >> 1;
+          }
+          #else
+          msL >>= 1;
+          msR >>= 1;
+          msR = msL = msL + msR;
+          #endif // FORCE_MONO
+        }
+        #endif // AUTO_MONO
+
+        AmplifyL(msL);
+        s32[i] = ((uint32_t)AmplifyR(msR)) | (uint16_t)msL;
+    }
+
+    // With timeout 0, i2s_write() only copies what fits into the
+    // DMA buffers; it never splits a 32-bit frame.
+    size_t i2s_bytes_written;
+    i2s_write((i2s_port_t)portNo, (const char*)s32, frames * sizeof(uint32_t), &i2s_bytes_written, 0);
+    return i2s_bytes_written / sizeof(uint32_t);
+}
 #else
 bool AudioOutputI2S::ConsumeSample(int16_t sL, int16_t sR)
 {
@@ -42,6 +42,7 @@ class AudioOutputI2S : public AudioOutput
     virtual bool begin() override { return begin(true); }
     #ifdef TWESP32
     virtual size_t ConsumeSample(int16_t sL, int16_t sR) override;
+    virtual size_t ConsumeSamples(const int16_t *samples, size_t frames) override;
     #else
     virtual bool ConsumeSample(int16_t sL, int16_t sR) override;
     #endif
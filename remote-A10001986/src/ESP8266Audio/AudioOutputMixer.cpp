@@ -0,0 +1,452 @@
+/*
+  AudioOutputMixer
+  Fixed-point mixer of several generators into one output
+
+  Based on AudioOutputMixer
+  Copyright (C) 2018  Earle F. Philhower, III
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+  Adapted by Thomas Winischhofer, 2026
+*/
+
+#include <Arduino.h>
+#include "AudioOutputMixer.h"
+
+#define MIX_ONE  (1 << 14)    // Gain 1.0 in Q2.14
+#define MIX_RAMP 64           // Max gain change per frame (~6ms for 0->1 at 44.1kHz)
+#define MIX_CUTOFF 0.9f       // Resampler cutoff relative to lower Nyquist
+#define MIX_PHASESTEP (0x10000 / AUDIO_MIXER_PHASES)
+
+static int32_t MixGain(float f)
+{
+  // Keep sample * gain within 32 bits
+  if (f < 0.0f) f = 0.0f;
+  else if (f > 3.99f) f = 3.99f;
+  return (int32_t)(f * MIX_ONE);
+}
+
+// Stub: Forward everything to the mixer
+
+bool AudioOutputMixerStub::SetRate(int hz)
+{
+  hertz = hz;
+  return parent->InRate(id, hz);
+}
+
+bool AudioOutputMixerStub::SetBitsPerSample(int bits)
+{
+  bps = bits;
+  return (bits == 16);
+}
+
+bool AudioOutputMixerStub::SetChannels(int chan)
+{
+  channels = chan;
+  return parent->InChannels(id, chan);
+}
+
+#ifdef TWESP32
+bool AudioOutputMixerStub::SetGain(float f1, int mutechnls)
+{
+  (void)mutechnls;
+  parent->InGain(id, f1);
+  return true;
+}
+#else
+bool AudioOutputMixerStub::SetGain(float f)
+{
+  parent->InGain(id, f);
+  return true;
+}
+#endif
+
+void AudioOutputMixerStub::SetDuck(float f)
+{
+  parent->InDuck(id, f);
+}
+
+bool AudioOutputMixerStub::begin()
+{
+  return parent->InBegin(id);
+}
+
+#ifdef TWESP32
+size_t AudioOutputMixerStub::ConsumeSample(int16_t sL, int16_t sR)
+#else
+bool AudioOutputMixerStub::ConsumeSample(int16_t sL, int16_t sR)
+#endif
+{
+  int16_t s[2] = { sL, sR };
+  return parent->InConsume(id, s, 1);
+}
+
+size_t AudioOutputMixerStub::ConsumeSamples(const int16_t *samples, size_t frames)
+{
+  return parent->InConsume(id, samples, frames);
+}
+
+bool AudioOutputMixerStub::stop()
+{
+  return parent->InStop(id);
+}
+
+bool AudioOutputMixerStub::isRunning()
+{
+  return parent->voice[id].running;
+}
+
+// Mixer
+
+int16_t AudioOutputMixer::coef[AUDIO_MIXER_PHASES + 1][AUDIO_MIXER_TAPS];
+bool AudioOutputMixer::haveCoefs = false;
+
+// Windowed sinc (Blackman), sampled at distances from the output
+// position to the taps; each row normalized to unity DC gain.
+// cutoff: Relative to input Nyquist
+void AudioOutputMixer::MakeCoefs(int16_t *c, int taps, float cutoff)
+{
+  const float half = taps / 2;
+
+  for (int p = 0; p <= AUDIO_MIXER_PHASES; p++, c += taps) {
+    float h[AUDIO_MIXER_DTAPS], sum = 0.0f;
+    float frac = (float)p / AUDIO_MIXER_PHASES;
+    for (int k = 0; k < taps; k++) {
+      float d = (k - half + 1) - frac;
+      float x = cutoff * d * (float)M_PI;
+      float w = 0.42f + 0.5f * cosf((float)M_PI * d / half) + 0.08f * cosf(2.0f * (float)M_PI * d / half);
+      if (fabsf(d) >= half) w = 0.0f;
+      h[k] = ((x == 0.0f) ? 1.0f : sinf(x) / x) * w;
+      sum += h[k];
+    }
+    for (int k = 0; k < taps; k++) {
+      c[k] = (int16_t)lrintf(h[k] / sum * MIX_ONE);
+    }
+  }
+}
+
+AudioOutputMixer::AudioOutputMixer(int frames, AudioOutput *dest, int rate)
+{
+  sink = dest;
+  sinkOn = false;
+  accFrames = frames;
+  acc = reinterpret_cast<int32_t *>(calloc(accFrames * 2, sizeof(int32_t)));
+  rPtr = endPtr = 0;
+  numVoices = 0;
+  hertz = rate;
+  memset(voice, 0, sizeof(voice));
+  if (!haveCoefs) {
+    MakeCoefs(coef[0], AUDIO_MIXER_TAPS, MIX_CUTOFF);
+    haveCoefs = true;
+  }
+
+  // Gain is applied per input; the sink gets mixed stereo
+  sink->SetGain(1.0f);
+  sink->SetBitsPerSample(16);
+  sink->SetChannels(2);
+}
+
+AudioOutputMixer::~AudioOutputMixer()
+{
+  for (int i = 0; i < numVoices; i++) {
+    delete stubs[i];
+    free(voice[i].dtab);
+  }
+  free(acc);
+}
+
+AudioOutputMixerStub *AudioOutputMixer::NewInput()
+{
+  if (numVoices >= AUDIO_MIXER_VOICES) return nullptr;
+
+  Voice *v = &voice[numVoices];
+  v->gain = v->duck = v->cur = MIX_ONE;
+  v->channels = 2;
+  stubs[numVoices] = new AudioOutputMixerStub(this, numVoices);
+
+  return stubs[numVoices++];
+}
+
+bool AudioOutputMixer::OthersRunning(int id)
+{
+  for (int i = 0; i < numVoices; i++) {
+    if (i != id && voice[i].running) return true;
+  }
+  return false;
+}
+
+int AudioOutputMixer::GetRate()
+{
+  for (int i = 0; i < numVoices; i++) {
+    if (voice[i].running) return hertz;
+  }
+  return 0;
+}
+
+// Output rate is fixed; inputs at other rates are resampled
+bool AudioOutputMixer::InRate(int id, int hz)
+{
+  Voice *v = &voice[id];
+
+  if (hz <= 0) return false;
+  if (hz == hertz) {
+    v->step = 0;
+  } else {
+    v->step = ((uint64_t)hz << 16) / hertz;
+    v->stepRem = ((uint64_t)hz << 16) % hertz;
+    v->maxOut = (0x10000 + v->step - 1) / v->step + 1;
+    v->tab = coef[0];
+    v->taps = AUDIO_MIXER_TAPS;
+    // Downsampling: Cut off below the output's Nyquist frequency,
+    // not the input's, with a longer filter for a narrow transition
+    // band. Without memory for a table of its own, the shared one
+    // is used (content above output Nyquist aliases).
+    if (hz > hertz) {
+      if (!v->dtab) {
+        v->dtab = reinterpret_cast<int16_t *>(malloc((AUDIO_MIXER_PHASES + 1) * AUDIO_MIXER_DTAPS * sizeof(int16_t)));
+      }
+      if (v->dtab) {
+        if (v->dtabHz != hz) {
+          MakeCoefs(v->dtab, AUDIO_MIXER_DTAPS, MIX_CUTOFF * hertz / hz);
+          v->dtabHz = hz;
+        }
+        v->tab = v->dtab;
+        v->taps = AUDIO_MIXER_DTAPS;
+      }
+    }
+  }
+  return true;
+}
+
+bool AudioOutputMixer::InChannels(int id, int chan)
+{
+  if ((chan < 1) || (chan > 2)) return false;
+  voice[id].channels = chan;
+  return true;
+}
+
+void AudioOutputMixer::InGain(int id, float f)
+{
+  voice[id].gain = MixGain(f);
+}
+
+void AudioOutputMixer::InDuck(int id, float f)
+{
+  voice[id].duck = MixGain(f);
+}
+
+bool AudioOutputMixer::InBegin(int id)
+{
+  Voice *v = &voice[id];
+
+  if (!sinkOn) {
+    sink->SetRate(hertz);
+    if (!sink->begin()) return false;
+    sinkOn = true;
+  }
+
+  // Alone: Continue right after what is buffered (no gap, no overlap).
+  // Otherwise start at the output position, on top of the others.
+  if (!v->running) {
+    v->wPtr = OthersRunning(id) ? rPtr : endPtr;
+    v->cur = v->gain;
+    v->phase = 0;
+    memset(v->hist, 0, sizeof(v->hist));
+    v->running = true;
+  }
+
+  return true;
+}
+
+size_t AudioOutputMixer::InConsume(int id, const int16_t *samples, size_t frames)
+{
+  Voice *v = &voice[id];
+  int32_t target, cur;
+  uint32_t room;
+
+  if (!v->running) return 0;
+
+  room = accFrames - (v->wPtr - rPtr);
+
+  target = v->gain;
+  if (v->duck != MIX_ONE && OthersRunning(id)) {
+    target = (target * v->duck) >> 14;
+  }
+  cur = v->cur;
+
+  if (v->step) {
+    return InResample(v, samples, frames, room, target);
+  }
+
+  if (frames > room) frames = room;
+
+  for (size_t i = 0; i < frames; i++, samples += 2) {
+    if (cur != target) {
+      if (cur < target) cur = (target - cur > MIX_RAMP) ? cur + MIX_RAMP : target;
+      else              cur = (cur - target > MIX_RAMP) ? cur - MIX_RAMP : target;
+    }
+    int32_t l = samples[0];
+    int32_t r = (v->channels == 1) ? l : samples[1];
+    int32_t *a = &acc[((v->wPtr + i) & (accFrames - 1)) * 2];
+    a[0] += (l * cur) >> 14;
+    a[1] += (r * cur) >> 14;
+  }
+
+  v->cur = cur;
+  v->wPtr += frames;
+  if ((int32_t)(v->wPtr - endPtr) > 0) endPtr = v->wPtr;
+
+  // Keep history for a switch to resampling
+  {
+    size_t n = (frames < AUDIO_MIXER_DTAPS) ? frames : AUDIO_MIXER_DTAPS;
+    const int16_t *s = samples - n * 2;
+    int16_t *h = v->hist + (AUDIO_MIXER_DTAPS - n) * 2;
+    memmove(v->hist, v->hist + n * 2, (AUDIO_MIXER_DTAPS - n) * 2 * sizeof(int16_t));
+    for (size_t k = 0; k < n; k++, s += 2) {
+      h[k * 2] = s[0];
+      h[k * 2 + 1] = (v->channels == 1) ? s[0] : s[1];
+    }
+  }
+
+  return frames;
+}
+
+// Polyphase FIR: For each input frame, produce all output frames
+// that lie between the two middle frames of the last taps frames
+// of the history. All of it is shifted, so a switch to the longer
+// filter finds it complete.
+size_t AudioOutputMixer::InResample(Voice *v, const int16_t *samples, size_t frames, uint32_t room, int32_t target)
+{
+  const int taps = v->taps;
+  int16_t *h = v->hist + (AUDIO_MIXER_DTAPS - taps) * 2;
+  int32_t cur = v->cur;
+  uint32_t phase = v->phase;
+  uint32_t out = 0;
+  size_t i;
+
+  for (i = 0; i < frames && room - out >= v->maxOut; i++, samples += 2) {
+    memmove(v->hist, v->hist + 2, (AUDIO_MIXER_DTAPS - 1) * 2 * sizeof(int16_t));
+    v->hist[(AUDIO_MIXER_DTAPS - 1) * 2] = samples[0];
+    v->hist[(AUDIO_MIXER_DTAPS - 1) * 2 + 1] = (v->channels == 1) ? samples[0] : samples[1];
+
+    while (phase < 0x10000) {
+      // Interpolate between the two nearest phases
+      const int16_t *c0 = v->tab + (phase / MIX_PHASESTEP) * taps;
+      const int16_t *c1 = c0 + taps;
+      int32_t f = phase % MIX_PHASESTEP;
+      int32_t l = 0, r = 0;
+      for (int k = 0; k < taps; k++) {
+        int32_t c = c0[k] + (((c1[k] - c0[k]) * f) / MIX_PHASESTEP);
+        l += h[k * 2] * c;
+        r += h[k * 2 + 1] * c;
+      }
+      l >>= 14;
+      r >>= 14;
+      // Filter overshoot; keep sample * gain within 32 bits
+      if (l > 32767) l = 32767; else if (l < -32768) l = -32768;
+      if (r > 32767) r = 32767; else if (r < -32768) r = -32768;
+
+      if (cur != target) {
+        if (cur < target) cur = (target - cur > MIX_RAMP) ? cur + MIX_RAMP : target;
+        else              cur = (cur - target > MIX_RAMP) ? cur - MIX_RAMP : target;
+      }
+      int32_t *a = &acc[((v->wPtr + out) & (accFrames - 1)) * 2];
+      a[0] += (l * cur) >> 14;
+      a[1] += (r * cur) >> 14;
+      out++;
+      phase += v->step;
+      // Keep exact ratio
+      if ((v->rem += v->stepRem) >= (uint32_t)hertz) {
+        v->rem -= hertz;
+        phase++;
+      }
+    }
+    phase -= 0x10000;
+  }
+
+  v->cur = cur;
+  v->phase = phase;
+  v->wPtr += out;
+  if ((int32_t)(v->wPtr - endPtr) > 0) endPtr = v->wPtr;
+
+  return i;
+}
+
+bool AudioOutputMixer::InStop(int id)
+{
+  // Data already added stays in the buffer and is played out
+  voice[id].running = false;
+  return true;
+}
+
+size_t AudioOutputMixer::Pump()
+{
+  uint32_t lim = endPtr;
+  bool any = false;
+  size_t total = 0;
+
+  if (!sinkOn) return 0;
+
+  // Only send what all running inputs have delivered; once none is
+  // running, drain the rest.
+  for (int i = 0; i < numVoices; i++) {
+    Voice *v = &voice[i];
+    if (v->running) {
+      if (!any || (int32_t)(v->wPtr - lim) < 0) lim = v->wPtr;
+      any = true;
+    }
+  }
+
+  while (rPtr != lim) {
+    uint32_t idx = rPtr & (accFrames - 1);
+    uint32_t n = lim - rPtr;
+    if (n > accFrames - idx) n = accFrames - idx;
+    if (n > AUDIO_BLOCK_FRAMES) n = AUDIO_BLOCK_FRAMES;
+
+    int32_t *a = &acc[idx * 2];
+    for (uint32_t i = 0; i < n * 2; i++) {
+      int32_t s = a[i];
+      if (s > 32767) s = 32767;
+      else if (s < -32768) s = -32768;
+      outBlk[i] = (int16_t)s;
+    }
+
+    uint32_t m = sink->ConsumeSamples(outBlk, n);
+    memset(a, 0, m * 2 * sizeof(int32_t));
+    rPtr += m;
+    total += m;
+    if (m < n) break;
+  }
+
+  if (!any && rPtr == endPtr) {
+    sink->stop();
+    sinkOn = false;
+  }
+
+  return total;
+}
+
+bool AudioOutputMixer::stop()
+{
+  for (int i = 0; i < numVoices; i++) {
+    voice[i].running = false;
+  }
+  memset(acc, 0, accFrames * 2 * sizeof(int32_t));
+  rPtr = endPtr;
+  if (sinkOn) {
+    sink->stop();
+    sinkOn = false;
+  }
+  return true;
+}
@@ -0,0 +1,138 @@
+/*
+  AudioOutputMixer
+  Fixed-point mixer of several generators into one output
+
+  Based on AudioOutputMixer
+  Copyright (C) 2018  Earle F. Philhower, III
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+  Adapted by Thomas Winischhofer, 2026
+*/
+
+#pragma once
+
+#include "AudioOutput.h"
+
+// TW: Max number of inputs
+#define AUDIO_MIXER_VOICES 4
+
+// TW: Resampler filter: Taps per output sample, number of phases (power of 2)
+#define AUDIO_MIXER_TAPS   8
+#define AUDIO_MIXER_PHASES 64
+// TW: Taps when downsampling; the band between the output's Nyquist
+// frequency and the input's must be filtered out, not just rolled off
+#define AUDIO_MIXER_DTAPS  32
+
+class AudioOutputMixer;
+
+// Input of the mixer; hand this to a generator as its output
+class AudioOutputMixerStub : public AudioOutput
+{
+  public:
+    AudioOutputMixerStub(AudioOutputMixer *sink, int id) : parent(sink), id(id) { }
+    virtual bool SetRate(int hz) override;
+    virtual bool SetBitsPerSample(int bits) override;
+    virtual bool SetChannels(int chan) override;
+    #ifdef TWESP32
+    virtual bool SetGain(float f1, int mutechnls = 0) override;
+    #else
+    virtual bool SetGain(float f) override;
+    #endif
+    virtual bool begin() override;
+    #ifdef TWESP32
+    virtual size_t ConsumeSample(int16_t sL, int16_t sR) override;
+    #else
+    virtual bool ConsumeSample(int16_t sL, int16_t sR) override;
+    #endif
+    virtual size_t ConsumeSamples(const int16_t *samples, size_t frames) override;
+    virtual bool stop() override;
+
+    // Gain factor applied on top of the gain while any other input
+    // is running
+    void SetDuck(float f);
+    bool isRunning();
+
+  protected:
+    AudioOutputMixer *parent;
+    int id;
+};
+
+class AudioOutputMixer : public AudioOutput
+{
+  public:
+    // frames: Size of mixing buffer, power of 2
+    // rate: Output rate; inputs at other rates are resampled
+    AudioOutputMixer(int frames, AudioOutput *sink, int rate = 44100);
+    virtual ~AudioOutputMixer() override;
+    AudioOutputMixerStub *NewInput();
+    virtual bool loop() override { Pump(); return true; }
+    virtual bool stop() override;
+
+    // Send mixed frames to the sink; returns number of frames sent
+    size_t Pump();
+    // Output rate (0 if no input is running)
+    int GetRate();
+    // Sink is running (inputs running or buffer not yet drained)
+    bool isActive() { return sinkOn; }
+
+  protected:
+    friend class AudioOutputMixerStub;
+    bool InRate(int id, int hz);
+    bool InChannels(int id, int chan);
+    void InGain(int id, float f);
+    void InDuck(int id, float f);
+    bool InBegin(int id);
+    size_t InConsume(int id, const int16_t *samples, size_t frames);
+    bool InStop(int id);
+    bool OthersRunning(int id);
+    static void MakeCoefs(int16_t *c, int taps, float cutoff);
+
+    typedef struct {
+      bool running;
+      uint8_t channels;
+      int32_t gain;   // Q2.14
+      int32_t duck;   // Q2.14
+      int32_t cur;    // Q2.14, follows gain (and duck) in a ramp
+      uint32_t wPtr;  // Next frame to add to
+      uint32_t step;  // Input frames per output frame, Q16; 0 if same rate
+      uint32_t stepRem; // Remainder of step, in 1/hertz
+      uint32_t rem;
+      uint32_t maxOut;  // Max output frames per input frame
+      uint32_t phase;   // Output position after the middle of the last taps frames, Q16
+      int taps;         // Filter length in use
+      int16_t hist[AUDIO_MIXER_DTAPS * 2]; // Last input frames, L/R, newest last
+      const int16_t *tab;                  // Coefficients in use, taps per phase
+      int16_t *dtab;                       // Own coefficients for downsampling
+      int dtabHz;                          // Input rate dtab was made for
+    } Voice;
+
+    // Resampler coefficients, Q14, one row per phase (incl. 1.0);
+    // cutoff relative to input Nyquist, for upsampling
+    static int16_t coef[AUDIO_MIXER_PHASES + 1][AUDIO_MIXER_TAPS];
+    static bool haveCoefs;
+
+    size_t InResample(Voice *v, const int16_t *samples, size_t frames, uint32_t room, int32_t target);
+
+    AudioOutput *sink;
+    bool sinkOn;
+    int32_t *acc;     // Interleaved L/R
+    uint32_t accFrames;
+    uint32_t rPtr;    // Next frame to send
+    uint32_t endPtr;  // End of all data written
+    int numVoices;
+    Voice voice[AUDIO_MIXER_VOICES];
+    AudioOutputMixerStub *stubs[AUDIO_MIXER_VOICES];
+    int16_t outBlk[AUDIO_BLOCK_FRAMES * 2];
+};
@@ -46,7 +46,13 @@ extern int stackfree();
 /* Define if your MIPS CPU supports a 2-operand MADD16 instruction. */
 /* #undef HAVE_MADD16_ASM */
 
+/* ESP32: Use MULSH; ESP8266 (LX106) has no 32x32 high multiply.
+   Host builds may select FPM_XTENSA or FPM_64BIT on the command line. */
+#if defined(ESP32) && defined(__XTENSA__)
+#define FPM_XTENSA
+#elif !defined(FPM_XTENSA) && !defined(FPM_64BIT)
 #define FPM_DEFAULT
+#endif
 
 /* Define if your MIPS CPU supports a 2-operand MADD instruction. */
 #define HAVE_MADD_ASM 1
@@ -91,10 +97,22 @@ extern int stackfree();
 /* #undef OPT_ACCURACY */
 
 /* Define to optimize for speed over accuracy. */
+#ifndef OPT_ACCURACY
 #define OPT_SPEED 1
+#endif
 
 /* Define to enable a fast subband synthesis approximation optimization. */
+/* (Only needed with FPM_DEFAULT; FPM_XTENSA is about as fast without) */
+#ifdef FPM_DEFAULT
 #define OPT_SSO 1
+#endif
+
+/* Define to decode Layer III Huffman code words with single-lookup tables
+   (about 8KB of additional flash) instead of walking the code trees.
+   NO_OPT_HUFFWIDE builds the tree decoder (host/test_huffman.c). */
+#ifndef NO_OPT_HUFFWIDE
+#define OPT_HUFFWIDE 1
+#endif
 
 /* Define to influence a strict interpretation of the ISO/IEC standards, even
    if this is in opposition with best accepted practices. */
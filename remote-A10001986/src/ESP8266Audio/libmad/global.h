@@ -38,7 +38,8 @@
 #  error "cannot optimize for both speed and accuracy"
 # endif
 
-# if defined(OPT_SPEED) && !defined(OPT_SSO)
+/* FPM_XTENSA is about as fast without SSO (see config.h) */
+# if defined(OPT_SPEED) && !defined(OPT_SSO) && !defined(FPM_XTENSA)
 #  define OPT_SSO
 # endif
 
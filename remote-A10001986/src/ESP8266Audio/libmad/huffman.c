@@ -3074,6 +3074,23 @@ union huffpair const hufftab24[]  PROGMEM = {
 
 union huffquad const *const mad_huff_quad_table[2] PROGMEM = { hufftabA, hufftabB };
 
+# if defined(OPT_HUFFWIDE)
+#  include "huffwide.dat.h"
+
+unsigned char const *const mad_huff_quad_wide[2] PROGMEM = { hufftabAw, 0 };
+
+/* 0: not used */
+unsigned short const *const mad_huff_pair_wide[32] PROGMEM = {
+  hufftab0w,  hufftab1w,  hufftab2w,  hufftab3w,  0,          hufftab5w,
+  hufftab6w,  hufftab7w,  hufftab8w,  hufftab9w,  hufftab10w, hufftab11w,
+  hufftab12w, hufftab13w, 0,          hufftab15w,
+  hufftab16w, hufftab16w, hufftab16w, hufftab16w,
+  hufftab16w, hufftab16w, hufftab16w, hufftab16w,
+  hufftab24w, hufftab24w, hufftab24w, hufftab24w,
+  hufftab24w, hufftab24w, hufftab24w, hufftab24w
+};
+# endif
+
 struct hufftable const mad_huff_pair_table[32] PROGMEM = {
   /*  0 */ { hufftab0,   0, 0 },
   /*  1 */ { hufftab1,   0, 3 },
@@ -66,4 +66,9 @@ struct hufftable {
 extern union huffquad const *const mad_huff_quad_table[2];
 extern struct hufftable const mad_huff_pair_table[32];
 
+# if defined(OPT_HUFFWIDE)
+extern unsigned char const *const mad_huff_quad_wide[2];
+extern unsigned short const *const mad_huff_pair_wide[32];
+# endif
+
 # endif
@@ -0,0 +1,619 @@
+/*
+ * libmad - MPEG audio decoder library
+ * Copyright (C) 2000-2004 Underbit Technologies, Inc.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Single-lookup tables for the Layer III Huffman decoder (OPT_HUFFWIDE),
+ * generated from the tree tables in huffman.c.
+ *
+ * Pair tables are indexed by the next 8 bits of the bitstream. Entries
+ * with bit 15 set hold a complete code word: bits 8-11 are its length,
+ * bits 4-7 are x and bits 0-3 are y. Zero entries mark code words longer
+ * than 8 bits, which are decoded with the tree tables.
+ *
+ * The quad table (count1 table A) is indexed by the next 6 bits. Bits 4-6
+ * are the code word length, bits 0-3 are v, w, x and y.
+ */
+
+static
+unsigned short const hufftab0w[256] PROGMEM = {
+  0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000,
+  0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000,
+  0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000,
+  0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000,
+  0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000,
+  0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000,
+  0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000,
+  0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000,
+  0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000,
+  0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000,
+  0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000,
+  0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000,
+  0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000,
+  0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000,
+  0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000,
+  0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000,
+  0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000,
+  0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000,
+  0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000,
+  0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000,
+  0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000,
+  0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000,
+  0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000,
+  0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000,
+  0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000,
+  0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000,
+  0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000,
+  0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000,
+  0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000,
+  0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000,
+  0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000,
+  0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000
+};
+
+static
+unsigned short const hufftab1w[256] PROGMEM = {
+  0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311,
+  0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311,
+  0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311,
+  0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311,
+  0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301,
+  0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301,
+  0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301,
+  0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301,
+  0x8210, 0x8210, 0x8210, 0x8210, 0x8210, 0x8210, 0x8210, 0x8210,
+  0x8210, 0x8210, 0x8210, 0x8210, 0x8210, 0x8210, 0x8210, 0x8210,
+  0x8210, 0x8210, 0x8210, 0x8210, 0x8210, 0x8210, 0x8210, 0x8210,
+  0x8210, 0x8210, 0x8210, 0x8210, 0x8210, 0x8210, 0x8210, 0x8210,
+  0x8210, 0x8210, 0x8210, 0x8210, 0x8210, 0x8210, 0x8210, 0x8210,
+  0x8210, 0x8210, 0x8210, 0x8210, 0x8210, 0x8210, 0x8210, 0x8210,
+  0x8210, 0x8210, 0x8210, 0x8210, 0x8210, 0x8210, 0x8210, 0x8210,
+  0x8210, 0x8210, 0x8210, 0x8210, 0x8210, 0x8210, 0x8210, 0x8210,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100
+};
+
+static
+unsigned short const hufftab2w[256] PROGMEM = {
+  0x8622, 0x8622, 0x8622, 0x8622, 0x8602, 0x8602, 0x8602, 0x8602,
+  0x8512, 0x8512, 0x8512, 0x8512, 0x8512, 0x8512, 0x8512, 0x8512,
+  0x8521, 0x8521, 0x8521, 0x8521, 0x8521, 0x8521, 0x8521, 0x8521,
+  0x8520, 0x8520, 0x8520, 0x8520, 0x8520, 0x8520, 0x8520, 0x8520,
+  0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311,
+  0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311,
+  0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311,
+  0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311,
+  0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301,
+  0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301,
+  0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301,
+  0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301,
+  0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310,
+  0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310,
+  0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310,
+  0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100
+};
+
+static
+unsigned short const hufftab3w[256] PROGMEM = {
+  0x8622, 0x8622, 0x8622, 0x8622, 0x8602, 0x8602, 0x8602, 0x8602,
+  0x8512, 0x8512, 0x8512, 0x8512, 0x8512, 0x8512, 0x8512, 0x8512,
+  0x8521, 0x8521, 0x8521, 0x8521, 0x8521, 0x8521, 0x8521, 0x8521,
+  0x8520, 0x8520, 0x8520, 0x8520, 0x8520, 0x8520, 0x8520, 0x8520,
+  0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310,
+  0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310,
+  0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310,
+  0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310,
+  0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211,
+  0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211,
+  0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211,
+  0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211,
+  0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211,
+  0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211,
+  0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211,
+  0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211,
+  0x8201, 0x8201, 0x8201, 0x8201, 0x8201, 0x8201, 0x8201, 0x8201,
+  0x8201, 0x8201, 0x8201, 0x8201, 0x8201, 0x8201, 0x8201, 0x8201,
+  0x8201, 0x8201, 0x8201, 0x8201, 0x8201, 0x8201, 0x8201, 0x8201,
+  0x8201, 0x8201, 0x8201, 0x8201, 0x8201, 0x8201, 0x8201, 0x8201,
+  0x8201, 0x8201, 0x8201, 0x8201, 0x8201, 0x8201, 0x8201, 0x8201,
+  0x8201, 0x8201, 0x8201, 0x8201, 0x8201, 0x8201, 0x8201, 0x8201,
+  0x8201, 0x8201, 0x8201, 0x8201, 0x8201, 0x8201, 0x8201, 0x8201,
+  0x8201, 0x8201, 0x8201, 0x8201, 0x8201, 0x8201, 0x8201, 0x8201,
+  0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200,
+  0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200,
+  0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200,
+  0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200,
+  0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200,
+  0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200,
+  0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200,
+  0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200
+};
+
+static
+unsigned short const hufftab5w[256] PROGMEM = {
+  0x8833, 0x8823, 0x8732, 0x8732, 0x8631, 0x8631, 0x8631, 0x8631,
+  0x8713, 0x8713, 0x8703, 0x8703, 0x8730, 0x8730, 0x8722, 0x8722,
+  0x8612, 0x8612, 0x8612, 0x8612, 0x8621, 0x8621, 0x8621, 0x8621,
+  0x8602, 0x8602, 0x8602, 0x8602, 0x8620, 0x8620, 0x8620, 0x8620,
+  0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311,
+  0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311,
+  0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311,
+  0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311,
+  0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301,
+  0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301,
+  0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301,
+  0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301,
+  0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310,
+  0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310,
+  0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310,
+  0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100
+};
+
+static
+unsigned short const hufftab6w[256] PROGMEM = {
+  0x8733, 0x8733, 0x8703, 0x8703, 0x8623, 0x8623, 0x8623, 0x8623,
+  0x8632, 0x8632, 0x8632, 0x8632, 0x8630, 0x8630, 0x8630, 0x8630,
+  0x8513, 0x8513, 0x8513, 0x8513, 0x8513, 0x8513, 0x8513, 0x8513,
+  0x8531, 0x8531, 0x8531, 0x8531, 0x8531, 0x8531, 0x8531, 0x8531,
+  0x8522, 0x8522, 0x8522, 0x8522, 0x8522, 0x8522, 0x8522, 0x8522,
+  0x8502, 0x8502, 0x8502, 0x8502, 0x8502, 0x8502, 0x8502, 0x8502,
+  0x8412, 0x8412, 0x8412, 0x8412, 0x8412, 0x8412, 0x8412, 0x8412,
+  0x8412, 0x8412, 0x8412, 0x8412, 0x8412, 0x8412, 0x8412, 0x8412,
+  0x8421, 0x8421, 0x8421, 0x8421, 0x8421, 0x8421, 0x8421, 0x8421,
+  0x8421, 0x8421, 0x8421, 0x8421, 0x8421, 0x8421, 0x8421, 0x8421,
+  0x8420, 0x8420, 0x8420, 0x8420, 0x8420, 0x8420, 0x8420, 0x8420,
+  0x8420, 0x8420, 0x8420, 0x8420, 0x8420, 0x8420, 0x8420, 0x8420,
+  0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301,
+  0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301,
+  0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301,
+  0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301,
+  0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211,
+  0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211,
+  0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211,
+  0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211,
+  0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211,
+  0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211,
+  0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211,
+  0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211,
+  0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310,
+  0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310,
+  0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310,
+  0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310,
+  0x8300, 0x8300, 0x8300, 0x8300, 0x8300, 0x8300, 0x8300, 0x8300,
+  0x8300, 0x8300, 0x8300, 0x8300, 0x8300, 0x8300, 0x8300, 0x8300,
+  0x8300, 0x8300, 0x8300, 0x8300, 0x8300, 0x8300, 0x8300, 0x8300,
+  0x8300, 0x8300, 0x8300, 0x8300, 0x8300, 0x8300, 0x8300, 0x8300
+};
+
+static
+unsigned short const hufftab7w[256] PROGMEM = {
+  0x0000, 0x0000, 0x0000, 0x8815, 0x8851, 0x0000, 0x8850, 0x0000,
+  0x8824, 0x8842, 0x8714, 0x8714, 0x8741, 0x8741, 0x8740, 0x8740,
+  0x8804, 0x8823, 0x8832, 0x8803, 0x8713, 0x8713, 0x8731, 0x8731,
+  0x8730, 0x8730, 0x8722, 0x8722, 0x8612, 0x8612, 0x8612, 0x8612,
+  0x8521, 0x8521, 0x8521, 0x8521, 0x8521, 0x8521, 0x8521, 0x8521,
+  0x8602, 0x8602, 0x8602, 0x8602, 0x8620, 0x8620, 0x8620, 0x8620,
+  0x8411, 0x8411, 0x8411, 0x8411, 0x8411, 0x8411, 0x8411, 0x8411,
+  0x8411, 0x8411, 0x8411, 0x8411, 0x8411, 0x8411, 0x8411, 0x8411,
+  0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301,
+  0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301,
+  0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301,
+  0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301,
+  0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310,
+  0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310,
+  0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310,
+  0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100
+};
+
+static
+unsigned short const hufftab8w[256] PROGMEM = {
+  0x0000, 0x0000, 0x0000, 0x8815, 0x8851, 0x0000, 0x0000, 0x8824,
+  0x8842, 0x8814, 0x8741, 0x8741, 0x8804, 0x8840, 0x8823, 0x8832,
+  0x8813, 0x8831, 0x8803, 0x8830, 0x8622, 0x8622, 0x8622, 0x8622,
+  0x8602, 0x8602, 0x8602, 0x8602, 0x8620, 0x8620, 0x8620, 0x8620,
+  0x8412, 0x8412, 0x8412, 0x8412, 0x8412, 0x8412, 0x8412, 0x8412,
+  0x8412, 0x8412, 0x8412, 0x8412, 0x8412, 0x8412, 0x8412, 0x8412,
+  0x8421, 0x8421, 0x8421, 0x8421, 0x8421, 0x8421, 0x8421, 0x8421,
+  0x8421, 0x8421, 0x8421, 0x8421, 0x8421, 0x8421, 0x8421, 0x8421,
+  0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211,
+  0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211,
+  0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211,
+  0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211,
+  0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211,
+  0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211,
+  0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211,
+  0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211, 0x8211,
+  0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301,
+  0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301,
+  0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301,
+  0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301,
+  0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310,
+  0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310,
+  0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310,
+  0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310,
+  0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200,
+  0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200,
+  0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200,
+  0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200,
+  0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200,
+  0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200,
+  0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200,
+  0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200
+};
+
+static
+unsigned short const hufftab9w[256] PROGMEM = {
+  0x0000, 0x8835, 0x8853, 0x0000, 0x8844, 0x8825, 0x8852, 0x8815,
+  0x8751, 0x8751, 0x8734, 0x8734, 0x8743, 0x8743, 0x8850, 0x8804,
+  0x8724, 0x8724, 0x8742, 0x8742, 0x8733, 0x8733, 0x8740, 0x8740,
+  0x8614, 0x8614, 0x8614, 0x8614, 0x8641, 0x8641, 0x8641, 0x8641,
+  0x8623, 0x8623, 0x8623, 0x8623, 0x8632, 0x8632, 0x8632, 0x8632,
+  0x8513, 0x8513, 0x8513, 0x8513, 0x8513, 0x8513, 0x8513, 0x8513,
+  0x8531, 0x8531, 0x8531, 0x8531, 0x8531, 0x8531, 0x8531, 0x8531,
+  0x8603, 0x8603, 0x8603, 0x8603, 0x8630, 0x8630, 0x8630, 0x8630,
+  0x8522, 0x8522, 0x8522, 0x8522, 0x8522, 0x8522, 0x8522, 0x8522,
+  0x8502, 0x8502, 0x8502, 0x8502, 0x8502, 0x8502, 0x8502, 0x8502,
+  0x8412, 0x8412, 0x8412, 0x8412, 0x8412, 0x8412, 0x8412, 0x8412,
+  0x8412, 0x8412, 0x8412, 0x8412, 0x8412, 0x8412, 0x8412, 0x8412,
+  0x8421, 0x8421, 0x8421, 0x8421, 0x8421, 0x8421, 0x8421, 0x8421,
+  0x8421, 0x8421, 0x8421, 0x8421, 0x8421, 0x8421, 0x8421, 0x8421,
+  0x8420, 0x8420, 0x8420, 0x8420, 0x8420, 0x8420, 0x8420, 0x8420,
+  0x8420, 0x8420, 0x8420, 0x8420, 0x8420, 0x8420, 0x8420, 0x8420,
+  0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311,
+  0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311,
+  0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311,
+  0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311,
+  0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301,
+  0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301,
+  0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301,
+  0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301,
+  0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310,
+  0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310,
+  0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310,
+  0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310,
+  0x8300, 0x8300, 0x8300, 0x8300, 0x8300, 0x8300, 0x8300, 0x8300,
+  0x8300, 0x8300, 0x8300, 0x8300, 0x8300, 0x8300, 0x8300, 0x8300,
+  0x8300, 0x8300, 0x8300, 0x8300, 0x8300, 0x8300, 0x8300, 0x8300,
+  0x8300, 0x8300, 0x8300, 0x8300, 0x8300, 0x8300, 0x8300, 0x8300
+};
+
+static
+unsigned short const hufftab10w[256] PROGMEM = {
+  0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x8817,
+  0x8871, 0x0000, 0x0000, 0x0000, 0x8816, 0x8861, 0x8860, 0x0000,
+  0x0000, 0x0000, 0x8814, 0x8841, 0x8840, 0x8823, 0x8832, 0x8803,
+  0x8713, 0x8713, 0x8731, 0x8731, 0x8730, 0x8730, 0x8722, 0x8722,
+  0x8612, 0x8612, 0x8612, 0x8612, 0x8621, 0x8621, 0x8621, 0x8621,
+  0x8602, 0x8602, 0x8602, 0x8602, 0x8620, 0x8620, 0x8620, 0x8620,
+  0x8411, 0x8411, 0x8411, 0x8411, 0x8411, 0x8411, 0x8411, 0x8411,
+  0x8411, 0x8411, 0x8411, 0x8411, 0x8411, 0x8411, 0x8411, 0x8411,
+  0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301,
+  0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301,
+  0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301,
+  0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301,
+  0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310,
+  0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310,
+  0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310,
+  0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100
+};
+
+static
+unsigned short const hufftab11w[256] PROGMEM = {
+  0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x8827, 0x8872, 0x0000,
+  0x8771, 0x8771, 0x8817, 0x8870, 0x8836, 0x8863, 0x8860, 0x0000,
+  0x0000, 0x8815, 0x8762, 0x8762, 0x8826, 0x8806, 0x8716, 0x8716,
+  0x8761, 0x8761, 0x8851, 0x8834, 0x8850, 0x0000, 0x8824, 0x8842,
+  0x8814, 0x8841, 0x8804, 0x8840, 0x8723, 0x8723, 0x8732, 0x8732,
+  0x8613, 0x8613, 0x8613, 0x8613, 0x8631, 0x8631, 0x8631, 0x8631,
+  0x8703, 0x8703, 0x8730, 0x8730, 0x8622, 0x8622, 0x8622, 0x8622,
+  0x8521, 0x8521, 0x8521, 0x8521, 0x8521, 0x8521, 0x8521, 0x8521,
+  0x8412, 0x8412, 0x8412, 0x8412, 0x8412, 0x8412, 0x8412, 0x8412,
+  0x8412, 0x8412, 0x8412, 0x8412, 0x8412, 0x8412, 0x8412, 0x8412,
+  0x8502, 0x8502, 0x8502, 0x8502, 0x8502, 0x8502, 0x8502, 0x8502,
+  0x8520, 0x8520, 0x8520, 0x8520, 0x8520, 0x8520, 0x8520, 0x8520,
+  0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311,
+  0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311,
+  0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311,
+  0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311,
+  0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301,
+  0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301,
+  0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301,
+  0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301,
+  0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310,
+  0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310,
+  0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310,
+  0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310,
+  0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200,
+  0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200,
+  0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200,
+  0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200,
+  0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200,
+  0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200,
+  0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200,
+  0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200, 0x8200
+};
+
+static
+unsigned short const hufftab12w[256] PROGMEM = {
+  0x0000, 0x0000, 0x0000, 0x0000, 0x8856, 0x8837, 0x0000, 0x8827,
+  0x8872, 0x8846, 0x8864, 0x8817, 0x8871, 0x0000, 0x8836, 0x8863,
+  0x8845, 0x8854, 0x8844, 0x0000, 0x8726, 0x8726, 0x8762, 0x8762,
+  0x8761, 0x8761, 0x8816, 0x8860, 0x8835, 0x8853, 0x8825, 0x8852,
+  0x8715, 0x8715, 0x8751, 0x8751, 0x8734, 0x8734, 0x8743, 0x8743,
+  0x8850, 0x8804, 0x8724, 0x8724, 0x8742, 0x8742, 0x8714, 0x8714,
+  0x8633, 0x8633, 0x8633, 0x8633, 0x8641, 0x8641, 0x8641, 0x8641,
+  0x8623, 0x8623, 0x8623, 0x8623, 0x8632, 0x8632, 0x8632, 0x8632,
+  0x8740, 0x8740, 0x8703, 0x8703, 0x8630, 0x8630, 0x8630, 0x8630,
+  0x8513, 0x8513, 0x8513, 0x8513, 0x8513, 0x8513, 0x8513, 0x8513,
+  0x8531, 0x8531, 0x8531, 0x8531, 0x8531, 0x8531, 0x8531, 0x8531,
+  0x8522, 0x8522, 0x8522, 0x8522, 0x8522, 0x8522, 0x8522, 0x8522,
+  0x8412, 0x8412, 0x8412, 0x8412, 0x8412, 0x8412, 0x8412, 0x8412,
+  0x8412, 0x8412, 0x8412, 0x8412, 0x8412, 0x8412, 0x8412, 0x8412,
+  0x8421, 0x8421, 0x8421, 0x8421, 0x8421, 0x8421, 0x8421, 0x8421,
+  0x8421, 0x8421, 0x8421, 0x8421, 0x8421, 0x8421, 0x8421, 0x8421,
+  0x8502, 0x8502, 0x8502, 0x8502, 0x8502, 0x8502, 0x8502, 0x8502,
+  0x8520, 0x8520, 0x8520, 0x8520, 0x8520, 0x8520, 0x8520, 0x8520,
+  0x8400, 0x8400, 0x8400, 0x8400, 0x8400, 0x8400, 0x8400, 0x8400,
+  0x8400, 0x8400, 0x8400, 0x8400, 0x8400, 0x8400, 0x8400, 0x8400,
+  0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311,
+  0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311,
+  0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311,
+  0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311,
+  0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301,
+  0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301,
+  0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301,
+  0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301, 0x8301,
+  0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310,
+  0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310,
+  0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310,
+  0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310
+};
+
+static
+unsigned short const hufftab13w[256] PROGMEM = {
+  0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+  0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+  0x0000, 0x0000, 0x0000, 0x0000, 0x8881, 0x0000, 0x0000, 0x0000,
+  0x0000, 0x0000, 0x8815, 0x8851, 0x0000, 0x0000, 0x0000, 0x8814,
+  0x8741, 0x8741, 0x8804, 0x8840, 0x8823, 0x8832, 0x8713, 0x8713,
+  0x8731, 0x8731, 0x8703, 0x8703, 0x8730, 0x8730, 0x8722, 0x8722,
+  0x8612, 0x8612, 0x8612, 0x8612, 0x8621, 0x8621, 0x8621, 0x8621,
+  0x8602, 0x8602, 0x8602, 0x8602, 0x8620, 0x8620, 0x8620, 0x8620,
+  0x8411, 0x8411, 0x8411, 0x8411, 0x8411, 0x8411, 0x8411, 0x8411,
+  0x8411, 0x8411, 0x8411, 0x8411, 0x8411, 0x8411, 0x8411, 0x8411,
+  0x8401, 0x8401, 0x8401, 0x8401, 0x8401, 0x8401, 0x8401, 0x8401,
+  0x8401, 0x8401, 0x8401, 0x8401, 0x8401, 0x8401, 0x8401, 0x8401,
+  0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310,
+  0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310,
+  0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310,
+  0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100
+};
+
+static
+unsigned short const hufftab15w[256] PROGMEM = {
+  0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+  0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+  0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+  0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+  0x0000, 0x0000, 0x8891, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+  0x8828, 0x8882, 0x8818, 0x8881, 0x0000, 0x0000, 0x0000, 0x0000,
+  0x8827, 0x8872, 0x8864, 0x8817, 0x8855, 0x8871, 0x0000, 0x8836,
+  0x8863, 0x8845, 0x8854, 0x8826, 0x8862, 0x8816, 0x0000, 0x8835,
+  0x8761, 0x8761, 0x8853, 0x8844, 0x8725, 0x8725, 0x8752, 0x8752,
+  0x8715, 0x8715, 0x8751, 0x8751, 0x8805, 0x8850, 0x8734, 0x8734,
+  0x8743, 0x8743, 0x8724, 0x8724, 0x8742, 0x8742, 0x8733, 0x8733,
+  0x8641, 0x8641, 0x8641, 0x8641, 0x8714, 0x8714, 0x8704, 0x8704,
+  0x8623, 0x8623, 0x8623, 0x8623, 0x8632, 0x8632, 0x8632, 0x8632,
+  0x8740, 0x8740, 0x8703, 0x8703, 0x8613, 0x8613, 0x8613, 0x8613,
+  0x8631, 0x8631, 0x8631, 0x8631, 0x8630, 0x8630, 0x8630, 0x8630,
+  0x8522, 0x8522, 0x8522, 0x8522, 0x8522, 0x8522, 0x8522, 0x8522,
+  0x8512, 0x8512, 0x8512, 0x8512, 0x8512, 0x8512, 0x8512, 0x8512,
+  0x8521, 0x8521, 0x8521, 0x8521, 0x8521, 0x8521, 0x8521, 0x8521,
+  0x8502, 0x8502, 0x8502, 0x8502, 0x8502, 0x8502, 0x8502, 0x8502,
+  0x8520, 0x8520, 0x8520, 0x8520, 0x8520, 0x8520, 0x8520, 0x8520,
+  0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311,
+  0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311,
+  0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311,
+  0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311, 0x8311,
+  0x8401, 0x8401, 0x8401, 0x8401, 0x8401, 0x8401, 0x8401, 0x8401,
+  0x8401, 0x8401, 0x8401, 0x8401, 0x8401, 0x8401, 0x8401, 0x8401,
+  0x8410, 0x8410, 0x8410, 0x8410, 0x8410, 0x8410, 0x8410, 0x8410,
+  0x8410, 0x8410, 0x8410, 0x8410, 0x8410, 0x8410, 0x8410, 0x8410,
+  0x8300, 0x8300, 0x8300, 0x8300, 0x8300, 0x8300, 0x8300, 0x8300,
+  0x8300, 0x8300, 0x8300, 0x8300, 0x8300, 0x8300, 0x8300, 0x8300,
+  0x8300, 0x8300, 0x8300, 0x8300, 0x8300, 0x8300, 0x8300, 0x8300,
+  0x8300, 0x8300, 0x8300, 0x8300, 0x8300, 0x8300, 0x8300, 0x8300
+};
+
+static
+unsigned short const hufftab16w[256] PROGMEM = {
+  0x0000, 0x0000, 0x0000, 0x88ff, 0x0000, 0x0000, 0x0000, 0x88f2,
+  0x0000, 0x881f, 0x88f1, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+  0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+  0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x8851, 0x0000,
+  0x0000, 0x0000, 0x0000, 0x8814, 0x8841, 0x0000, 0x8823, 0x8832,
+  0x8713, 0x8713, 0x8731, 0x8731, 0x8803, 0x8830, 0x8722, 0x8722,
+  0x8612, 0x8612, 0x8612, 0x8612, 0x8621, 0x8621, 0x8621, 0x8621,
+  0x8602, 0x8602, 0x8602, 0x8602, 0x8620, 0x8620, 0x8620, 0x8620,
+  0x8411, 0x8411, 0x8411, 0x8411, 0x8411, 0x8411, 0x8411, 0x8411,
+  0x8411, 0x8411, 0x8411, 0x8411, 0x8411, 0x8411, 0x8411, 0x8411,
+  0x8401, 0x8401, 0x8401, 0x8401, 0x8401, 0x8401, 0x8401, 0x8401,
+  0x8401, 0x8401, 0x8401, 0x8401, 0x8401, 0x8401, 0x8401, 0x8401,
+  0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310,
+  0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310,
+  0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310,
+  0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310, 0x8310,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100,
+  0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100, 0x8100
+};
+
+static
+unsigned short const hufftab24w[256] PROGMEM = {
+  0x88ef, 0x88fe, 0x88df, 0x88fd, 0x88cf, 0x88fc, 0x88bf, 0x88fb,
+  0x87fa, 0x87fa, 0x88af, 0x889f, 0x87f9, 0x87f9, 0x87f8, 0x87f8,
+  0x888f, 0x887f, 0x87f7, 0x87f7, 0x876f, 0x876f, 0x87f6, 0x87f6,
+  0x875f, 0x875f, 0x87f5, 0x87f5, 0x874f, 0x874f, 0x87f4, 0x87f4,
+  0x873f, 0x873f, 0x87f3, 0x87f3, 0x872f, 0x872f, 0x87f2, 0x87f2,
+  0x87f1, 0x87f1, 0x881f, 0x88f0, 0x0000, 0x0000, 0x0000, 0x0000,
+  0x84ff, 0x84ff, 0x84ff, 0x84ff, 0x84ff, 0x84ff, 0x84ff, 0x84ff,
+  0x84ff, 0x84ff, 0x84ff, 0x84ff, 0x84ff, 0x84ff, 0x84ff, 0x84ff,
+  0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+  0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+  0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+  0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+  0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+  0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x8873, 0x0000, 0x8872,
+  0x8846, 0x8864, 0x8855, 0x8871, 0x8836, 0x8863, 0x8845, 0x8854,
+  0x8826, 0x8862, 0x8816, 0x8861, 0x0000, 0x8835, 0x8853, 0x8844,
+  0x8825, 0x8852, 0x8815, 0x0000, 0x8751, 0x8751, 0x8834, 0x8843,
+  0x8724, 0x8724, 0x8742, 0x8742, 0x8733, 0x8733, 0x8714, 0x8714,
+  0x8741, 0x8741, 0x8804, 0x8840, 0x8723, 0x8723, 0x8732, 0x8732,
+  0x8613, 0x8613, 0x8613, 0x8613, 0x8631, 0x8631, 0x8631, 0x8631,
+  0x8703, 0x8703, 0x8730, 0x8730, 0x8622, 0x8622, 0x8622, 0x8622,
+  0x8512, 0x8512, 0x8512, 0x8512, 0x8512, 0x8512, 0x8512, 0x8512,
+  0x8521, 0x8521, 0x8521, 0x8521, 0x8521, 0x8521, 0x8521, 0x8521,
+  0x8602, 0x8602, 0x8602, 0x8602, 0x8620, 0x8620, 0x8620, 0x8620,
+  0x8411, 0x8411, 0x8411, 0x8411, 0x8411, 0x8411, 0x8411, 0x8411,
+  0x8411, 0x8411, 0x8411, 0x8411, 0x8411, 0x8411, 0x8411, 0x8411,
+  0x8401, 0x8401, 0x8401, 0x8401, 0x8401, 0x8401, 0x8401, 0x8401,
+  0x8401, 0x8401, 0x8401, 0x8401, 0x8401, 0x8401, 0x8401, 0x8401,
+  0x8410, 0x8410, 0x8410, 0x8410, 0x8410, 0x8410, 0x8410, 0x8410,
+  0x8410, 0x8410, 0x8410, 0x8410, 0x8410, 0x8410, 0x8410, 0x8410,
+  0x8400, 0x8400, 0x8400, 0x8400, 0x8400, 0x8400, 0x8400, 0x8400,
+  0x8400, 0x8400, 0x8400, 0x8400, 0x8400, 0x8400, 0x8400, 0x8400
+};
+
+static
+unsigned char const hufftabAw[64] PROGMEM = {
+  0x6b, 0x6f, 0x6d, 0x6e, 0x67, 0x65, 0x59, 0x59,
+  0x56, 0x56, 0x53, 0x53, 0x5a, 0x5a, 0x5c, 0x5c,
+  0x42, 0x42, 0x42, 0x42, 0x41, 0x41, 0x41, 0x41,
+  0x44, 0x44, 0x44, 0x44, 0x48, 0x48, 0x48, 0x48,
+  0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+  0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+  0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+  0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10
+};
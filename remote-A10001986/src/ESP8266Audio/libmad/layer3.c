@@ -966,6 +966,31 @@ mad_fixed_t III_requantize(unsigned int value, signed int exp)
 # define MASK1BIT(cache, sz)  \
   ((cache) & (1 << ((sz) - 1)))
 
+# if defined(OPT_HUFFWIDE)
+/*
+ * NAME:	III_readbytes()
+ * DESCRIPTION:	read whole bytes from a byte-aligned bit pointer
+ */
+static inline
+unsigned long III_readbytes(struct mad_bitptr *ptr, unsigned int bits)
+{
+  unsigned char const *byte = ptr->byte;
+  unsigned long value = 0;
+
+  for (; bits; bits -= 8)
+    value = (value << 8) | *byte++;
+
+  ptr->byte = byte;
+
+  return value;
+}
+
+/* after the first read, all reads are whole bytes */
+#  define CACHE_READ(ptr, bits)  III_readbytes(ptr, bits)
+# else
+#  define CACHE_READ(ptr, bits)  mad_bit_read(ptr, bits)
+# endif
+
 /*
    NAME:	III_huffdecode()
    DESCRIPTION:	decode Huffman code words of one channel of one granule
@@ -1008,6 +1033,9 @@ enum mad_error III_huffdecode(struct mad_bitptr *ptr, mad_fixed_t xr[576],
     unsigned int region, rcount;
     struct hufftable const *entry;
     union huffpair const *table;
+# if defined(OPT_HUFFWIDE)
+    unsigned short const *wide;
+# endif
     unsigned int linbits, startbits, big_values, reqhits;
     mad_fixed_t reqcache[16];
 
@@ -1018,6 +1046,9 @@ enum mad_error III_huffdecode(struct mad_bitptr *ptr, mad_fixed_t xr[576],
     table     = entry->table;
     linbits   = entry->linbits;
     startbits = entry->startbits;
+# if defined(OPT_HUFFWIDE)
+    wide      = mad_huff_pair_wide[channel->table_select[0]];
+# endif
 
     if (table == 0)
       return MAD_ERROR_BADHUFFTABLE;
@@ -1030,7 +1061,7 @@ enum mad_error III_huffdecode(struct mad_bitptr *ptr, mad_fixed_t xr[576],
 
     while (big_values-- && cachesz + bits_left > 0) {
       union huffpair const *pair;
-      unsigned int clumpsz, value;
+      unsigned int clumpsz, value, hx, hy;
       register mad_fixed_t requantized;
 
       if (xrptr == sfbound) {
@@ -1048,6 +1079,9 @@ enum mad_error III_huffdecode(struct mad_bitptr *ptr, mad_fixed_t xr[576],
           table     = entry->table;
           linbits   = entry->linbits;
           startbits = entry->startbits;
+# if defined(OPT_HUFFWIDE)
+          wide      = mad_huff_pair_wide[channel->table_select[region]];
+# endif
 
           if (table == 0)
             return MAD_ERROR_BADHUFFTABLE;
@@ -1065,29 +1099,50 @@ enum mad_error III_huffdecode(struct mad_bitptr *ptr, mad_fixed_t xr[576],
         unsigned int bits;
 
         bits       = ((32 - 1 - 21) + (21 - cachesz)) & ~7;
-        bitcache   = (bitcache << bits) | mad_bit_read(&peek, bits);
+        bitcache   = (bitcache << bits) | CACHE_READ(&peek, bits);
         cachesz   += bits;
         bits_left -= bits;
       }
 
       /* hcod (0..19) */
 
-      clumpsz = startbits;
-      pair    = &table[MASK(bitcache, cachesz, clumpsz)];
+# if defined(OPT_HUFFWIDE)
+      {
+        unsigned int hw;
 
-      while (!pair->final) {
-        cachesz -= clumpsz;
+        /* code words up to 8 bits in one lookup */
+        hw = wide ? wide[MASK(bitcache, cachesz, 8)] : 0;
 
-        clumpsz = pair->ptr.bits;
-        pair    = &table[pair->ptr.offset + MASK(bitcache, cachesz, clumpsz)];
-      }
+        if (hw) {
+          cachesz -= (hw >> 8) & 0x0f;
+          hx = (hw >> 4) & 0x0f;
+          hy = hw & 0x0f;
+        }
+        else
+# endif
+        {
+          clumpsz = startbits;
+          pair    = &table[MASK(bitcache, cachesz, clumpsz)];
+
+          while (!pair->final) {
+            cachesz -= clumpsz;
 
-      cachesz -= pair->value.hlen;
+            clumpsz = pair->ptr.bits;
+            pair    = &table[pair->ptr.offset + MASK(bitcache, cachesz, clumpsz)];
+          }
+
+          cachesz -= pair->value.hlen;
+          hx = pair->value.x;
+          hy = pair->value.y;
+        }
+# if defined(OPT_HUFFWIDE)
+      }
+# endif
 
       if (linbits) {
         /* x (0..14) */
 
-        value = pair->value.x;
+        value = hx;
 
         switch (value) {
           case 0:
@@ -1096,7 +1151,7 @@ enum mad_error III_huffdecode(struct mad_bitptr *ptr, mad_fixed_t xr[576],
 
           case 15:
             if (cachesz < (int)(linbits + 2)) {
-              bitcache   = (bitcache << 16) | mad_bit_read(&peek, 16);
+              bitcache   = (bitcache << 16) | CACHE_READ(&peek, 16);
               cachesz   += 16;
               bits_left -= 16;
             }
@@ -1122,7 +1177,7 @@ x_final:
 
         /* y (0..14) */
 
-        value = pair->value.y;
+        value = hy;
 
         switch (value) {
           case 0:
@@ -1131,7 +1186,7 @@ x_final:
 
           case 15:
             if (cachesz < (int)(linbits + 1)) {
-              bitcache   = (bitcache << 16) | mad_bit_read(&peek, 16);
+              bitcache   = (bitcache << 16) | CACHE_READ(&peek, 16);
               cachesz   += 16;
               bits_left -= 16;
             }
@@ -1158,7 +1213,7 @@ y_final:
       else {
         /* x (0..1) */
 
-        value = pair->value.x;
+        value = hx;
 
         if (value == 0)
           xrptr[0] = 0;
@@ -1176,7 +1231,7 @@ y_final:
 
         /* y (0..1) */
 
-        value = pair->value.y;
+        value = hy;
 
         if (value == 0)
           xrptr[1] = 0;
@@ -1204,6 +1259,11 @@ y_final:
   {
     union huffquad const *table;
     register mad_fixed_t requantized;
+# if defined(OPT_HUFFWIDE)
+    unsigned char const *wide;
+
+    wide  = mad_huff_quad_wide[channel->flags & count1table_select];
+# endif
 
     table = mad_huff_quad_table[channel->flags & count1table_select];
 
@@ -1211,26 +1271,45 @@ y_final:
 
     while (cachesz + bits_left > 0 && xrptr <= &xr[572]) {
       union huffquad const *quad;
+      unsigned int qv, qw, qx, qy;
 
       /* hcod (1..6) */
 
       if (cachesz < 10) {
-        bitcache   = (bitcache << 16) | mad_bit_read(&peek, 16);
+        bitcache   = (bitcache << 16) | CACHE_READ(&peek, 16);
         cachesz   += 16;
         bits_left -= 16;
       }
 
-      quad = &table[MASK(bitcache, cachesz, 4)];
-
-      /* quad tables guaranteed to have at most one extra lookup */
-      if (!quad->final) {
-        cachesz -= 4;
+# if defined(OPT_HUFFWIDE)
+      if (wide) {
+        unsigned int hw = wide[MASK(bitcache, cachesz, 6)];
 
-        quad = &table[quad->ptr.offset +
-                      MASK(bitcache, cachesz, quad->ptr.bits)];
+        cachesz -= hw >> 4;
+        qv = (hw >> 3) & 1;
+        qw = (hw >> 2) & 1;
+        qx = (hw >> 1) & 1;
+        qy = hw & 1;
       }
+      else
+# endif
+      {
+        quad = &table[MASK(bitcache, cachesz, 4)];
+
+        /* quad tables guaranteed to have at most one extra lookup */
+        if (!quad->final) {
+          cachesz -= 4;
 
-      cachesz -= quad->value.hlen;
+          quad = &table[quad->ptr.offset +
+                        MASK(bitcache, cachesz, quad->ptr.bits)];
+        }
+
+        cachesz -= quad->value.hlen;
+        qv = quad->value.v;
+        qw = quad->value.w;
+        qx = quad->value.x;
+        qy = quad->value.y;
+      }
 
       if (xrptr == sfbound) {
         sfbound += *sfbwidth++;
@@ -1245,12 +1324,12 @@ y_final:
 
       /* v (0..1) */
 
-      xrptr[0] = quad->value.v ?
+      xrptr[0] = qv ?
                  (MASK1BIT(bitcache, cachesz--) ? -requantized : requantized) : 0;
 
       /* w (0..1) */
 
-      xrptr[1] = quad->value.w ?
+      xrptr[1] = qw ?
                  (MASK1BIT(bitcache, cachesz--) ? -requantized : requantized) : 0;
 
       xrptr += 2;
@@ -1268,12 +1347,12 @@ y_final:
 
       /* x (0..1) */
 
-      xrptr[0] = quad->value.x ?
+      xrptr[0] = qx ?
                  (MASK1BIT(bitcache, cachesz--) ? -requantized : requantized) : 0;
 
       /* y (0..1) */
 
-      xrptr[1] = quad->value.y ?
+      xrptr[1] = qy ?
                  (MASK1BIT(bitcache, cachesz--) ? -requantized : requantized) : 0;
 
       xrptr += 2;
@@ -1314,6 +1393,7 @@ y_final:
 
 # undef MASK
 # undef MASK1BIT
+# undef CACHE_READ
 
 /*
    NAME:	III_reorder()
@@ -2423,6 +2503,7 @@ enum mad_error III_decode(struct mad_bitptr *ptr, struct mad_frame *frame,
 {
   struct mad_header *header = &frame->header;
   mad_fixed_t *xr[2]; // Moved from stack to dynheap
+  int single;
 //  mad_fixed_t *xr_raw; // [2][576]
   unsigned int sfreqi, ngr, gr;
 //  xr_raw = (mad_fixed_t*)malloc(sizeof(mad_fixed_t) * 2 * 576);
@@ -2448,6 +2529,9 @@ enum mad_error III_decode(struct mad_bitptr *ptr, struct mad_frame *frame,
       sfreqi += 3;
   }
 
+  single = (nch == 2 &&
+            (frame->options & MAD_OPTION_SINGLECHANNEL) == MAD_OPTION_SINGLECHANNEL);
+
   /* scalefactors, Huffman decoding, requantization */
 
   ngr = (header->flags & MAD_FLAG_LSF_EXT) ? 1 : 2;
@@ -2455,7 +2539,8 @@ enum mad_error III_decode(struct mad_bitptr *ptr, struct mad_frame *frame,
   for (gr = 0; gr < ngr; ++gr) {
     struct granule *granule = &si->gr[gr];
     unsigned int const *sfbwidth[2];
-    unsigned int ch;
+    unsigned int ch, nout = nch;
+    int mixsb = 0;
     enum mad_error error;
 
     for (ch = 0; ch < nch; ++ch) {
@@ -2496,9 +2581,35 @@ enum mad_error III_decode(struct mad_bitptr *ptr, struct mad_frame *frame,
       }
     }
 
+    /* downmix (MAD_OPTION_SINGLECHANNEL) */
+
+    if (single) {
+      struct channel const *c0 = &granule->ch[0];
+      struct channel const *c1 = &granule->ch[1];
+      unsigned int i;
+
+      if (c0->block_type == c1->block_type &&
+          !((c0->flags ^ c1->flags) & mixed_block_flag)) {
+        /* same block layout: mix spectra, transform one channel */
+        for (i = 0; i < 576; ++i)
+          xr[0][i] = (xr[0][i] >> 1) + (xr[1][i] >> 1);
+        nout = 1;
+      }
+      else {
+        /* different block layout: transform both, mix subband samples;
+           overlap[1] is scratch, overlap[0] holds the mix */
+        for (i = 0; i < 576; ++i) {
+          xr[0][i] >>= 1;
+          xr[1][i] >>= 1;
+        }
+        memset(frame->overlap[1], 0, sizeof(frame->overlap[1]));
+        mixsb = 1;
+      }
+    }
+
     /* reordering, alias reduction, IMDCT, overlap-add, frequency inversion */
 
-    for (ch = 0; ch < nch; ++ch) {
+    for (ch = 0; ch < nout; ++ch) {
       struct channel const *channel = &granule->ch[ch];
       mad_fixed_t (*sample)[32] = &frame->sbsample[ch][18 * gr];
       unsigned int sb, l, i, sblimit;
@@ -2591,6 +2702,21 @@ enum mad_error III_decode(struct mad_bitptr *ptr, struct mad_frame *frame,
           III_freqinver(sample, sb);
       }
     }
+
+    if (mixsb) {
+      mad_fixed_t (*s0)[32] = &frame->sbsample[0][18 * gr];
+      mad_fixed_t (*s1)[32] = &frame->sbsample[1][18 * gr];
+      unsigned int sb, i;
+
+      for (i = 0; i < 18; ++i) {
+        for (sb = 0; sb < 32; ++sb)
+          s0[i][sb] += s1[i][sb];
+      }
+      for (sb = 0; sb < 32; ++sb) {
+        for (i = 0; i < 18; ++i)
+          frame->overlap[0][sb][i] += frame->overlap[1][sb][i];
+      }
+    }
   }
 
 //  free(xr_raw);
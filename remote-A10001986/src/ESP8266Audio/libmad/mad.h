@@ -462,6 +462,38 @@ mad_fixed_t mad_f_mul_inline(mad_fixed_t x, mad_fixed_t y)
 
 #  define MAD_F_SCALEBITS  MAD_F_FRACBITS
 
+/* --- Xtensa (ESP32) ------------------------------------------------------ */
+
+# elif defined(FPM_XTENSA)
+
+/*
+ * The ESP32's Xtensa core has MULL and MULSH (low and signed high word of
+ * a 32x32 multiply), but no 64-bit accumulator. With OPT_SPEED only the
+ * high word is computed and accumulated, so a multiply(-accumulate) is a
+ * single MULSH (plus ADD), and the low 4 bits of each product are lost
+ * (error < 2^-24). Otherwise the result is that of FPM_64BIT.
+ *
+ * On other CPUs MULSH is emulated in C, with identical results.
+ */
+#  if defined(__XTENSA__)
+#   define mad_f_mulsh(x, y)      ({ mad_fixed64hi_t __r;         asm ("mulsh	%0,%1,%2"  	    : "=a" (__r)  	    : "%a" (x), "a" (y));         __r;      })
+#  else
+#   define mad_f_mulsh(x, y)      ((mad_fixed64hi_t) (((mad_fixed64_t) (x) * (y)) >> 32))
+#  endif
+
+#  define MAD_F_MLX(hi, lo, x, y)      ((hi) = mad_f_mulsh((x), (y)),       (lo) = (mad_fixed64lo_t) (x) * (mad_fixed64lo_t) (y))
+
+#  if defined(OPT_SPEED)
+#   define MAD_F_ML0(hi, lo, x, y)	((hi)  = mad_f_mulsh((x), (y)))
+#   define MAD_F_MLA(hi, lo, x, y)	((hi) += mad_f_mulsh((x), (y)))
+#   define MAD_F_MLN(hi, lo)		((hi)  = -(hi))
+#   define MAD_F_MLZ(hi, lo)		mad_f_scale64((hi), 0)
+#   define mad_f_scale64(hi, lo)      ((mad_fixed_t) ((hi) << (32 - MAD_F_SCALEBITS)))
+#   define mad_f_mul(x, y)      mad_f_scale64(mad_f_mulsh((x), (y)), 0)
+#  endif
+
+#  define MAD_F_SCALEBITS  MAD_F_FRACBITS
+
 /* --- Default ------------------------------------------------------------- */
 
 # elif defined(FPM_DEFAULT)
@@ -716,12 +748,12 @@ struct mad_stream {
 
 enum {
   MAD_OPTION_IGNORECRC      = 0x0001,	/* ignore CRC errors */
-  MAD_OPTION_HALFSAMPLERATE = 0x0002	/* generate PCM at 1/2 sample rate */
+  MAD_OPTION_HALFSAMPLERATE = 0x0002,	/* generate PCM at 1/2 sample rate */
 # if 0  /* not yet implemented */
   MAD_OPTION_LEFTCHANNEL    = 0x0010,	/* decode left channel only */
   MAD_OPTION_RIGHTCHANNEL   = 0x0020,	/* decode right channel only */
-  MAD_OPTION_SINGLECHANNEL  = 0x0030	/* combine channels */
 # endif
+  MAD_OPTION_SINGLECHANNEL  = 0x0030	/* combine channels */
 };
 
 void mad_stream_init(struct mad_stream *);
@@ -553,7 +553,9 @@ void dct32(mad_fixed_t const in[32], unsigned int slot,
 #  define MLN(hi, lo)		MAD_F_MLN((hi), (lo))
 #  define MLZ(hi, lo)		MAD_F_MLZ((hi), (lo))
 #  define SHIFT(x)		(x)
-#  if defined(MAD_F_SCALEBITS)
+/* (FPM_XTENSA with OPT_SPEED accumulates the high word only; D[] must not
+   lose precision there) */
+#  if defined(MAD_F_SCALEBITS) && !(defined(FPM_XTENSA) && defined(OPT_SPEED))
 #   undef  MAD_F_SCALEBITS
 #   define MAD_F_SCALEBITS	(MAD_F_FRACBITS - 12)
 #   define PRESHIFT(x)		(MAD_F(x) >> 12)
@@ -877,6 +879,8 @@ enum mad_flow mad_synth_frame(struct mad_synth *synth, struct mad_frame const *f
   enum mad_flow (*synth_frame)(struct mad_synth *, struct mad_frame const *, unsigned int, unsigned int, unsigned int, enum mad_flow (*output_func)(), void *);
 
   nch = MAD_NCHANNELS(&frame->header);
+  if ((frame->options & MAD_OPTION_SINGLECHANNEL) == MAD_OPTION_SINGLECHANNEL)
+    nch = 1;	/* downmixed by decoder */
   ns  = MAD_NSBSAMPLES(&frame->header);
 
   synth->pcm.samplerate = frame->header.samplerate;
@@ -907,6 +911,8 @@ enum mad_flow mad_synth_frame_onens(struct mad_synth *synth, struct mad_frame co
   enum mad_flow (*synth_frame)(struct mad_synth *, struct mad_frame const *, unsigned int, unsigned int, unsigned int, enum mad_flow (*output_func)(), void *);
 
   nch = MAD_NCHANNELS(&frame->header);
+  if ((frame->options & MAD_OPTION_SINGLECHANNEL) == MAD_OPTION_SINGLECHANNEL)
+    nch = 1;	/* downmixed by decoder */
 //  ns  = MAD_NSBSAMPLES(&frame->header);
 
   synth->pcm.samplerate = frame->header.samplerate;
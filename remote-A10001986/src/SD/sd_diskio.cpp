@@ -63,6 +63,10 @@ typedef struct {
     unsigned long sectors;
     bool supports_crc;
     int status;
+    #ifdef TW_SD_STREAM
+    bool streaming;                 // CMD18 open, card selected
+    unsigned long long nextSector;  // Sector the open CMD18 delivers next
+    #endif
 } ardu_sdcard_t;
 
 static ardu_sdcard_t* s_cards[FF_VOLUMES] = { NULL };
@@ -433,6 +437,89 @@ bool sdWriteSectors(uint8_t pdrv, const char* buffer, unsigned long long sector,
     return false;
 }
 
+#ifdef TW_SD_STREAM
+// TW: End an open multi-block read and deselect the card. Must be
+// called before any other access to the card.
+void sdStreamStop(uint8_t pdrv)
+{
+    ardu_sdcard_t * card = s_cards[pdrv];
+
+    if (card->streaming) {
+        card->streaming = false;
+        if (sdCommand(pdrv, STOP_TRANSMISSION, 0, NULL)) {
+            #ifdef TW_SD_DEBUG
+            log_e("stream stop failed");
+            #endif
+        }
+        sdDeselectCard(pdrv);
+    }
+}
+
+// TW: Read sectors through a multi-block read which is left open
+// (card selected) on return. If the next read starts at the sector
+// following this one, it just continues reading data blocks; no
+// command, no access latency. Otherwise the open read is stopped and
+// a new one started.
+bool sdStreamRead(uint8_t pdrv, char* buffer, unsigned long long sector, int count)
+{
+    ardu_sdcard_t * card = s_cards[pdrv];
+
+    for (int f = 0; f < 3; f++) {
+        if (!card->streaming || card->nextSector != sector) {
+            sdStreamStop(pdrv);
+            if (!sdSelectCard(pdrv)) {
+                return false;
+            }
+            if (sdCommand(pdrv, READ_BLOCK_MULTIPLE, (card->type == CARD_SDHC) ? sector : sector << 9, NULL)) {
+                sdDeselectCard(pdrv);
+                return false;
+            }
+            card->streaming = true;
+            card->nextSector = sector;
+        }
+
+        do {
+            if (!sdReadBytes(pdrv, buffer, 512)) {
+                break;
+            }
+            buffer += 512;
+            card->nextSector = ++sector;
+        } while (--count);
+
+        if (!count) {
+            return true;
+        }
+
+        // Start over at the failed sector
+        sdStreamStop(pdrv);
+    }
+    return false;
+}
+#endif
+
+// TW: Switch the card to High Speed mode (up to 50MHz) using CMD6.
+// Cards before SD 1.10 reject the command; cards without High Speed
+// mode report a different function as selected.
+bool sdHighSpeed(uint8_t pdrv)
+{
+    char status[64];
+    bool success;
+
+    if (!sdSelectCard(pdrv)) {
+        return false;
+    }
+    // Mode 1 (switch), group 1 (access mode) = 1, other groups unchanged
+    if (sdCommand(pdrv, SEND_SWITCH_FUNC, 0x80FFFFF1, NULL)) {
+        sdDeselectCard(pdrv);
+        return false;
+    }
+    success = sdReadBytes(pdrv, status, 64);
+    sdDeselectCard(pdrv);
+
+    // Bits 379:376 of status: Function selected in group 1
+    return (success && (status[16] & 0x0F) == 1);
+}
+
 unsigned long sdGetSectorsCount(uint8_t pdrv)
 {
     for (int f = 0; f < 3; f++) {
@@ -543,6 +630,10 @@ DSTATUS ff_sd_initialize(uint8_t pdrv)
     // Low frequency is required during initialization for reliable communication
     AcquireSPI card_locked(card, 400000);
 
+    #ifdef TW_SD_STREAM
+    card->streaming = false;
+    #endif
+
     // Step 1: Power-up sequence - Send at least 74 clock cycles with CS high and MOSI high
     // This is required by the SD card specification to ensure proper card state reset
     // We send 20 bytes (160 clock cycles) to exceed the minimum requirement
@@ -711,8 +802,16 @@ DSTATUS ff_sd_initialize(uint8_t pdrv)
     card->sectors = sdGetSectorsCount(pdrv);
 
     // Limit frequency to 25MHz for compatibility (SD spec maximum for non-UHS cards)
+    // TW: Unless the card can be switched to High Speed mode (50MHz max)
     if (card->frequency > 25000000) {
-        card->frequency = 25000000;
+        if (card->type == CARD_MMC || !sdHighSpeed(pdrv)) {
+            #ifdef TW_SD_DEBUG
+            Serial.println("High Speed mode not supported");
+            #endif
+            card->frequency = 25000000;
+        } else if (card->frequency > 50000000) {
+            card->frequency = 50000000;
+        }
     }
 
     // Mark card as initialized
@@ -730,6 +829,14 @@ DSTATUS ff_sd_status(uint8_t pdrv)
     ardu_sdcard_t * card = s_cards[pdrv];
     AcquireSPI lock(card);
 
+    #ifdef TW_SD_STREAM
+    // TW: FatFs asks before every f_read/f_lseek; a card in the middle
+    // of a read is obviously there. Don't end the read for this.
+    if (card->streaming) {
+        return card->status;
+    }
+    #endif
+
     if(sdTransaction(pdrv, SEND_STATUS, 0, NULL))
     {
         log_e("Check status failed");
@@ -748,6 +855,14 @@ DRESULT ff_sd_read(uint8_t pdrv, uint8_t* buffer, DWORD sector, UINT count)
 
     AcquireSPI lock(card);
 
+    #ifdef TW_SD_STREAM
+    // The card reads ahead; don't leave a read open at the last sector
+    if (sector + count < card->sectors) {
+        return sdStreamRead(pdrv, (char*)buffer, sector, count) ? RES_OK : RES_ERROR;
+    }
+    sdStreamStop(pdrv);
+    #endif
+
     if (count > 1) {
         res = sdReadSectors(pdrv, (char*)buffer, sector, count) ? RES_OK : RES_ERROR;
     } else {
@@ -770,6 +885,10 @@ DRESULT ff_sd_write(uint8_t pdrv, const uint8_t* buffer, DWORD sector, UINT coun
 
     AcquireSPI lock(card);
 
+    #ifdef TW_SD_STREAM
+    sdStreamStop(pdrv);
+    #endif
+
     if (count > 1) {
         res = sdWriteSectors(pdrv, (const char*)buffer, sector, count) ? RES_OK : RES_ERROR;
     } else {
@@ -784,6 +903,9 @@ DRESULT ff_sd_ioctl(uint8_t pdrv, uint8_t cmd, void* buff)
     case CTRL_SYNC:
         {
             AcquireSPI lock(s_cards[pdrv]);
+            #ifdef TW_SD_STREAM
+            sdStreamStop(pdrv);
+            #endif
             if (sdSelectCard(pdrv)) {
                 sdDeselectCard(pdrv);
                 return RES_OK;
@@ -824,6 +946,9 @@ uint8_t sdcard_uninit(uint8_t pdrv)
         return 1;
     }
     AcquireSPI lock(card);
+    #ifdef TW_SD_STREAM
+    sdStreamStop(pdrv);
+    #endif
     sdTransaction(pdrv, GO_IDLE_STATE, 0, NULL);
     ff_diskio_register(pdrv, NULL);
     s_cards[pdrv] = NULL;
@@ -857,6 +982,9 @@ uint8_t sdcard_init(uint8_t cs, SPIClass * spi, int hz)
     card->supports_crc = true;
     card->type = CARD_NONE;
     card->status = STA_NOINIT;
+    #ifdef TW_SD_STREAM
+    card->streaming = false;
+    #endif
 
     pinMode(card->ssPin, OUTPUT);
     digitalWrite(card->ssPin, HIGH);
@@ -881,6 +1009,12 @@ uint8_t sdcard_unmount(uint8_t pdrv)
     if (pdrv >= FF_VOLUMES || card == NULL) {
         return 1;
     }
+    #ifdef TW_SD_STREAM
+    {
+        AcquireSPI lock(card);
+        sdStreamStop(pdrv);
+    }
+    #endif
     card->status |= STA_NOINIT;
     card->type = CARD_NONE;
 
@@ -940,6 +1074,9 @@ bool sdcard_mount(uint8_t pdrv, const char* path, uint8_t max_files, bool format
         }
     }
     AcquireSPI lock(card);
+    #ifdef TW_SD_STREAM
+    sdStreamStop(pdrv);
+    #endif
     card->sectors = sdGetSectorsCount(pdrv);
     return true;
 }
@@ -5,5 +5,8 @@
 #ifdef REMOTE_DBG
 #define TW_SD_DEBUG
 #endif
+#ifdef REMOTE_SD_STREAM
+#define TW_SD_STREAM
+#endif
 
 #endif
\ No newline at end of file